@@ -0,0 +1,73 @@
+/*!
+	@file     Arduino.h
+	@brief    Host (Linux) stand-in for the Arduino core, used to build and test Display16_LTSM off target.
+	@details  Provides just enough of the Arduino API for the library to compile: GPIO, delays, Print
+			  and Serial. Every GPIO write is forwarded to the attached host bus device so that a
+			  mock display can follow the CS and DC lines. NOT part of the core library.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define HIGH 0x1
+#define LOW  0x0
+#define INPUT  0x0
+#define OUTPUT 0x1
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+unsigned long millis(void);
+unsigned long micros(void);
+void yield(void);
+
+#include "Print.h"
+
+/*! @brief Host stand-in for the Arduino hardware serial port, output goes to stdout */
+class HardwareSerial : public Print
+{
+public:
+	void begin(unsigned long) {}
+	void end(void) {}
+	size_t write(uint8_t c) override;
+	using Print::write;
+};
+
+extern HardwareSerial Serial;
+
+/*! namespace for the host bus, links the stand-in core to a mock device */
+namespace ArduinoHost {
+
+/*!
+	@brief Interface for a mock peripheral on the host bus.
+	@details The stand-in core calls these hooks for every GPIO write, and for SPI
+		transfers while the device is selected, a mock display implements them to
+		count traffic and model its VRAM. Several devices may share the bus, each with its own CS.
+*/
+class BusDevice
+{
+public:
+	virtual ~BusDevice() {}
+	virtual bool isSelected(void) const = 0;
+	virtual void onPinWrite(uint8_t pin, uint8_t val) = 0;
+	virtual void onSpiBeginTransaction(void) = 0;
+	virtual void onSpiEndTransaction(void) = 0;
+	virtual void onSpiTransfer(const uint8_t *data, size_t len) = 0;
+};
+
+void attachDevice(BusDevice *device);
+void detachDevice(BusDevice *device);
+
+} // namespace ArduinoHost
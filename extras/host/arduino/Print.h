@@ -0,0 +1,62 @@
+/*!
+	@file     Print.h
+	@brief    Host (Linux) stand-in for the Arduino Print class. NOT part of the core library.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+/*! @brief Host stand-in for Arduino Print, same public interface as the core class */
+class Print
+{
+public:
+	Print() {}
+	virtual ~Print() {}
+
+	int getWriteError() { return _writeError; }
+	void clearWriteError() { setWriteError(0); }
+
+	virtual size_t write(uint8_t) = 0;
+	virtual size_t write(const uint8_t *buffer, size_t size);
+	size_t write(const char *str)
+	{
+		if (str == nullptr) return 0;
+		return write(reinterpret_cast<const uint8_t *>(str), strlen(str));
+	}
+	size_t write(const char *buffer, size_t size)
+	{
+		return write(reinterpret_cast<const uint8_t *>(buffer), size);
+	}
+	virtual int availableForWrite() { return 0; }
+	virtual void flush() {}
+
+	size_t print(const char[]);
+	size_t print(char);
+	size_t print(unsigned char, int = 10);
+	size_t print(int, int = 10);
+	size_t print(unsigned int, int = 10);
+	size_t print(long, int = 10);
+	size_t print(unsigned long, int = 10);
+	size_t print(double, int = 2);
+
+	size_t println(const char[]);
+	size_t println(char);
+	size_t println(unsigned char, int = 10);
+	size_t println(int, int = 10);
+	size_t println(unsigned int, int = 10);
+	size_t println(long, int = 10);
+	size_t println(unsigned long, int = 10);
+	size_t println(double, int = 2);
+	size_t println(void);
+
+protected:
+	void setWriteError(int err = 1) { _writeError = err; }
+
+private:
+	size_t printNumber(unsigned long, uint8_t);
+	size_t printFloat(double, uint8_t);
+	int _writeError = 0;
+};
@@ -0,0 +1,57 @@
+/*!
+	@file     SPI.h
+	@brief    Host (Linux) stand-in for the Arduino SPI library. NOT part of the core library.
+	@details  Transfers are forwarded to the device attached to the host bus,
+			  see ArduinoHost::attachDevice. MISO is modelled as idle high, so
+			  in place transfers overwrite the caller's buffer with 0xFF like real hardware would.
+			  transferAsync follows the arduino-pico (RP2040) API, a worker thread stands in for the DMA.
+*/
+
+#pragma once
+
+#include "Arduino.h"
+
+#define SPI_HAS_TRANSACTION 1
+#define SPI_HAS_TRANSFER_ASYNC 1
+
+#define MSBFIRST 1
+#define LSBFIRST 0
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x04
+#define SPI_MODE2 0x08
+#define SPI_MODE3 0x0C
+#define SPI_CLOCK_DIV8 0x05
+
+/*! @brief Host stand-in for Arduino SPISettings */
+class SPISettings
+{
+public:
+	SPISettings() {}
+	SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode)
+		: _clock(clock), _bitOrder(bitOrder), _dataMode(dataMode) {}
+	uint32_t _clock = 4000000;
+	uint8_t _bitOrder = MSBFIRST;
+	uint8_t _dataMode = SPI_MODE0;
+};
+
+/*! @brief Host stand-in for the Arduino SPI class */
+class SPIClass
+{
+public:
+	void begin(void) {}
+	void end(void) {}
+	void beginTransaction(SPISettings settings);
+	void endTransaction(void);
+	void setClockDivider(uint8_t) {}
+	uint8_t transfer(uint8_t data);
+	void transfer(void *buf, size_t count);
+	bool transferAsync(const void *send, void *recv, size_t bytes);
+	bool finishedAsync(void);
+	void abortAsync(void);
+};
+
+extern SPIClass SPI;
+
+namespace ArduinoHost {
+void holdAsyncTransfers(bool hold);
+}
@@ -0,0 +1,170 @@
+/*!
+	@file     arduino_host.cpp
+	@brief    Host (Linux) stand-in for the Arduino core and SPI library. NOT part of the core library.
+*/
+
+#include "Arduino.h"
+#include "SPI.h"
+#include <stdio.h>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+
+HardwareSerial Serial;
+SPIClass SPI;
+
+namespace {
+std::vector<ArduinoHost::BusDevice *> hostDevices;
+
+// Sends bus traffic to the selected devices
+void busTransfer(const uint8_t *data, size_t len)
+{
+	for (ArduinoHost::BusDevice *device : hostDevices)
+		if (device->isSelected())
+			device->onSpiTransfer(data, len);
+}
+const auto hostStartTime = std::chrono::steady_clock::now();
+// Async SPI stand-in, one transfer in flight on a worker thread
+std::thread asyncWorker;
+std::atomic<bool> asyncDone(true);
+std::mutex asyncHoldMutex;
+std::condition_variable asyncHoldCv;
+bool asyncHold = false;
+}
+
+// === Host bus ===
+
+void ArduinoHost::attachDevice(BusDevice *device)
+{
+	if (std::find(hostDevices.begin(), hostDevices.end(), device) == hostDevices.end())
+		hostDevices.push_back(device);
+}
+
+void ArduinoHost::detachDevice(BusDevice *device)
+{
+	hostDevices.erase(std::remove(hostDevices.begin(), hostDevices.end(), device), hostDevices.end());
+}
+
+// === GPIO & timing ===
+
+void pinMode(uint8_t, uint8_t) {}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+	for (ArduinoHost::BusDevice *device : hostDevices)
+		device->onPinWrite(pin, val);
+}
+
+int digitalRead(uint8_t) { return LOW; }
+
+// Delays are not simulated, the host build measures bus traffic not time.
+void delay(unsigned long) {}
+void delayMicroseconds(unsigned int) {}
+void yield(void) {}
+
+unsigned long millis(void)
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now() - hostStartTime).count();
+}
+
+unsigned long micros(void)
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - hostStartTime).count();
+}
+
+// === Serial ===
+
+size_t HardwareSerial::write(uint8_t c)
+{
+	return fputc(c, stdout) == EOF ? 0 : 1;
+}
+
+// === SPI ===
+
+void SPIClass::beginTransaction(SPISettings)
+{
+	for (ArduinoHost::BusDevice *device : hostDevices)
+		device->onSpiBeginTransaction();
+}
+
+void SPIClass::endTransaction(void)
+{
+	for (ArduinoHost::BusDevice *device : hostDevices)
+		device->onSpiEndTransaction();
+}
+
+uint8_t SPIClass::transfer(uint8_t data)
+{
+	busTransfer(&data, 1);
+	return 0xFF;
+}
+
+void SPIClass::transfer(void *buf, size_t count)
+{
+	uint8_t *data = static_cast<uint8_t *>(buf);
+	busTransfer(data, count);
+	memset(data, 0xFF, count); // received bytes replace sent ones
+}
+
+/*!
+	@brief Start a transfer on a worker thread, stands in for DMA.
+	@param send bytes to send, must stay valid until finishedAsync returns true
+	@param recv receive buffer, ignored, may be nullptr
+	@param bytes number of bytes
+	@return false if a transfer is already in flight
+*/
+bool SPIClass::transferAsync(const void *send, void *recv, size_t bytes)
+{
+	(void)recv;
+	if (!asyncDone.load())
+		return false;
+	if (asyncWorker.joinable())
+		asyncWorker.join();
+	asyncDone.store(false);
+	const uint8_t *data = static_cast<const uint8_t *>(send);
+	asyncWorker = std::thread([data, bytes]() {
+		{
+			std::unique_lock<std::mutex> lock(asyncHoldMutex);
+			asyncHoldCv.wait(lock, [] { return !asyncHold; });
+		}
+		busTransfer(data, bytes);
+		asyncDone.store(true);
+	});
+	return true;
+}
+
+bool SPIClass::finishedAsync(void)
+{
+	if (!asyncDone.load())
+		return false;
+	if (asyncWorker.joinable())
+		asyncWorker.join();
+	return true;
+}
+
+void SPIClass::abortAsync(void)
+{
+	ArduinoHost::holdAsyncTransfers(false);
+	finishedAsync();
+	if (asyncWorker.joinable())
+		asyncWorker.join();
+}
+
+/*!
+	@brief Hold async transfers before they start, lets tests observe a transfer in flight.
+	@param hold true to hold, false to release
+*/
+void ArduinoHost::holdAsyncTransfers(bool hold)
+{
+	{
+		std::lock_guard<std::mutex> lock(asyncHoldMutex);
+		asyncHold = hold;
+	}
+	asyncHoldCv.notify_all();
+}
@@ -0,0 +1,263 @@
+/*!
+	@file    display16_mock_LTSM.cpp
+	@brief   Source file for mock display class, host build of the 16-bit arduino display library. Display16_LTSM
+*/
+
+#include "display16_mock_LTSM.hpp"
+
+uint8_t display16_mock_LTSM::_instanceCount = 0;
+
+/*!
+	@brief Construct a mock display
+	@param width panel width in pixels
+	@param height panel height in pixels
+	@param hardwareSPI true for hardware SPI, false for software SPI
+ */
+display16_mock_LTSM::display16_mock_LTSM(uint16_t width, uint16_t height, bool hardwareSPI)
+{
+	_width = width;
+	_height = height;
+	_XStart = 0;
+	_YStart = 0;
+	_hardwareSPI = hardwareSPI;
+	_speedSPIHz = 40000000;
+	_display_RST = PIN_RST;
+	_display_DC = PIN_DC;
+	_display_CS = PIN_CS_BASE + (_instanceCount++ % 16);
+	_display_SDATA = PIN_SDATA;
+	_display_SCLK = PIN_SCLK;
+	_display_MISO = -1;
+	_vram.assign(static_cast<size_t>(width) * height, 0);
+}
+
+display16_mock_LTSM::~display16_mock_LTSM()
+{
+	ArduinoHost::detachDevice(this);
+}
+
+/*!
+	@brief Attach the mock display to the host bus and set GPIO idle levels.
+	@details Counters are reset after the GPIO setup.
+ */
+void display16_mock_LTSM::begin(void)
+{
+	ArduinoHost::attachDevice(this);
+	DISPLAY16_CS_SetDigitalOutput;
+	DISPLAY16_DC_SetDigitalOutput;
+	DISPLAY16_RST_SetDigitalOutput;
+	DISPLAY16_CS_SetHigh;
+	DISPLAY16_DC_SetHigh;
+	DISPLAY16_RST_SetHigh;
+	if (!_hardwareSPI)
+	{
+		DISPLAY16_SCLK_SetDigitalOutput;
+		DISPLAY16_SDATA_SetDigitalOutput;
+		DISPLAY16_SCLK_SetLow;
+		DISPLAY16_SDATA_SetLow;
+	}
+	resetCounters();
+}
+
+/*!
+	@brief Set the address window, ILI9341 command sequence
+	@param x0 column start
+	@param y0 row start
+	@param x1 column end, inclusive
+	@param y1 row end, inclusive
+ */
+void display16_mock_LTSM::setAddrWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
+{
+	_counters.addrWindows++;
+	x0 += _XStart; x1 += _XStart;
+	y0 += _YStart; y1 += _YStart;
+	writeCommand(CMD_CASET);
+	writeData(x0 >> 8);
+	writeData(x0 & 0xFF);
+	writeData(x1 >> 8);
+	writeData(x1 & 0xFF);
+	writeCommand(CMD_RASET);
+	writeData(y0 >> 8);
+	writeData(y0 & 0xFF);
+	writeData(y1 >> 8);
+	writeData(y1 & 0xFF);
+	writeCommand(CMD_RAMWR);
+}
+
+/*!
+	@brief Read a pixel from the panel VRAM model
+	@param x column
+	@param y row
+	@return 565 colour at (x,y), 0 if out of bounds
+ */
+uint16_t display16_mock_LTSM::getPanelPixel(uint16_t x, uint16_t y) const
+{
+	if (x >= _width || y >= _height)
+		return 0;
+	return _vram[static_cast<size_t>(y) * _width + x];
+}
+
+/*!
+	@brief Fill the panel VRAM model directly, no bus traffic
+	@param color 565 colour
+ */
+void display16_mock_LTSM::fillPanel(uint16_t color)
+{
+	_vram.assign(_vram.size(), color);
+}
+
+/*!
+	@brief Get the bus traffic counters since the last reset
+	@return reference to the counters
+ */
+const mock_counters_t& display16_mock_LTSM::getCounters(void) const
+{
+	return _counters;
+}
+
+/*!
+	@brief Reset the bus traffic counters
+ */
+void display16_mock_LTSM::resetCounters(void)
+{
+	_counters = mock_counters_t();
+}
+
+/*!
+	@brief Count the bus traffic of a single draw call
+	@param drawCall the draw call to measure
+	@return the counters recorded while drawCall ran
+ */
+mock_counters_t display16_mock_LTSM::measure(const std::function<void()>& drawCall)
+{
+	resetCounters();
+	drawCall();
+	return _counters;
+}
+
+// === Host bus hooks ===
+
+bool display16_mock_LTSM::isSelected(void) const
+{
+	return _pinLevel[_display_CS] == LOW;
+}
+
+void display16_mock_LTSM::onPinWrite(uint8_t pin, uint8_t val)
+{
+	if (pin >= sizeof(_pinLevel))
+		return;
+	uint8_t previous = _pinLevel[pin];
+	_pinLevel[pin] = val;
+	if (previous == val)
+		return;
+	if (pin == _display_CS)
+	{
+		_counters.csToggles++;
+		if (val == LOW)
+		{
+			_counters.transactions++;
+			_swBits = 0;
+		}
+	}
+	else if (pin == PIN_DC)
+	{
+		if (isSelected())
+			_counters.dcToggles++;
+	}
+	else if (pin >= PIN_CS_BASE)
+	{
+		return; // another mock display's chip select
+	}
+	else if (pin == PIN_SCLK && val == HIGH && !_hardwareSPI && isSelected())
+	{
+		// Software SPI, sample MOSI on the rising clock edge
+		_swByte = (_swByte << 1) | (_pinLevel[PIN_SDATA] ? 1 : 0);
+		if (++_swBits == 8)
+		{
+			_swBits = 0;
+			_counters.spiCalls++;
+			decodeByte(_swByte);
+		}
+	}
+}
+
+void display16_mock_LTSM::onSpiBeginTransaction(void) {}
+
+void display16_mock_LTSM::onSpiEndTransaction(void) {}
+
+void display16_mock_LTSM::onSpiTransfer(const uint8_t *data, size_t len)
+{
+	_counters.spiCalls++;
+	for (size_t i = 0; i < len; i++)
+		decodeByte(data[i]);
+}
+
+/// @cond
+
+/*!
+	@brief Decode one byte of bus traffic into the panel model
+	@param byte the byte on the bus, command or data according to the DC line
+ */
+void display16_mock_LTSM::decodeByte(uint8_t byte)
+{
+	_counters.bytesSent++;
+	if (_pinLevel[PIN_DC] == LOW)
+	{
+		_counters.commandBytes++;
+		_command = byte;
+		_paramIndex = 0;
+		if (_command == CMD_RAMWR)
+		{
+			_col = _colStart;
+			_row = _rowStart;
+			_pixelHighByte = true;
+		}
+		return;
+	}
+	_counters.dataBytes++;
+	switch (_command)
+	{
+	case CMD_CASET:
+	case CMD_RASET:
+		if (_paramIndex < 4)
+			_params[_paramIndex++] = byte;
+		if (_paramIndex == 4)
+		{
+			uint16_t start = (_params[0] << 8) | _params[1];
+			uint16_t end = (_params[2] << 8) | _params[3];
+			if (_command == CMD_CASET) { _colStart = start; _colEnd = end; }
+			else { _rowStart = start; _rowEnd = end; }
+		}
+		break;
+	case CMD_RAMWR:
+		if (_pixelHighByte)
+		{
+			_pixelHigh = byte;
+			_pixelHighByte = false;
+		}else{
+			writePanelPixel((_pixelHigh << 8) | byte);
+			_pixelHighByte = true;
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+/*!
+	@brief Write a pixel at the panel write pointer and advance it within the window
+	@param color 565 colour
+ */
+void display16_mock_LTSM::writePanelPixel(uint16_t color)
+{
+	_counters.pixelsWritten++;
+	if (_col < _width && _row < _height)
+		_vram[static_cast<size_t>(_row) * _width + _col] = color;
+	if (++_col > _colEnd)
+	{
+		_col = _colStart;
+		if (++_row > _rowEnd)
+			_row = _rowStart;
+	}
+}
+
+/// @endcond
@@ -0,0 +1,97 @@
+/*!
+	@file    display16_mock_LTSM.hpp
+	@brief   header file for mock display class, host build of the 16-bit arduino display library. Display16_LTSM
+	@details A concrete display16_graphics_LTSM sub class for the Linux host build.
+			 It drives an ILI9341 style command set (CASET, RASET, RAMWR) over the
+			 stand-in SPI bus, decodes the traffic into a model of the panel VRAM and
+			 counts bytes, transactions, CS/DC toggles and address windows.
+			 NOT part of the core library.
+*/
+
+#pragma once
+
+#include <display16_graphics_LTSM.hpp>
+#include <vector>
+#include <functional>
+
+/*! @brief Bus traffic counters recorded by the mock display */
+struct mock_counters_t
+{
+	uint32_t bytesSent = 0;      /**< All bytes clocked out, commands and data */
+	uint32_t commandBytes = 0;   /**< Bytes sent with DC low */
+	uint32_t dataBytes = 0;      /**< Bytes sent with DC high */
+	uint32_t spiCalls = 0;       /**< Calls into the SPI transport, single byte or block */
+	uint32_t transactions = 0;   /**< Transactions started, CS falling edges */
+	uint32_t csToggles = 0;      /**< CS line level changes */
+	uint32_t dcToggles = 0;      /**< DC line level changes */
+	uint32_t addrWindows = 0;    /**< setAddrWindow calls */
+	uint32_t pixelsWritten = 0;  /**< Pixels written into panel VRAM */
+};
+
+/*!
+	@brief Mock display for the host build, models an ILI9341 style panel
+ */
+class display16_mock_LTSM : public display16_graphics_LTSM, public ArduinoHost::BusDevice
+{
+public:
+	/*! GPIO numbers used by the mock display, lines shared by all mock displays on the bus */
+	enum mock_pins_e : uint8_t
+	{
+		PIN_RST = 8,     /**< Reset line */
+		PIN_DC = 9,      /**< Data or command line */
+		PIN_SDATA = 11,  /**< MOSI line, software SPI */
+		PIN_SCLK = 13,   /**< Clock line, software SPI */
+		PIN_CS_BASE = 16 /**< Chip select line of the first mock display, each instance gets its own */
+	};
+
+	display16_mock_LTSM(uint16_t width, uint16_t height, bool hardwareSPI = true);
+	~display16_mock_LTSM();
+
+	void begin(void);
+	void setAddrWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) override;
+
+	// Panel model
+	uint16_t getPanelPixel(uint16_t x, uint16_t y) const;
+	void fillPanel(uint16_t color);
+	// Counters
+	const mock_counters_t& getCounters(void) const;
+	void resetCounters(void);
+	mock_counters_t measure(const std::function<void()>& drawCall);
+
+	// Host bus hooks
+	bool isSelected(void) const override;
+	void onPinWrite(uint8_t pin, uint8_t val) override;
+	void onSpiBeginTransaction(void) override;
+	void onSpiEndTransaction(void) override;
+	void onSpiTransfer(const uint8_t *data, size_t len) override;
+
+	// Protected SPI functions exposed for tests
+	using display16_graphics_LTSM::spiWriteDataBuffer;
+	using display16_graphics_LTSM::spiWriteScratchBuffer;
+	using display16_graphics_LTSM::writeCommand;
+	using display16_graphics_LTSM::writeData;
+
+private:
+	static constexpr uint8_t CMD_CASET = 0x2A; /**< Column address set */
+	static constexpr uint8_t CMD_RASET = 0x2B; /**< Row address set */
+	static constexpr uint8_t CMD_RAMWR = 0x2C; /**< Memory write */
+
+	void decodeByte(uint8_t byte);
+	void writePanelPixel(uint16_t color);
+
+	mock_counters_t _counters;
+	std::vector<uint16_t> _vram;  /**< Model of the panel VRAM */
+	uint8_t _pinLevel[PIN_CS_BASE + 16] = {}; /**< Last level written to each GPIO */
+	static uint8_t _instanceCount;  /**< Mock displays created, assigns the CS lines */
+	// Command decoder
+	uint8_t _command = 0;
+	uint8_t _paramIndex = 0;
+	uint8_t _params[4] = {};
+	uint16_t _colStart = 0, _colEnd = 0, _rowStart = 0, _rowEnd = 0;
+	uint16_t _col = 0, _row = 0;
+	bool _pixelHighByte = true;
+	uint8_t _pixelHigh = 0;
+	// Software SPI decoder
+	uint8_t _swByte = 0;
+	uint8_t _swBits = 0;
+};
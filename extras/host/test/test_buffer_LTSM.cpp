@@ -0,0 +1,510 @@
+/*!
+	@file    test_buffer_LTSM.cpp
+	@brief   Host tests for Display16_LTSM, advanced screen buffer mode.
+*/
+
+#include "test_util_LTSM.hpp"
+
+using namespace TestLTSM;
+
+namespace {
+constexpr uint16_t W = 96;
+constexpr uint16_t H = 64;
+}
+
+TEST_CASE(buffer_lifecycle)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	CHECK_EQ(tft.clearBuffer(0), DisLib16::BufferEmpty);
+	CHECK_EQ(tft.writeBuffer(), DisLib16::BufferEmpty);
+	CHECK_EQ(tft.setBuffer(), DisLib16::Success);
+	CHECK_EQ(tft.clearBuffer(0x1234), DisLib16::Success);
+	CHECK_EQ(tft.destroyBuffer(), DisLib16::Success);
+}
+
+TEST_CASE(drawPixel_goes_to_buffer_until_flush)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	tft.setBuffer();
+	tft.clearBuffer(0x0000);
+	mock_counters_t c = tft.measure([&]{ tft.drawPixel(3, 4, 0xF800); });
+	CHECK_EQ(c.bytesSent, 0u);
+	CHECK_EQ(tft.getPanelPixel(3, 4), 0x0000);
+	c = tft.measure([&]{ tft.writeBuffer(); });
+	CHECK_EQ(tft.getPanelPixel(3, 4), 0xF800);
+	CHECK_EQ(c.pixelsWritten, static_cast<uint32_t>(W) * H);
+	// row by row mode gives the same panel content
+	tft.drawPixel(W - 1, H - 1, 0x07E0);
+	c = tft.measure([&]{ tft.writeBuffer(1); });
+	CHECK_EQ(tft.getPanelPixel(W - 1, H - 1), 0x07E0);
+	CHECK_EQ(tft.getPanelPixel(3, 4), 0xF800);
+	CHECK_EQ(c.addrWindows, static_cast<uint32_t>(H));
+	tft.destroyBuffer();
+}
+
+TEST_CASE(bitmap_pixel_text_go_to_buffer)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	tft.setBuffer();
+	tft.clearBuffer(0x0000);
+	static const uint8_t mono[2] = {0xFF, 0x00};
+	tft.setTextCharPixelOrBuffer(true);
+	tft.setTextColor(0xFFFF, 0x0000);
+	mock_counters_t c = tft.measure([&]{
+		tft.drawBitmap(0, 0, 8, 2, 0x001F, 0x0000, mono);
+		tft.writeChar(16, 16, 'A');
+	});
+	CHECK_EQ(c.bytesSent, 0u);
+	tft.writeBuffer();
+	CHECK_EQ(rectMismatches(tft, 0, 0, 8, 1, 0x001F), 0u);
+	CHECK_EQ(glyphMismatches(tft, 16, 16, FontDefault, 'A', 0xFFFF, 0x0000), 0u);
+	tft.destroyBuffer();
+}
+
+TEST_CASE(bitmaps_land_at_their_position)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	tft.setBuffer();
+	tft.clearBuffer(0x1111);
+	// 5x3, pixel (i, j) is 0x8000 + j * 16 + i, the middle column is transparent 0x0000
+	static uint8_t rgb565[5 * 3 * 2];
+	for (uint16_t j = 0; j < 3; j++)
+		for (uint16_t i = 0; i < 5; i++)
+		{
+			const uint16_t color = (i == 2) ? 0x0000 : static_cast<uint16_t>(0x8000 + j * 16 + i);
+			rgb565[(j * 5 + i) * 2] = color >> 8;
+			rgb565[(j * 5 + i) * 2 + 1] = color & 0xFF;
+		}
+	auto source = [](uint16_t i, uint16_t j) { return (i == 2) ? 0x0000 : static_cast<uint16_t>(0x8000 + j * 16 + i); };
+	tft.drawBitmap16Data(10, 4, rgb565, 5, 3);
+	tft.drawSpriteData(20, 4, rgb565, 5, 3, 0x0000, false);
+	tft.drawSpriteData(30, 4, rgb565, 5, 3, 0x0000, true);
+	// clipped, rows keep their source stride
+	tft.drawBitmap16Data(W - 2, H - 2, rgb565, 5, 3);
+	tft.drawSpriteData(W - 2, 40, rgb565, 5, 3, 0x0000, false);
+	tft.writeBuffer();
+	uint32_t errors = 0;
+	for (uint16_t j = 0; j < 3; j++)
+		for (uint16_t i = 0; i < 5; i++)
+		{
+			errors += tft.getPanelPixel(10 + i, 4 + j) != source(i, j);
+			errors += tft.getPanelPixel(20 + i, 4 + j) != ((i == 2) ? 0x1111 : source(i, j));
+			errors += tft.getPanelPixel(30 + i, 4 + j) != source(i, j);
+		}
+	CHECK_EQ(errors, 0u);
+	CHECK_EQ(tft.getPanelPixel(9, 4), 0x1111);
+	CHECK_EQ(tft.getPanelPixel(10, 3), 0x1111);
+	CHECK_EQ(tft.getPanelPixel(W - 1, H - 1), source(1, 1));
+	CHECK_EQ(tft.getPanelPixel(W - 2, 42), source(0, 2));
+	CHECK_EQ(tft.getPanelPixel(W - 1, 42), source(1, 2));
+	tft.destroyBuffer();
+}
+
+TEST_CASE(async_write_returns_before_transfer_completes)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	tft.setBuffer();
+	tft.clearBuffer(0x0000);
+	tft.drawPixel(10, 10, 0xF800);
+	ArduinoHost::holdAsyncTransfers(true);
+	CHECK_EQ(tft.writeBufferAsync(), DisLib16::Success);
+	CHECK(tft.isBufferWriteBusy());
+	CHECK_EQ(tft.getPanelPixel(10, 10), 0x0000);
+	// next frame drawn while the snapshot is in flight
+	tft.drawPixel(10, 10, 0x07E0);
+	ArduinoHost::holdAsyncTransfers(false);
+	tft.waitBufferWrite();
+	CHECK(!tft.isBufferWriteBusy());
+	CHECK_EQ(tft.getPanelPixel(10, 10), 0xF800);
+	CHECK_EQ(tft.getCounters().pixelsWritten, static_cast<uint32_t>(W) * H);
+	// second frame
+	tft.writeBufferAsync();
+	tft.waitBufferWrite();
+	CHECK_EQ(tft.getPanelPixel(10, 10), 0x07E0);
+	tft.destroyBuffer();
+}
+
+TEST_CASE(async_write_without_snapshot_and_bus_guard)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	tft.setBuffer();
+	tft.clearBuffer(0x001F);
+	ArduinoHost::holdAsyncTransfers(true);
+	CHECK_EQ(tft.writeBufferAsync(false), DisLib16::Success);
+	CHECK(tft.isBufferWriteBusy());
+	ArduinoHost::holdAsyncTransfers(false);
+	// any other SPI traffic waits for the async write
+	tft.writeCommand(0x00);
+	CHECK(!tft.isBufferWriteBusy());
+	CHECK_EQ(rectMismatches(tft, 0, 0, W, H, 0x001F), 0u);
+	CHECK_EQ(tft.writeBufferAsync(), DisLib16::Success);
+	tft.destroyBuffer();
+	CHECK(!tft.isBufferWriteBusy());
+	CHECK_EQ(tft.writeBufferAsync(), DisLib16::BufferEmpty);
+}
+
+TEST_CASE(dirty_single_pixel_flushes_one_pixel)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	tft.setBuffer();
+	tft.clearBuffer(0x0000);
+	CHECK_EQ(tft.getDirtyRectCount(), 1u); // whole screen after clear
+	tft.writeBuffer();
+	CHECK_EQ(tft.getDirtyRectCount(), 0u);
+	tft.drawPixel(20, 30, 0xF800);
+	CHECK_EQ(tft.getDirtyRectCount(), 1u);
+	display16_graphics_LTSM::dirty_rect_t r = tft.getDirtyRect(0);
+	CHECK(r.x0 == 20 && r.y0 == 30 && r.x1 == 20 && r.y1 == 30);
+	mock_counters_t c = tft.measure([&]{ tft.writeBufferDirty(); });
+	CHECK_EQ(c.pixelsWritten, 1u);
+	CHECK_EQ(c.addrWindows, 1u);
+	CHECK_EQ(tft.getPanelPixel(20, 30), 0xF800);
+	CHECK_EQ(tft.getDirtyRectCount(), 0u);
+	// nothing damaged, nothing sent
+	c = tft.measure([&]{ tft.writeBufferDirty(); });
+	CHECK_EQ(c.bytesSent, 0u);
+	tft.destroyBuffer();
+}
+
+TEST_CASE(dirty_regions_merge_and_match_full_flush)
+{
+	display16_mock_LTSM tft(W, H);
+	display16_mock_LTSM reference(W, H);
+	auto frame = [](display16_mock_LTSM& t, uint16_t n) {
+		t.drawLine(0, n, 40, n + 10, 0xFFFF);
+		t.setTextCharPixelOrBuffer(true);
+		t.setTextColor(0xF800, 0x0000);
+		t.writeChar(60, 40, '0' + n);
+		static const uint8_t mono[2] = {0xAA, 0x55};
+		t.drawBitmap(80, 2, 8, 2, 0x07E0, 0x001F, mono);
+		for (uint16_t i = 0; i < 20; i++)
+			t.drawPixel((i * 37) % W, (i * 23) % H, 0x1234 + n);
+	};
+	for (display16_mock_LTSM* t : {&tft, &reference})
+	{
+		t->begin();
+		t->setBuffer();
+		t->clearBuffer(0x0000);
+		t->writeBuffer();
+	}
+	for (uint16_t n = 0; n < 3; n++)
+	{
+		frame(tft, n);
+		frame(reference, n);
+		CHECK(tft.getDirtyRectCount() <= 8u);
+		mock_counters_t c = tft.measure([&]{ tft.writeBufferDirty(); });
+		CHECK(c.pixelsWritten < static_cast<uint32_t>(W) * H / 2);
+		reference.writeBuffer();
+		CHECK_EQ(panelDifferences(tft, reference, W, H), 0u);
+	}
+	// row by row mode
+	frame(tft, 5);
+	frame(reference, 5);
+	tft.writeBufferDirty(1);
+	reference.writeBuffer();
+	CHECK_EQ(panelDifferences(tft, reference, W, H), 0u);
+	tft.destroyBuffer();
+	reference.destroyBuffer();
+}
+
+TEST_CASE(dirty_mark_clips_and_clears)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	tft.setBuffer();
+	tft.clearBufferDirty();
+	tft.markBufferDirty(W - 2, H - 2, 10, 10);
+	display16_graphics_LTSM::dirty_rect_t r = tft.getDirtyRect(0);
+	CHECK(r.x1 == W - 1 && r.y1 == H - 1);
+	tft.markBufferDirty(W, 0, 1, 1);
+	tft.markBufferDirty(0, 0, 0, 5);
+	CHECK_EQ(tft.getDirtyRectCount(), 1u);
+	tft.clearBufferDirty();
+	CHECK_EQ(tft.getDirtyRectCount(), 0u);
+	tft.destroyBuffer();
+}
+
+namespace {
+// Draws with every primitive, on a screen buffer or straight to VRAM
+void primitiveScene(display16_mock_LTSM& t)
+{
+	static const uint8_t mono[4] = {0xF0, 0x0F, 0xAA, 0x55};
+	static const uint8_t rgb332[6] = {0xE0, 0x1C, 0x03, 0xFF, 0x00, 0x92};
+	static const uint8_t sprite[8] = {0xF8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0xE0};
+	static const uint8_t indexed[18] = {2, 0, 5, 0, 2, 3, 0xF8,0x00, 0x07,0xE0, 0x00,0x1F, 0xFF,0xFF,
+		0x1B,0x00, 0xE4,0x80}; // 5x2, 2 bits per pixel
+	static const uint8_t compressed[14] = {0x51, 0, 6, 0, 2, 0xC1, 0x7F, 0xA9, 0x88, 0xFE, 0x80, 0x00, 0x0F, 0xC5}; // 6x2
+	t.fillScreen(0x1234);
+	t.fillRect(4, 4, 20, 10, 0xFFFF);
+	t.fillRectBuffer(W - 10, H - 6, 30, 30, 0xF81F);
+	t.drawFastHLine(0, 20, W + 10, 0x07E0);
+	t.drawFastVLine(30, 0, H + 10, 0x001F);
+	t.drawRectWH(40, 2, 20, 12, 0xFFE0);
+	t.drawLine(0, 0, W - 1, H - 1, 0xF800);
+	t.drawCircle(70, 40, 12, 0x07FF);
+	t.fillCircle(20, 45, 9, 0xFD20);
+	t.drawRoundRect(50, 30, 30, 20, 5, 0x0000);
+	t.fillRoundRect(60, 48, 24, 12, 4, 0x8410);
+	t.drawTriangle(5, 60, 25, 50, 35, 63, 0xFFFF);
+	t.fillTriangle(80, 5, 94, 15, 70, 20, 0x4208);
+	t.drawEllipse(48, 50, 10, 5, true, 0xA145);
+	t.drawPolygon(70, 20, 6, 12, 0, false, 0x2104);
+	t.drawArc(40, 40, 10, 3, 0.0f, 180.0f, 0xC618);
+	t.drawBitmap(0, 24, 16, 2, 0x001F, 0xFFFF, mono);
+	t.drawBitmap8Data(20, 24, rgb332, 3, 2);
+	t.drawSpriteData(40, 24, sprite, 2, 2, 0x0000, false);
+	t.drawSpriteData(W - 1, 30, sprite, 2, 2, 0x0000, true);
+	t.drawBitmap16Data(44, 30, sprite, 2, 2);
+	t.drawBitmap16Data(W - 1, H - 1, sprite, 2, 2);
+	t.drawBitmapIndexed(50, 24, indexed);
+	t.drawBitmapIndexed(W - 3, H - 1, indexed);
+	t.drawBitmapCompressed(60, 24, compressed);
+	t.drawBitmapCompressed(W - 4, H - 1, compressed);
+	uint8_t spriteRuns[16];
+	uint32_t spriteRunsUsed = 0;
+	t.buildSpriteRuns(sprite, 2, 2, 0x0000, spriteRuns, sizeof(spriteRuns), spriteRunsUsed);
+	t.drawSpriteRuns(70, 24, sprite, spriteRuns);
+	t.drawSpriteRuns(W - 1, H - 1, sprite, spriteRuns);
+	t.setTextColor(0xF800, 0x0000);
+	t.setTextCharPixelOrBuffer(false);
+	t.writeChar(8, 30, 'B');
+	t.setTextCharPixelOrBuffer(true);
+	t.writeChar(24, 30, 'C');
+	t.setTextCharPixelOrBuffer(false);
+	t.setCursor(0, 40);
+	t.print("wrap text 0123");
+}
+}
+
+TEST_CASE(every_primitive_matches_direct_render)
+{
+	display16_mock_LTSM direct(W, H);
+	display16_mock_LTSM buffered(W, H);
+	direct.begin();
+	buffered.begin();
+	primitiveScene(direct);
+	buffered.setBuffer();
+	mock_counters_t c = buffered.measure([&]{ primitiveScene(buffered); });
+	CHECK_EQ(c.bytesSent, 0u);
+	CHECK_EQ(countColor(buffered, W, H, 0x0000), static_cast<uint32_t>(W) * H);
+	buffered.writeBuffer();
+	CHECK_EQ(panelDifferences(direct, buffered, W, H), 0u);
+	// the same frame again through the dirty regions only
+	buffered.fillPanel(0x0000);
+	buffered.clearBuffer(0x0000);
+	buffered.clearBufferDirty();
+	primitiveScene(buffered);
+	buffered.writeBufferDirty();
+	CHECK_EQ(panelDifferences(direct, buffered, W, H), 0u);
+	buffered.destroyBuffer();
+}
+
+TEST_CASE(buffer_span_fills)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	tft.setBuffer();
+	tft.clearBuffer(0xFFFF); // memset path
+	tft.fillRectBuffer(0, 10, W, 5, 0x1234); // full width, one span
+	tft.fillRectBuffer(5, 30, 7, 9, 0xABCD); // row copies
+	tft.clearBufferDirty();
+	tft.drawFastVLine(90, 50, 4, 0x0F0F);
+	CHECK_EQ(tft.getDirtyRectCount(), 1u);
+	display16_graphics_LTSM::dirty_rect_t r = tft.getDirtyRect(0);
+	CHECK(r.x0 == 90 && r.x1 == 90 && r.y0 == 50 && r.y1 == 53);
+	tft.writeBuffer();
+	CHECK_EQ(rectMismatches(tft, 0, 10, W, 5, 0x1234), 0u);
+	CHECK_EQ(rectMismatches(tft, 5, 30, 7, 9, 0xABCD), 0u);
+	CHECK_EQ(rectMismatches(tft, 90, 50, 1, 4, 0x0F0F), 0u);
+	CHECK_EQ(countColor(tft, W, H, 0xFFFF), static_cast<uint32_t>(W) * H - W * 5 - 7 * 9 - 4);
+	tft.destroyBuffer();
+}
+
+TEST_CASE(char_clipped_at_buffer_edge)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	tft.setBuffer();
+	tft.clearBuffer(0x0000);
+	tft.setTextColor(0xFFFF, 0xF800);
+	// cell overhangs right and bottom edges, nothing may wrap into row or column 0
+	CHECK_EQ(tft.writeChar(W - 3, H - 4, 'W'), DisLib16::Success);
+	tft.writeBuffer();
+	CHECK_EQ(rectMismatches(tft, 0, 0, W - 3, H, 0x0000), 0u);
+	CHECK_EQ(rectMismatches(tft, 0, 0, W, H - 4, 0x0000), 0u);
+	tft.destroyBuffer();
+}
+
+TEST_CASE(drawing_goes_to_vram_without_buffer)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	CHECK(!tft.isBufferActive());
+	tft.fillScreen(0x0000);
+	tft.drawPixel(1, 1, 0xF800);
+	CHECK_EQ(tft.getPanelPixel(1, 1), 0xF800);
+	tft.setBuffer();
+	CHECK(tft.isBufferActive());
+	tft.drawPixel(2, 2, 0xF800);
+	CHECK_EQ(tft.getPanelPixel(2, 2), 0x0000);
+	tft.destroyBuffer();
+	CHECK(!tft.isBufferActive());
+	CHECK_EQ(tft.getDirtyRectCount(), 0u);
+	tft.fillRect(3, 3, 2, 2, 0x07E0);
+	CHECK_EQ(rectMismatches(tft, 3, 3, 2, 2, 0x07E0), 0u);
+}
+
+TEST_CASE(proportional_text_matches_direct_render)
+{
+	const std::vector<uint8_t> prop = makeProportionalFont(FontDefault);
+	display16_mock_LTSM direct(W, H), buffered(W, H);
+	auto scene = [&](display16_mock_LTSM& t) {
+		t.fillScreen(0x0000);
+		t.setFont(prop.data());
+		t.setTextColor(0xFFE0, 0x001F);
+		char text[] = "Proportional text in the buffer";
+		t.writeCharString(4, 4, text);
+		t.setCursor(W - 12, 40);
+		t.print("Wrap");
+	};
+	direct.begin();
+	buffered.begin();
+	buffered.setBuffer();
+	scene(direct);
+	scene(buffered);
+	buffered.writeBuffer();
+	CHECK_EQ(panelDifferences(direct, buffered, W, H), 0u);
+	CHECK_EQ(propGlyphMismatches(buffered, 4, 4, prop, 'P', 0xFFE0, 0x001F), 0u);
+	buffered.destroyBuffer();
+}
+
+TEST_CASE(antialiased_text_matches_direct_render)
+{
+	const std::vector<uint8_t> aa = makeAntiAliasedFont(FontDefault, 4);
+	display16_mock_LTSM direct(W, H), buffered(W, H);
+	auto scene = [&](display16_mock_LTSM& t) {
+		t.fillScreen(0x0000);
+		t.setFont(aa.data());
+		t.setTextColor(0xFFE0, 0x001F);
+		char text[] = "Smooth text";
+		t.writeCharString(4, 4, text);
+		t.setTextColor(0x07E0, 0x0000);
+		t.setCursor(W - 12, 40);
+		t.print("Wrap");
+	};
+	direct.begin();
+	buffered.begin();
+	buffered.setBuffer();
+	scene(direct);
+	scene(buffered);
+	buffered.writeBuffer();
+	CHECK_EQ(panelDifferences(direct, buffered, W, H), 0u);
+	CHECK_EQ(aaGlyphMismatches(buffered, 4, 4, aa, 'S', 0xFFE0, 0x001F), 0u);
+	buffered.destroyBuffer();
+}
+
+TEST_CASE(scaled_text_matches_direct_render)
+{
+	display16_mock_LTSM direct(W, H), buffered(W, H);
+	auto scene = [&](display16_mock_LTSM& t) {
+		t.fillScreen(0x0000);
+		t.setTextColor(0xFFE0, 0x001F);
+		t.setTextScale(3);
+		char text[] = "Big 42";
+		t.writeCharString(0, 4, text);
+		t.setTextScale(2);
+		t.setCursor(W - 20, 40); // clipped at the right edge, no wrap
+		t.setTextWrap(false);
+		t.print("7");
+		t.setTextScale(1);
+	};
+	direct.begin();
+	buffered.begin();
+	buffered.setBuffer();
+	scene(direct);
+	scene(buffered);
+	buffered.writeBuffer();
+	CHECK_EQ(panelDifferences(direct, buffered, W, H), 0u);
+	buffered.destroyBuffer();
+}
+
+TEST_CASE(text_box_matches_direct_render)
+{
+	display16_mock_LTSM direct(W, H), buffered(W, H);
+	auto scene = [&](display16_mock_LTSM& t) {
+		t.fillScreen(0xF800);
+		t.setTextColor(0xFFE0, 0x001F);
+		t.drawTextBox(4, 4, 100, 20, "Centre\nline two", display16_graphics_LTSM::TextAlignCentre);
+		t.drawTextBox(W - 30, 40, 40, 8, "Clipped", display16_graphics_LTSM::TextAlignRight);
+	};
+	direct.begin();
+	buffered.begin();
+	buffered.setBuffer();
+	scene(direct);
+	scene(buffered);
+	buffered.writeBuffer();
+	CHECK_EQ(panelDifferences(direct, buffered, W, H), 0u);
+	buffered.destroyBuffer();
+}
+
+TEST_CASE(transparent_antialiased_text_blends_with_buffer)
+{
+	const std::vector<uint8_t> aa = makeAntiAliasedFont(FontDefault, 4);
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	tft.setBuffer();
+	tft.clearBuffer(0x001F);
+	tft.setFont(aa.data());
+	tft.setTextColor(0xFFE0);
+	tft.setTextScale(2);
+	tft.writeChar(0, 0, 'A');
+	tft.setTextScale(1);
+	tft.writeChar(40, 0, 'B');
+	tft.writeBuffer();
+	CHECK_EQ(aaGlyphMismatches(tft, 40, 0, aa, 'B', 0xFFE0, 0x001F), 0u);
+	display16_mock_LTSM small(W, H);
+	small.begin();
+	small.setFont(aa.data());
+	small.setTextColor(0xFFE0, 0x001F);
+	small.writeChar(0, 0, 'A');
+	CHECK_EQ(scaledCellMismatches(small, 0, 0, tft, 0, 0, 8, 8, 2), 0u);
+	// 1 bit fonts go straight into the buffer, the rest of the cell kept
+	tft.setFont(FontDefault);
+	tft.writeChar(60, 0, 'C');
+	tft.writeBuffer();
+	CHECK_EQ(glyphMismatches(tft, 60, 0, FontDefault, 'C', 0xFFE0, 0x001F), 0u);
+	tft.setFont(FontDefault);
+	tft.destroyBuffer();
+}
+
+TEST_CASE(compressed_text_matches_direct_render)
+{
+	const std::vector<uint8_t> packed = makeExtendedFont(FontDefault, 2, true);
+	display16_mock_LTSM direct(W, H), buffered(W, H);
+	auto scene = [&](display16_mock_LTSM& t) {
+		t.fillScreen(0x0000);
+		t.setFont(packed.data());
+		t.setTextColor(0xFFE0, 0x001F);
+		char text[] = "Compressed text in the buffer";
+		t.writeCharString(4, 4, text);
+		t.writeChar(W - 3, H - 5, 'W');
+	};
+	direct.begin();
+	buffered.begin();
+	buffered.setBuffer();
+	scene(direct);
+	scene(buffered);
+	buffered.writeBuffer();
+	CHECK_EQ(panelDifferences(direct, buffered, W, H), 0u);
+	CHECK(countColor(buffered, W, H, 0xFFE0) > 0u);
+	buffered.destroyBuffer();
+}
+
+TEST_MAIN()
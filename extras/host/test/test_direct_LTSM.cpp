@@ -0,0 +1,1210 @@
+/*!
+	@file    test_direct_LTSM.cpp
+	@brief   Host tests for Display16_LTSM, direct VRAM mode (no screen buffer).
+	@details Checks pixel output through the mock panel model and records the
+			 bus traffic of each draw call, so performance regressions show up here.
+*/
+
+#include "test_util_LTSM.hpp"
+#include <fonts_LTSM/FontGroTesk_LTSM.hpp>
+#include <fonts_LTSM/FontGroTeskBig_LTSM.hpp>
+#include <fonts_LTSM/FontSevenSeg_LTSM.hpp>
+
+using namespace TestLTSM;
+
+namespace {
+constexpr uint16_t W = 128;
+constexpr uint16_t H = 96;
+// 3 commands and 8 parameter bytes for each address window
+constexpr uint32_t WINDOW_BYTES = 11;
+constexpr uint32_t WINDOW_TRANSACTIONS = 11;
+}
+
+TEST_CASE(drawPixel_writes_panel_and_costs_one_window)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	mock_counters_t c = tft.measure([&]{ tft.drawPixel(5, 7, 0xF800); });
+	CHECK_EQ(tft.getPanelPixel(5, 7), 0xF800);
+	CHECK_EQ(c.addrWindows, 1u);
+	CHECK_EQ(c.bytesSent, WINDOW_BYTES + 2);
+	CHECK_EQ(c.transactions, WINDOW_TRANSACTIONS + 1);
+	// out of bounds, no traffic
+	c = tft.measure([&]{ tft.drawPixel(W, 0, 0xFFFF); });
+	CHECK_EQ(c.bytesSent, 0u);
+}
+
+TEST_CASE(fillRectBuffer_fills_and_clips)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	mock_counters_t c = tft.measure([&]{ tft.fillRectBuffer(10, 20, 30, 4, 0x07E0); });
+	CHECK_EQ(rectMismatches(tft, 10, 20, 30, 4, 0x07E0), 0u);
+	CHECK_EQ(countColor(tft, W, H, 0x07E0), 30u * 4u);
+	CHECK_EQ(c.pixelsWritten, 30u * 4u);
+	CHECK(c.addrWindows <= 4u);
+	// clipped at right and bottom edges
+	tft.fillRectBuffer(W - 3, H - 2, 10, 10, 0x001F);
+	CHECK_EQ(countColor(tft, W, H, 0x001F), 3u * 2u);
+	CHECK_EQ(tft.fillRectBuffer(W, 0, 1, 1, 0), DisLib16::ShapeScreenBounds);
+}
+
+TEST_CASE(fast_lines_and_fillRect)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	tft.drawFastHLine(0, 0, 20, 0xFFFF);
+	tft.drawFastVLine(0, 1, 20, 0xF800);
+	CHECK_EQ(rectMismatches(tft, 0, 0, 20, 1, 0xFFFF), 0u);
+	CHECK_EQ(rectMismatches(tft, 0, 1, 1, 20, 0xF800), 0u);
+	tft.fillScreen(0x0000);
+	tft.fillRect(40, 30, 16, 8, 0x1234);
+	CHECK_EQ(rectMismatches(tft, 40, 30, 16, 8, 0x1234), 0u);
+	CHECK_EQ(countColor(tft, W, H, 0x1234), 16u * 8u);
+}
+
+TEST_CASE(fillRect_is_one_window_and_clips)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	tft.fillScreen(0x0000);
+	mock_counters_t c = tft.measure([&]{ tft.fillRect(3, 4, 100, 50, 0xF81F); });
+	CHECK_EQ(rectMismatches(tft, 3, 4, 100, 50, 0xF81F), 0u);
+	CHECK_EQ(c.addrWindows, 1u);
+	CHECK_EQ(c.pixelsWritten, 5000u);
+	CHECK_EQ(c.transactions, WINDOW_TRANSACTIONS + 1);
+	// clipped at right and bottom edges, nothing off screen
+	c = tft.measure([&]{ tft.fillRect(W - 2, H - 3, 50, 50, 0x07E0); });
+	CHECK_EQ(c.pixelsWritten, 6u);
+	CHECK_EQ(countColor(tft, W, H, 0x07E0), 6u);
+	c = tft.measure([&]{ tft.fillRect(W, 0, 4, 4, 0x07E0); tft.fillRect(0, 0, 0, 4, 0x07E0); });
+	CHECK_EQ(c.bytesSent, 0u);
+}
+
+TEST_CASE(solid_fills_stream_a_repeated_colour)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	mock_counters_t c = tft.measure([&]{ tft.fillScreen(0xF800); });
+	CHECK_EQ(countColor(tft, W, H, 0xF800), static_cast<uint32_t>(W) * H);
+	CHECK_EQ(c.addrWindows, 1u);
+	CHECK_EQ(c.transactions, WINDOW_TRANSACTIONS + 1);
+	c = tft.measure([&]{ tft.drawFastHLine(0, 3, W, 0x07E0); });
+	CHECK_EQ(c.addrWindows, 1u);
+	CHECK_EQ(rectMismatches(tft, 0, 3, W, 1, 0x07E0), 0u);
+	c = tft.measure([&]{ tft.drawFastVLine(7, 0, H, 0x001F); });
+	CHECK_EQ(c.addrWindows, 1u);
+	CHECK_EQ(rectMismatches(tft, 7, 0, 1, H, 0x001F), 0u);
+	// the kept pattern follows colour changes and survives reuse
+	tft.fillRectBuffer(20, 20, 40, 3, 0x1234);
+	tft.fillRectBuffer(20, 23, 40, 3, 0x1234);
+	tft.fillRectBuffer(20, 26, 1, 1, 0xABCD);
+	tft.fillRectBuffer(21, 26, 39, 1, 0x1234);
+	CHECK_EQ(rectMismatches(tft, 20, 20, 40, 6, 0x1234), 0u);
+	CHECK_EQ(rectMismatches(tft, 20, 26, 1, 1, 0xABCD), 0u);
+	CHECK_EQ(rectMismatches(tft, 21, 26, 39, 1, 0x1234), 0u);
+}
+
+TEST_CASE(filled_shapes_cover_their_area)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	tft.fillScreen(0x0000);
+	const int cx = 40, cy = 40, r = 18;
+	tft.fillCircle(cx, cy, r, 0xFFFF);
+	uint32_t inside = 0, outside = 0;
+	for (int y = 0; y < H; y++)
+		for (int x = 0; x < W; x++)
+		{
+			int d2 = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+			bool lit = tft.getPanelPixel(x, y) == 0xFFFF;
+			if (d2 <= (r - 1) * (r - 1) && !lit)
+				inside++;
+			if (d2 > (r + 1) * (r + 1) && lit)
+				outside++;
+		}
+	CHECK_EQ(inside, 0u);
+	CHECK_EQ(outside, 0u);
+	// triangle fill is a stack of one row spans
+	mock_counters_t c = tft.measure([&]{ tft.fillTriangle(70, 10, 120, 20, 90, 50, 0x001F); });
+	CHECK_EQ(c.addrWindows, 41u);
+	CHECK_EQ(c.pixelsWritten, static_cast<uint32_t>(countColor(tft, W, H, 0x001F)));
+	tft.fillRoundRect(60, 60, 40, 30, 6, 0xF81F);
+	CHECK_EQ(rectMismatches(tft, 66, 60, 28, 30, 0xF81F), 0u);
+	CHECK_EQ(rectMismatches(tft, 60, 66, 40, 18, 0xF81F), 0u);
+}
+
+TEST_CASE(shapes_match_between_hardware_and_software_spi)
+{
+	display16_mock_LTSM hw(W, H, true);
+	display16_mock_LTSM sw(W, H, false);
+	auto scene = [](display16_mock_LTSM& tft) {
+		tft.begin();
+		tft.fillScreen(0x0000);
+		tft.drawLine(0, 0, 100, 60, 0xFFFF);
+		tft.drawCircle(64, 48, 20, 0xF800);
+		tft.fillCircle(30, 30, 10, 0x07E0);
+		tft.fillTriangle(70, 10, 120, 20, 90, 50, 0x001F);
+		tft.drawRoundRect(5, 60, 40, 30, 6, 0xFFE0);
+		tft.fillRoundRect(60, 60, 40, 30, 6, 0xF81F);
+	};
+	scene(hw);
+	uint32_t differences = 0;
+	std::vector<uint16_t> reference;
+	for (uint16_t y = 0; y < H; y++)
+		for (uint16_t x = 0; x < W; x++)
+			reference.push_back(hw.getPanelPixel(x, y));
+	scene(sw);
+	for (uint16_t y = 0; y < H; y++)
+		for (uint16_t x = 0; x < W; x++)
+			if (sw.getPanelPixel(x, y) != reference[y * W + x])
+				differences++;
+	CHECK_EQ(differences, 0u);
+	CHECK(countColor(sw, W, H, 0xF81F) > 0u);
+}
+
+TEST_CASE(writeChar_buffered_and_pixel_modes_match_font)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	tft.setTextColor(0xFFFF, 0x0000);
+	mock_counters_t c = tft.measure([&]{ tft.writeChar(8, 8, 'A'); });
+	CHECK_EQ(glyphMismatches(tft, 8, 8, FontDefault, 'A', 0xFFFF, 0x0000), 0u);
+	CHECK_EQ(c.addrWindows, 1u);
+	CHECK_EQ(c.pixelsWritten, 64u);
+	tft.setTextCharPixelOrBuffer(true);
+	tft.setTextColor(0xF800, 0x001F);
+	c = tft.measure([&]{ tft.writeChar(20, 8, 'g'); });
+	CHECK_EQ(glyphMismatches(tft, 20, 8, FontDefault, 'g', 0xF800, 0x001F), 0u);
+	CHECK_EQ(c.addrWindows, 2u); // pixel runs of 32
+	// inverted font swaps colours
+	tft.setTextCharPixelOrBuffer(false);
+	tft.setInvertFont(true);
+	tft.writeChar(40, 8, 'Z');
+	CHECK_EQ(glyphMismatches(tft, 40, 8, FontDefault, 'Z', 0x001F, 0xF800), 0u);
+	// error codes
+	CHECK_EQ(tft.writeChar(W, 0, 'A'), DisLib16::CharScreenBounds);
+	CHECK_EQ(tft.writeChar(0, 0, 0x7F + 1), DisLib16::CharFontASCIIRange);
+}
+
+TEST_CASE(writeCharString_and_print_wrap)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	tft.setTextColor(0xFFFF, 0x0000);
+	char text[] = "Hello";
+	CHECK_EQ(tft.writeCharString(0, 0, text), DisLib16::Success);
+	for (uint8_t i = 0; i < 5; i++)
+		CHECK_EQ(glyphMismatches(tft, i * 8, 0, FontDefault, text[i], 0xFFFF, 0x0000), 0u);
+	CHECK_EQ(tft.writeCharString(0, 0, nullptr), DisLib16::CharArrayNullptr);
+	// 17 characters on a 128 wide screen, the 17th wraps to the next line
+	char longText[] = "ABCDEFGHIJKLMNOPQ";
+	tft.writeCharString(0, 16, longText);
+	CHECK_EQ(glyphMismatches(tft, 120, 16, FontDefault, 'P', 0xFFFF, 0x0000), 0u);
+	CHECK_EQ(glyphMismatches(tft, 0, 24, FontDefault, 'Q', 0xFFFF, 0x0000), 0u);
+	tft.setCursor(0, 40);
+	tft.print("x=");
+	tft.print(42);
+	CHECK_EQ(glyphMismatches(tft, 0, 40, FontDefault, 'x', 0xFFFF, 0x0000), 0u);
+	CHECK_EQ(glyphMismatches(tft, 24, 40, FontDefault, '2', 0xFFFF, 0x0000), 0u);
+}
+
+TEST_CASE(text_runs_match_single_characters)
+{
+	display16_mock_LTSM runs(W, H);
+	display16_mock_LTSM single(W, H); // pixel mode, one character at a time
+	auto scene = [](display16_mock_LTSM& t, bool pixelMode) {
+		t.begin();
+		t.fillScreen(0x0000);
+		t.setTextCharPixelOrBuffer(pixelMode);
+		t.setTextColor(0xFFE0, 0x001F);
+		char longText[] = "Status: 1234.5 V  Temp: 21.0 C  OK!";
+		t.writeCharString(20, 0, longText);
+		t.setCursor(100, 24);
+		t.print("wrapping print\nnext line");
+		t.setInvertFont(true);
+		t.setCursor(4, 56);
+		t.print("inv\x01ted"); // out of font range character is skipped
+		t.setInvertFont(false);
+		t.setTextWrap(false);
+		t.setCursor(W - 20, 72);
+		t.print("clipped");
+		t.setTextWrap(true);
+	};
+	mock_counters_t c = runs.measure([&]{ scene(runs, false); });
+	scene(single, true);
+	CHECK_EQ(panelDifferences(runs, single, W, H), 0u);
+	CHECK(runs.getWriteError() != 0);
+	CHECK_EQ(runs.getWriteError(), single.getWriteError());
+	CHECK(c.addrWindows < 16u);
+	CHECK_EQ(runs.getPanelPixel(W - 1, 72 + 7), single.getPanelPixel(W - 1, 72 + 7));
+	// a 16 character status line is one window
+	char status[] = "Volts:  12.5 V  ";
+	c = runs.measure([&]{ runs.writeCharString(0, 88, status); });
+	CHECK_EQ(c.addrWindows, 1u);
+	CHECK_EQ(c.pixelsWritten, 16u * 64u);
+	// errors as before
+	char bad[] = "ab\x01c";
+	CHECK_EQ(runs.writeCharString(0, 0, bad), DisLib16::CharFontASCIIRange);
+	char low[] = "abc";
+	CHECK_EQ(runs.writeCharString(0, H, low), DisLib16::CharScreenBounds);
+}
+
+TEST_CASE(bitmaps_render_to_panel)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	// 16x2 bi-colour bitmap
+	static const uint8_t mono[4] = {0xF0, 0x0F, 0x80, 0x01};
+	CHECK_EQ(tft.drawBitmap(0, 0, 16, 2, 0xFFFF, 0x0000, mono), DisLib16::Success);
+	CHECK_EQ(tft.getPanelPixel(0, 0), 0xFFFF);
+	CHECK_EQ(tft.getPanelPixel(4, 0), 0x0000);
+	CHECK_EQ(tft.getPanelPixel(15, 0), 0xFFFF);
+	CHECK_EQ(tft.getPanelPixel(1, 1), 0x0000);
+	CHECK_EQ(tft.getPanelPixel(15, 1), 0xFFFF);
+	CHECK_EQ(tft.drawBitmap(0, 0, 12, 2, 0xFFFF, 0, mono), DisLib16::BitmapHorizontalSize);
+	// 2x1 RGB332 bitmap
+	static const uint8_t rgb332[2] = {0xE0, 0x03};
+	CHECK_EQ(tft.drawBitmap8Data(0, 4, rgb332, 2, 1), DisLib16::Success);
+	CHECK_EQ(tft.getPanelPixel(0, 4), 0xF800);
+	CHECK_EQ(tft.getPanelPixel(1, 4), 0x001F);
+	// 3x2 RGB565 bitmap, MSB first
+	static const uint8_t rgb565[12] = {0xF8,0x00, 0x07,0xE0, 0x00,0x1F, 0x12,0x34, 0xAB,0xCD, 0xFF,0xFF};
+	mock_counters_t c = tft.measure([&]{ tft.drawBitmap16Data(10, 10, rgb565, 3, 2); });
+	CHECK_EQ(tft.getPanelPixel(10, 10), 0xF800);
+	CHECK_EQ(tft.getPanelPixel(12, 10), 0x001F);
+	CHECK_EQ(tft.getPanelPixel(11, 11), 0xABCD);
+	CHECK_EQ(c.pixelsWritten, 6u);
+	CHECK_EQ(tft.drawBitmap16Data(0, 0, nullptr, 3, 2), DisLib16::BitmapDataEmpty);
+	CHECK_EQ(tft.drawBitmap16Data(W, 0, rgb565, 3, 2), DisLib16::BitmapScreenBounds);
+}
+
+TEST_CASE(bitmap8_palette_lookup)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	// every RRRGGGBB value against the channel scaling of the conversion
+	static uint8_t all[256];
+	for (int i = 0; i < 256; i++)
+		all[i] = static_cast<uint8_t>(i);
+	CHECK_EQ(tft.drawBitmap8Data(0, 0, all, 16, 16), DisLib16::Success);
+	uint32_t errors = 0;
+	for (int i = 0; i < 256; i++)
+	{
+		const int r = (((i >> 5) & 7) * 255 / 7) >> 3, g = (((i >> 2) & 7) * 255 / 7) >> 2, b = ((i & 3) * 255 / 3) >> 3;
+		errors += tft.getPanelPixel(i % 16, i / 16) != ((r << 11) | (g << 5) | b);
+	}
+	CHECK_EQ(errors, 0u);
+	CHECK_EQ(tft.getPanelPixel(15, 15), 0xFFFF);
+	// a user palette, grey ramp, then back to the default
+	static uint16_t grey[256];
+	for (int i = 0; i < 256; i++)
+		grey[i] = static_cast<uint16_t>(((i >> 3) << 11) | ((i >> 2) << 5) | (i >> 3));
+	const uint16_t *rgb332 = tft.getBitmap8Palette();
+	tft.setBitmap8Palette(grey);
+	CHECK(tft.getBitmap8Palette() == grey);
+	mock_counters_t c = tft.measure([&]{ tft.drawBitmap8Data(20, 0, all, 16, 16); });
+	CHECK_EQ(c.pixelsWritten, 256u);
+	CHECK_EQ(c.addrWindows, 1u);
+	errors = 0;
+	for (int i = 0; i < 256; i++)
+		errors += tft.getPanelPixel(20 + i % 16, i / 16) != grey[i];
+	CHECK_EQ(errors, 0u);
+	tft.setBitmap8Palette(nullptr);
+	CHECK(tft.getBitmap8Palette() == rgb332);
+	tft.drawBitmap8Data(20, 0, all, 16, 16);
+	CHECK_EQ(tft.getPanelPixel(20 + 3, 0), tft.getPanelPixel(3, 0));
+}
+
+TEST_CASE(sprite_skips_transparent_pixels)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	// 4x1 sprite, 0x0000 is transparent
+	static const uint8_t sprite[8] = {0x00,0x00, 0xF8,0x00, 0xF8,0x00, 0x00,0x00};
+	mock_counters_t c = tft.measure([&]{ tft.drawSpriteData(20, 20, sprite, 4, 1, 0x0000, false); });
+	CHECK_EQ(c.pixelsWritten, 2u);
+	CHECK_EQ(countColor(tft, W, H, 0xF800), 2u);
+	CHECK_EQ(tft.getPanelPixel(21, 20), 0xF800);
+	CHECK_EQ(tft.getPanelPixel(22, 20), 0xF800);
+	c = tft.measure([&]{ tft.drawSpriteData(20, 30, sprite, 4, 1, 0x0000, true); });
+	CHECK_EQ(c.pixelsWritten, 4u);
+	// clipped, the second row starts at its source stride
+	static const uint8_t square[8] = {0xF8,0x00, 0x07,0xE0, 0x00,0x1F, 0xFF,0xFF};
+	tft.drawSpriteData(W - 1, 40, square, 2, 2, 0x0000, false);
+	CHECK_EQ(tft.getPanelPixel(W - 1, 40), 0xF800);
+	CHECK_EQ(tft.getPanelPixel(W - 1, 41), 0x001F);
+}
+
+TEST_CASE(sprite_runs_send_opaque_runs)
+{
+	// 12x5 sprite, 0x0001 transparent: a ring, an empty row, a full row
+	static uint8_t sprite[12 * 5 * 2];
+	const char *rows[5] = {"..XXXX..XX..", ".X....X....X", "............", "XXXXXXXXXXXX", "X.X.X.X.X.X."};
+	uint32_t opaque = 0, runCount = 0;
+	for (int j = 0; j < 5; j++)
+		for (int i = 0; i < 12; i++)
+		{
+			const uint16_t color = (rows[j][i] == 'X') ? static_cast<uint16_t>(0xF800 + j * 12 + i) : 0x0001;
+			sprite[(j * 12 + i) * 2] = color >> 8;
+			sprite[(j * 12 + i) * 2 + 1] = color & 0xFF;
+			opaque += (rows[j][i] == 'X');
+			runCount += (rows[j][i] == 'X' && (i == 0 || rows[j][i - 1] != 'X'));
+		}
+	display16_mock_LTSM tft(W, H), ref(W, H);
+	tft.begin();
+	ref.begin();
+	uint32_t used = 0;
+	CHECK_EQ(tft.buildSpriteRuns(sprite, 12, 5, 0x0001, nullptr, 0, used), DisLib16::Success);
+	CHECK_EQ(used, 5u + runCount * 2 + 5 * 2);
+	std::vector<uint8_t> runs(used);
+	CHECK_EQ(tft.buildSpriteRuns(sprite, 12, 5, 0x0001, runs.data(), 4, used), DisLib16::BufferSize);
+	CHECK_EQ(tft.buildSpriteRuns(sprite, 12, 5, 0x0001, runs.data(), used, used), DisLib16::Success);
+	const std::vector<uint8_t> head = {0x53, 0, 12, 0, 5, 2, 4, 2, 2, 0, 0};
+	CHECK(std::vector<uint8_t>(runs.begin(), runs.begin() + 11) == head);
+	mock_counters_t c = tft.measure([&]{ CHECK_EQ(tft.drawSpriteRuns(10, 20, sprite, runs.data()), DisLib16::Success); });
+	CHECK_EQ(c.pixelsWritten, opaque);
+	CHECK_EQ(c.addrWindows, runCount);
+	// clipped at the right and bottom edges
+	tft.drawSpriteRuns(W - 5, H - 4, sprite, runs.data());
+	for (int j = 0; j < 5; j++)
+		for (int i = 0; i < 12; i++)
+			if (rows[j][i] == 'X')
+			{
+				const uint16_t color = static_cast<uint16_t>(0xF800 + j * 12 + i);
+				ref.drawPixel(10 + i, 20 + j, color);
+				ref.drawPixel(W - 5 + i, H - 4 + j, color);
+			}
+	CHECK_EQ(panelDifferences(tft, ref, W, H), 0u);
+	// long skips and runs are split
+	static uint8_t wide[600 * 2];
+	for (int i = 0; i < 600; i++)
+		wide[i * 2 + 1] = (i >= 300) ? 0x01 : 0x00; // opaque 0-299, then 300 transparent, 0x0001
+	tft.buildSpriteRuns(wide, 600, 1, 0x0001, nullptr, 0, used);
+	CHECK_EQ(used, 5u + 4u + 2u);
+	tft.buildSpriteRuns(wide, 600, 1, 0x0000, nullptr, 0, used);
+	CHECK_EQ(used, 5u + 2u + 4u + 2u);
+	// errors
+	CHECK_EQ(tft.buildSpriteRuns(nullptr, 12, 5, 0x0001, nullptr, 0, used), DisLib16::BitmapDataEmpty);
+	CHECK_EQ(tft.buildSpriteRuns(sprite, 0, 5, 0x0001, nullptr, 0, used), DisLib16::BitmapSize);
+	CHECK_EQ(tft.drawSpriteRuns(0, 0, sprite, nullptr), DisLib16::BitmapDataEmpty);
+	CHECK_EQ(tft.drawSpriteRuns(W, 0, sprite, runs.data()), DisLib16::BitmapScreenBounds);
+	runs[0] = 0x51;
+	CHECK_EQ(tft.drawSpriteRuns(0, 0, sprite, runs.data()), DisLib16::BitmapFormat);
+}
+
+TEST_CASE(scratch_arena_chunks_text_and_bitmaps)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	tft.fillScreen(0x0000);
+	static const uint8_t mono[8] = {0xF0, 0x0F, 0xAA, 0x55, 0xFF, 0x00, 0x81, 0x18};
+	static uint8_t rgb565[5 * 3 * 2];
+	for (uint16_t i = 0; i < 15; i++)
+	{
+		rgb565[2 * i] = 0x10 + i;
+		rgb565[2 * i + 1] = 0x80 + i;
+	}
+	uint8_t arena[10];
+	CHECK_EQ(tft.setScratchBuffer(arena, 1), DisLib16::BufferSize);
+	for (uint8_t pass = 0; pass < 2; pass++)
+	{
+		// pass 0 with a 10 byte arena, pass 1 with the default
+		if (pass == 0)
+			CHECK_EQ(tft.setScratchBuffer(arena, sizeof(arena)), DisLib16::Success);
+		else
+			CHECK_EQ(tft.setScratchBuffer(nullptr, 0), DisLib16::Success);
+		tft.resetScratchHighWater();
+		tft.setTextColor(0xFFFF, 0x001F);
+		mock_counters_t c = tft.measure([&]{ tft.writeChar(10, 10, 'M'); });
+		CHECK_EQ(glyphMismatches(tft, 10, 10, FontDefault, 'M', 0xFFFF, 0x001F), 0u);
+		CHECK_EQ(c.addrWindows, 1u);
+		CHECK_EQ(tft.getScratchHighWater(), 8u * 8u * 2u);
+		c = tft.measure([&]{ tft.drawBitmap(30, 10, 16, 4, 0xF800, 0x0000, mono); });
+		CHECK_EQ(c.addrWindows, 1u);
+		CHECK_EQ(tft.getPanelPixel(30, 10), 0xF800);
+		CHECK_EQ(tft.getPanelPixel(34, 10), 0x0000);
+		CHECK_EQ(tft.getPanelPixel(45, 13), 0x0000);
+		CHECK_EQ(tft.getPanelPixel(42, 13), 0xF800);
+		tft.drawBitmap16Data(50, 10, rgb565, 5, 3);
+		CHECK_EQ(tft.getPanelPixel(50, 10), 0x1080);
+		CHECK_EQ(tft.getPanelPixel(54, 12), 0x1E8E);
+	}
+	CHECK_EQ(tft.getScratchSize(), static_cast<uint32_t>(dislib16_SCRATCH_BYTES));
+}
+
+TEST_CASE(clipped_bitmaps_keep_source_rows)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	tft.fillScreen(0x0000);
+	// 4x2 bitmaps with 2 columns off screen, rows must not shift
+	static const uint8_t rgb332[8] = {0xE0, 0x1C, 0x03, 0x03, 0xFF, 0x92, 0x03, 0x03};
+	tft.drawBitmap8Data(W - 2, 0, rgb332, 4, 2);
+	CHECK_EQ(tft.getPanelPixel(W - 2, 1), 0xFFFF);
+	static const uint8_t rgb565[16] = {0xF8, 0x00, 0x07, 0xE0, 0, 1, 0, 1, 0x00, 0x1F, 0xFF, 0xFF, 0, 1, 0, 1};
+	tft.drawBitmap16Data(W - 2, 4, rgb565, 4, 2);
+	CHECK_EQ(tft.getPanelPixel(W - 2, 5), 0x001F);
+	CHECK_EQ(tft.getPanelPixel(W - 1, 5), 0xFFFF);
+}
+
+TEST_CASE(spi_block_transfer_preserves_source)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	uint8_t pixels[300];
+	for (uint16_t i = 0; i < sizeof(pixels); i++)
+		pixels[i] = static_cast<uint8_t>(i);
+	tft.setAddrWindow(0, 0, W - 1, H - 1);
+	mock_counters_t c = tft.measure([&]{ tft.spiWriteDataBuffer(pixels, sizeof(pixels)); });
+	CHECK_EQ(c.dataBytes, static_cast<uint32_t>(sizeof(pixels)));
+	CHECK_EQ(c.transactions, 1u);
+	CHECK_EQ(tft.getPanelPixel(1, 0), 0x0203);
+	CHECK_EQ(tft.getPanelPixel(149 - W, 1), 0x2A2B); // bytes 298 and 299, wrapped to row 1
+	uint32_t changed = 0;
+	for (uint16_t i = 0; i < sizeof(pixels); i++)
+		if (pixels[i] != static_cast<uint8_t>(i)) changed++;
+	CHECK_EQ(changed, 0u);
+#ifdef dislib16_SPI_BYTE_TRANSFER_ENABLE
+	CHECK_EQ(c.spiCalls, static_cast<uint32_t>(sizeof(pixels)));
+#else
+	// block transfers through the copy buffer, not one call per byte
+	CHECK(c.spiCalls <= 5u);
+	// scratch write goes in place, one call
+	c = tft.measure([&]{ tft.spiWriteScratchBuffer(pixels, sizeof(pixels)); });
+	CHECK_EQ(c.spiCalls, 1u);
+	CHECK_EQ(c.dataBytes, static_cast<uint32_t>(sizeof(pixels)));
+#endif
+}
+
+TEST_CASE(pixel_runs_share_address_windows)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	tft.fillScreen(0x0000);
+	tft.resetPixelWindowsSaved();
+	// horizontal line, runs of up to 32 pixels
+	mock_counters_t c = tft.measure([&]{ tft.drawLine(0, 5, 49, 5, 0xFFFF); });
+	CHECK_EQ(rectMismatches(tft, 0, 5, 50, 1, 0xFFFF), 0u);
+	CHECK_EQ(c.addrWindows, 2u);
+	CHECK_EQ(tft.getPixelWindowsSaved(), 48u);
+	// vertical line, a window one column wide
+	c = tft.measure([&]{ tft.drawLine(60, 10, 60, 29, 0xF800); });
+	CHECK_EQ(rectMismatches(tft, 60, 10, 1, 20, 0xF800), 0u);
+	CHECK_EQ(c.addrWindows, 1u);
+	// user batch of a raster ordered block, wraps to the next row of the window
+	tft.resetPixelWindowsSaved();
+	c = tft.measure([&]{
+		tft.beginPixelBatch();
+		for (uint16_t j = 0; j < 4; j++)
+			for (uint16_t i = 0; i < 5; i++)
+				tft.drawPixel(70 + i, 40 + j, 0x07E0);
+		tft.endPixelBatch();
+	});
+	CHECK_EQ(rectMismatches(tft, 70, 40, 5, 4, 0x07E0), 0u);
+	CHECK_EQ(c.addrWindows, 1u);
+	CHECK_EQ(c.pixelsWritten, 20u);
+	CHECK_EQ(tft.getPixelWindowsSaved(), 19u);
+	// other traffic inside a batch sends the pending run first, order kept
+	tft.beginPixelBatch();
+	tft.drawPixel(90, 50, 0xF800);
+	tft.drawPixel(91, 50, 0xF800);
+	tft.fillRectBuffer(91, 50, 2, 1, 0x001F);
+	tft.drawPixel(92, 50, 0xFFE0);
+	tft.endPixelBatch();
+	CHECK_EQ(tft.getPanelPixel(90, 50), 0xF800);
+	CHECK_EQ(tft.getPanelPixel(91, 50), 0x001F);
+	CHECK_EQ(tft.getPanelPixel(92, 50), 0xFFE0);
+	// outside a batch each pixel is sent at once
+	c = tft.measure([&]{ tft.drawPixel(0, 0, 0x1234); tft.drawPixel(1, 0, 0x1234); });
+	CHECK_EQ(c.addrWindows, 2u);
+	CHECK_EQ(tft.getPanelPixel(1, 0), 0x1234);
+	// pixel mode text, one window per 32 pixels of the glyph
+	tft.setTextCharPixelOrBuffer(true);
+	tft.setTextColor(0xFFFF, 0x0000);
+	c = tft.measure([&]{ tft.writeChar(16, 60, 'R'); });
+	CHECK_EQ(glyphMismatches(tft, 16, 60, FontDefault, 'R', 0xFFFF, 0x0000), 0u);
+	CHECK(c.addrWindows <= (8u * 8u) / 32u);
+}
+
+TEST_CASE(proportional_font_format)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	CHECK_EQ(tft.getFontType(), display_Fonts::FontTypeFixed);
+	static const uint8_t unknown[6] = {0x00, 0x7F, 8, 0x20, 0, 0};
+	CHECK_EQ(tft.setFont(unknown), DisLib16::WrongFont);
+	CHECK_EQ(tft.getFontType(), display_Fonts::FontTypeFixed);
+	const std::vector<uint8_t> prop = makeProportionalFont(FontDefault);
+	CHECK_EQ(tft.setFont(prop.data()), DisLib16::Success);
+	CHECK_EQ(tft.getFontType(), display_Fonts::FontTypeProportional);
+	// large fonts get smaller without the blank columns
+	const std::vector<uint8_t> big = makeProportionalFont(FontGroTesk);
+	CHECK(big.size() < sizeof(FontGroTesk));
+	tft.setFont(FontDefault);
+	CHECK_EQ(tft.getFontType(), display_Fonts::FontTypeFixed);
+}
+
+TEST_CASE(proportional_writeChar_sends_its_cell)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	tft.fillScreen(0x0000);
+	const std::vector<uint8_t> prop = makeProportionalFont(FontDefault);
+	tft.setFont(prop.data());
+	tft.setTextColor(0xFFFF, 0x001F);
+	mock_counters_t c = tft.measure([&]{ tft.writeChar(8, 8, 'i'); });
+	CHECK_EQ(c.addrWindows, 1u);
+	CHECK_EQ(c.pixelsWritten, propAdvance(prop, 'i') * 8u);
+	CHECK(propAdvance(prop, 'i') < 8u);
+	CHECK_EQ(propGlyphMismatches(tft, 8, 8, prop, 'i', 0xFFFF, 0x001F), 0u);
+	tft.setTextCharPixelOrBuffer(true);
+	tft.writeChar(20, 8, 'W');
+	CHECK_EQ(propGlyphMismatches(tft, 20, 8, prop, 'W', 0xFFFF, 0x001F), 0u);
+	tft.setTextCharPixelOrBuffer(false);
+	tft.setInvertFont(true);
+	tft.writeChar(40, 8, 'g');
+	CHECK_EQ(propGlyphMismatches(tft, 40, 8, prop, 'g', 0x001F, 0xFFFF), 0u);
+	// clipped at the right edge, nothing drawn past it
+	c = tft.measure([&]{ tft.writeChar(W - 2, 20, 'W'); });
+	CHECK_EQ(c.pixelsWritten, 2u * 8u);
+	CHECK_EQ(tft.writeChar(0, 0, 0x7F + 1), DisLib16::CharFontASCIIRange);
+}
+
+TEST_CASE(proportional_text_runs)
+{
+	const std::vector<uint8_t> prop = makeProportionalFont(FontDefault);
+	display16_mock_LTSM runs(W, H);
+	display16_mock_LTSM single(W, H); // pixel mode, one character at a time
+	auto scene = [&](display16_mock_LTSM& t, bool pixelMode) {
+		t.begin();
+		t.fillScreen(0x0000);
+		t.setFont(prop.data());
+		t.setTextCharPixelOrBuffer(pixelMode);
+		t.setTextColor(0xFFE0, 0x001F);
+		char longText[] = "Illuminated windows, a long proportional line wraps";
+		t.writeCharString(10, 0, longText);
+		t.setCursor(60, 32);
+		t.print("wrapping print with words\nnext");
+		t.setTextWrap(false);
+		t.setCursor(W - 20, 72);
+		t.print("clipped");
+		t.setTextWrap(true);
+	};
+	mock_counters_t c = runs.measure([&]{ scene(runs, false); });
+	scene(single, true);
+	CHECK_EQ(panelDifferences(runs, single, W, H), 0u);
+	CHECK(c.addrWindows < 16u);
+	// cells follow each other by their advance, one window for the line
+	char text[] = "Hill 11";
+	c = runs.measure([&]{ runs.writeCharString(0, 88, text); });
+	CHECK_EQ(c.addrWindows, 1u);
+	uint16_t x = 0;
+	for (uint8_t i = 0; text[i] != '\0'; i++)
+	{
+		CHECK_EQ(propGlyphMismatches(runs, x, 88, prop, text[i], 0xFFE0, 0x001F), 0u);
+		x += propAdvance(prop, text[i]);
+	}
+	CHECK_EQ(c.pixelsWritten, x * 8u);
+	CHECK(x < 7u * 8u); // fewer pixels than the fixed cells
+	// a line that does not fit wraps before the character that would pass the edge
+	char wide[] = "WWWWWWWWWWWWWWWWWWWW";
+	runs.writeCharString(0, 0, wide);
+	const uint8_t perLine = W / propAdvance(prop, 'W');
+	CHECK_EQ(propGlyphMismatches(runs, 0, 8, prop, 'W', 0xFFE0, 0x001F), 0u);
+	CHECK_EQ(propGlyphMismatches(runs, (perLine - 1) * propAdvance(prop, 'W'), 0, prop, 'W', 0xFFE0, 0x001F), 0u);
+}
+
+TEST_CASE(compressed_fonts_are_smaller)
+{
+	const std::vector<uint8_t> big = makeExtendedFont(FontGroTeskBig, 2, false);
+	const std::vector<uint8_t> seg = makeExtendedFont(FontSevenSeg, 2, false);
+	CHECK(big.size() * 2 < sizeof(FontGroTeskBig));
+	CHECK(seg.size() * 2 < sizeof(FontSevenSeg));
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	CHECK_EQ(tft.setFont(big.data()), DisLib16::Success);
+	CHECK_EQ(tft.getFontType(), display_Fonts::FontTypeCompressed);
+}
+
+TEST_CASE(compressed_font_matches_uncompressed)
+{
+	const std::vector<uint8_t> seg = makeExtendedFont(FontSevenSeg, 2, false);
+	const std::vector<uint8_t> propRle = makeExtendedFont(FontDefault, 2, true);
+	const std::vector<uint8_t> prop = makeProportionalFont(FontDefault);
+	for (int pixelMode = 0; pixelMode < 2; pixelMode++)
+	{
+		display16_mock_LTSM plain(W, H), packed(W, H);
+		plain.begin();
+		packed.begin();
+		auto scene = [&](display16_mock_LTSM& t, const uint8_t *big, const uint8_t *small) {
+			t.fillScreen(0x0000);
+			t.setTextCharPixelOrBuffer(pixelMode != 0);
+			t.setTextColor(0xFFE0, 0x001F);
+			t.setFont(big);
+			char digits[] = "1:4";
+			t.writeCharString(4, 0, digits);
+			t.writeChar(W - 10, 0, '8'); // clipped at the right edge
+			t.setFont(small);
+			t.setCursor(0, 56);
+			t.print("Run length, wraps to the next line");
+			t.setInvertFont(true);
+			t.writeChar(70, H - 4, 'g'); // clipped at the bottom edge
+			t.setInvertFont(false);
+		};
+		mock_counters_t a = plain.measure([&]{ scene(plain, FontSevenSeg, prop.data()); });
+		mock_counters_t b = packed.measure([&]{ scene(packed, seg.data(), propRle.data()); });
+		CHECK_EQ(panelDifferences(plain, packed, W, H), 0u);
+		CHECK(b.pixelsWritten <= a.pixelsWritten); // fixed fonts are not clipped at the edge
+	}
+	// one window per character, no more SPI traffic than the uncompressed font
+	display16_mock_LTSM plain(W, H), packed(W, H);
+	plain.begin();
+	packed.begin();
+	plain.setFont(FontSevenSeg);
+	packed.setFont(seg.data());
+	mock_counters_t a = plain.measure([&]{ plain.writeChar(0, 0, '8'); });
+	mock_counters_t b = packed.measure([&]{ packed.writeChar(0, 0, '8'); });
+	CHECK_EQ(b.addrWindows, 1u);
+	CHECK_EQ(b.dataBytes, a.dataBytes);
+	CHECK(b.spiCalls <= a.spiCalls);
+	CHECK_EQ(panelDifferences(plain, packed, W, H), 0u);
+}
+
+TEST_CASE(antialiased_font_blends_through_ramp)
+{
+	for (uint8_t bpp : {2, 4})
+	{
+		const std::vector<uint8_t> aa = makeAntiAliasedFont(FontDefault, bpp);
+		display16_mock_LTSM tft(W, H);
+		tft.begin();
+		tft.fillScreen(0x0000);
+		CHECK_EQ(tft.setFont(aa.data()), DisLib16::Success);
+		CHECK_EQ(tft.getFontType(), bpp == 4 ? display_Fonts::FontTypeAntiAlias4 : display_Fonts::FontTypeAntiAlias2);
+		tft.setTextColor(0xFFE0, 0x001F);
+		mock_counters_t c = tft.measure([&]{ tft.writeChar(0, 0, 'A'); });
+		CHECK_EQ(c.addrWindows, 1u);
+		CHECK_EQ(c.pixelsWritten, 64u);
+		CHECK_EQ(aaGlyphMismatches(tft, 0, 0, aa, 'A', 0xFFE0, 0x001F), 0u);
+		// edge pixels are blends, neither text colour
+		uint32_t blended = 0;
+		for (uint16_t cy = 0; cy < 8; cy++)
+			for (uint16_t cx = 0; cx < 8; cx++)
+			{
+				const uint16_t color = tft.getPanelPixel(cx, cy);
+				blended += (color != 0xFFE0 && color != 0x001F);
+			}
+		CHECK(blended > 0u);
+		// new colour pair, new ramp
+		tft.setTextColor(0xF800, 0xFFFF);
+		tft.writeChar(8, 0, 'B');
+		CHECK_EQ(aaGlyphMismatches(tft, 8, 0, aa, 'B', 0xF800, 0xFFFF), 0u);
+		tft.setInvertFont(true);
+		tft.writeChar(16, 0, 'C');
+		CHECK_EQ(aaGlyphMismatches(tft, 16, 0, aa, 'C', 0xFFFF, 0xF800), 0u);
+		tft.setInvertFont(false);
+		tft.setTextCharPixelOrBuffer(true);
+		tft.writeChar(24, 0, 'D');
+		CHECK_EQ(aaGlyphMismatches(tft, 24, 0, aa, 'D', 0xF800, 0xFFFF), 0u);
+		tft.setTextCharPixelOrBuffer(false);
+		// a text run, one window, same cells as single characters
+		char text[] = "Blend";
+		c = tft.measure([&]{ tft.writeCharString(0, 16, text); });
+		CHECK_EQ(c.addrWindows, 1u);
+		for (uint16_t i = 0; text[i] != '\0'; i++)
+			CHECK_EQ(aaGlyphMismatches(tft, i * 8, 16, aa, text[i], 0xF800, 0xFFFF), 0u);
+		tft.setFont(FontDefault);
+	}
+	CHECK_EQ(blend565(0xFFFF, 0x0000, 1, 3), 0x52AA); // r 10 g 21 b 10
+}
+
+TEST_CASE(text_scale_setting)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	CHECK_EQ(tft.getTextScale(), 1u);
+	CHECK_EQ(tft.setTextScale(0), DisLib16::GenericError);
+	CHECK_EQ(tft.setTextScale(9), DisLib16::GenericError);
+	CHECK_EQ(tft.getTextScale(), 1u);
+	CHECK_EQ(tft.setTextScale(8), DisLib16::Success);
+	CHECK_EQ(tft.getTextScale(), 8u);
+}
+
+TEST_CASE(scaled_writeChar_expands_each_pixel)
+{
+	display16_mock_LTSM small(W, H), big(W, H);
+	small.begin();
+	big.begin();
+	small.setTextColor(0xFFE0, 0x001F);
+	big.setTextColor(0xFFE0, 0x001F);
+	small.writeChar(0, 0, 'A');
+	small.writeChar(8, 0, 'g');
+	CHECK_EQ(big.setTextScale(3), DisLib16::Success);
+	mock_counters_t c = big.measure([&]{ big.writeChar(0, 0, 'A'); });
+	CHECK_EQ(c.addrWindows, 1u);
+	CHECK_EQ(c.pixelsWritten, 24u * 24u);
+	CHECK_EQ(scaledCellMismatches(small, 0, 0, big, 0, 0, 8, 8, 3), 0u);
+	big.setTextCharPixelOrBuffer(true);
+	big.writeChar(24, 0, 'g');
+	CHECK_EQ(scaledCellMismatches(small, 8, 0, big, 24, 0, 8, 8, 3), 0u);
+	big.setTextCharPixelOrBuffer(false);
+	// clipped at the right and bottom edges
+	c = big.measure([&]{ big.writeChar(W - 10, H - 5, 'A'); });
+	CHECK_EQ(c.pixelsWritten, 10u * 5u);
+	CHECK_EQ(scaledCellMismatches(small, 0, 0, big, W - 10, H - 5, 3, 1, 3), 0u);
+	// largest scale, the band row is wider than a small scratch arena
+	big.setTextScale(8);
+	big.writeChar(0, 0, 'A');
+	CHECK_EQ(scaledCellMismatches(small, 0, 0, big, 0, 0, 8, 8, 8), 0u);
+}
+
+TEST_CASE(scaled_text_all_font_types)
+{
+	const std::vector<uint8_t> prop = makeProportionalFont(FontDefault);
+	const std::vector<uint8_t> packed = makeExtendedFont(FontDefault, 2, true);
+	const std::vector<uint8_t> aa = makeAntiAliasedFont(FontDefault, 4);
+	for (const std::vector<uint8_t> *font : {&prop, &packed, &aa})
+	{
+		display16_mock_LTSM small(W, H), big(W, H);
+		small.begin();
+		big.begin();
+		small.setFont(font->data());
+		big.setFont(font->data());
+		small.setTextColor(0xFFE0, 0x001F);
+		big.setTextColor(0xFFE0, 0x001F);
+		char text[] = "Wig";
+		small.writeCharString(0, 0, text);
+		big.setTextScale(2);
+		big.writeCharString(0, 0, text);
+		uint16_t x = 0;
+		for (int i = 0; text[i] != '\0'; i++)
+		{
+			const uint8_t advance = propAdvance(*font, text[i]);
+			CHECK_EQ(scaledCellMismatches(small, x, 0, big, x * 2, 0, advance, 8, 2), 0u);
+			x += advance;
+		}
+	}
+}
+
+TEST_CASE(scaled_print_advances_and_wraps)
+{
+	display16_mock_LTSM small(W, H), big(W, H);
+	small.begin();
+	big.begin();
+	small.fillScreen(0x0000);
+	big.fillScreen(0x0000);
+	small.setTextColor(0xFFFF, 0x0000);
+	big.setTextColor(0xFFFF, 0x0000);
+	for (char c : {'A', 'B', 'C', 'D'})
+		small.writeChar((c - 'A') * 8, 0, c);
+	big.setTextScale(4);
+	big.setCursor(0, 0);
+	big.print("AB\nCD"); // 32 pixels per character, second line at 32
+	CHECK_EQ(scaledCellMismatches(small, 0, 0, big, 0, 0, 16, 8, 4), 0u);
+	CHECK_EQ(scaledCellMismatches(small, 16, 0, big, 0, 32, 16, 8, 4), 0u);
+	// fixed fonts wrap once the next cell does not fit, 4 cells of 32 fill the width
+	big.fillScreen(0x0000);
+	big.setCursor(0, 0);
+	big.print("ABCDA");
+	CHECK_EQ(scaledCellMismatches(small, 0, 0, big, 0, 32, 8, 8, 4), 0u);
+	char text[] = "ABCDA";
+	big.fillScreen(0x0000);
+	big.writeCharString(0, 0, text);
+	CHECK_EQ(scaledCellMismatches(small, 0, 0, big, 0, 32, 8, 8, 4), 0u);
+}
+
+TEST_CASE(text_bounds_measure_without_drawing)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	uint16_t w = 1, h = 1;
+	mock_counters_t c = tft.measure([&]{ CHECK_EQ(tft.getTextBounds("Hello", w, h), DisLib16::Success); });
+	CHECK_EQ(c.bytesSent, 0u);
+	CHECK_EQ(w, 40u);
+	CHECK_EQ(h, 8u);
+	tft.getTextBounds("ab\nabcd", w, h);
+	CHECK_EQ(w, 32u);
+	CHECK_EQ(h, 16u);
+	tft.getTextBounds("", w, h);
+	CHECK_EQ(w, 0u);
+	CHECK_EQ(h, 0u);
+	CHECK_EQ(tft.getTextBounds(nullptr, w, h), DisLib16::CharArrayNullptr);
+	tft.setTextScale(2);
+	tft.getTextBounds("ab\nabcd", w, h);
+	CHECK_EQ(w, 64u);
+	CHECK_EQ(h, 32u);
+	tft.setTextScale(1);
+	const std::vector<uint8_t> prop = makeProportionalFont(FontDefault);
+	tft.setFont(prop.data());
+	tft.getTextBounds("Wig", w, h);
+	CHECK_EQ(w, propAdvance(prop, 'W') + propAdvance(prop, 'i') + propAdvance(prop, 'g'));
+	CHECK_EQ(h, 8u);
+	tft.setFont(FontDefault);
+}
+
+TEST_CASE(text_box_aligns_and_fills_only_the_box)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	tft.fillScreen(0xF800);
+	tft.setTextColor(0xFFFF, 0x0000);
+	uint16_t drawn = 0;
+	mock_counters_t c = tft.measure([&]{
+		CHECK_EQ(tft.drawTextBox(10, 10, 60, 20, "Hi", display16_graphics_LTSM::TextAlignCentre, &drawn), DisLib16::Success); });
+	CHECK_EQ(drawn, 2u);
+	CHECK_EQ(c.pixelsWritten, 60u * 20u); // each box pixel once
+	CHECK_EQ(glyphMismatches(tft, 32, 10, FontDefault, 'H', 0xFFFF, 0x0000), 0u);
+	CHECK_EQ(glyphMismatches(tft, 40, 10, FontDefault, 'i', 0xFFFF, 0x0000), 0u);
+	CHECK_EQ(rectMismatches(tft, 10, 18, 60, 12, 0x0000), 0u);
+	CHECK_EQ(countColor(tft, W, H, 0xF800), static_cast<uint32_t>(W) * H - 60u * 20u);
+	// a shorter value redrawn in place leaves nothing of the old one
+	tft.drawTextBox(10, 10, 60, 20, "7", display16_graphics_LTSM::TextAlignRight);
+	CHECK_EQ(glyphMismatches(tft, 62, 10, FontDefault, '7', 0xFFFF, 0x0000), 0u);
+	CHECK_EQ(rectMismatches(tft, 10, 10, 52, 20, 0x0000), 0u);
+	tft.drawTextBox(10, 10, 60, 20, "L", display16_graphics_LTSM::TextAlignLeft);
+	CHECK_EQ(glyphMismatches(tft, 10, 10, FontDefault, 'L', 0xFFFF, 0x0000), 0u);
+	CHECK_EQ(tft.drawTextBox(W, 0, 10, 10, "x", display16_graphics_LTSM::TextAlignLeft), DisLib16::CharScreenBounds);
+	CHECK_EQ(tft.drawTextBox(0, 0, 10, 10, nullptr, display16_graphics_LTSM::TextAlignLeft), DisLib16::CharArrayNullptr);
+}
+
+TEST_CASE(text_box_clips_and_reports_truncation)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	tft.fillScreen(0xF800);
+	tft.setTextColor(0xFFFF, 0x0000);
+	uint16_t drawn = 0;
+	CHECK_EQ(tft.drawTextBox(0, 0, 36, 8, "ABCDEFGHIJ", display16_graphics_LTSM::TextAlignLeft, &drawn),
+		DisLib16::TextTruncated);
+	CHECK_EQ(drawn, 4u);
+	CHECK_EQ(glyphMismatches(tft, 24, 0, FontDefault, 'D', 0xFFFF, 0x0000), 0u);
+	CHECK_EQ(rectMismatches(tft, 32, 0, 4, 8, 0x0000), 0u); // no part of 'E'
+	CHECK_EQ(rectMismatches(tft, 36, 0, 8, 8, 0xF800), 0u);
+	// lines below the box are left out, empty ones do not count
+	CHECK_EQ(tft.drawTextBox(0, 20, 40, 20, "A\nB\nC", display16_graphics_LTSM::TextAlignLeft, &drawn),
+		DisLib16::TextTruncated);
+	CHECK_EQ(drawn, 2u);
+	CHECK_EQ(rectMismatches(tft, 0, 40, 40, 8, 0xF800), 0u);
+	CHECK_EQ(tft.drawTextBox(0, 50, 40, 8, "A\n\n", display16_graphics_LTSM::TextAlignLeft), DisLib16::Success);
+	// text that fits the measured bounds is never truncated
+	const std::vector<uint8_t> prop = makeProportionalFont(FontDefault);
+	tft.setFont(prop.data());
+	uint16_t w = 0, h = 0;
+	tft.getTextBounds("Layout\nworks", w, h);
+	CHECK_EQ(tft.drawTextBox(0, 0, w, h, "Layout\nworks", display16_graphics_LTSM::TextAlignCentre), DisLib16::Success);
+	CHECK_EQ(tft.drawTextBox(0, 0, w - 1, h, "Layout\nworks", display16_graphics_LTSM::TextAlignCentre), DisLib16::TextTruncated);
+	tft.setFont(FontDefault);
+}
+
+namespace {
+// Background of stripes, so pixels left alone by transparent text can be told apart
+void stripes(display16_mock_LTSM& t)
+{
+	for (uint16_t y = 0; y < H; y++)
+		t.fillRect(0, y, W, 1, static_cast<uint16_t>(0x0841 * (y % 16)));
+}
+
+// Transparent text over stripes against opaque text drawn with a key background
+uint32_t transparentMismatches(const uint8_t *font, uint8_t scale, bool pixelMode)
+{
+	const uint16_t key = 0xF81F, fg = 0xFFE0;
+	display16_mock_LTSM opaque(W, H), clear(W, H);
+	opaque.begin();
+	clear.begin();
+	opaque.setFont(font);
+	clear.setFont(font);
+	opaque.setTextScale(scale);
+	clear.setTextScale(scale);
+	clear.setTextCharPixelOrBuffer(pixelMode);
+	opaque.fillScreen(key);
+	stripes(clear);
+	opaque.setTextColor(fg, key);
+	clear.setTextColor(fg);
+	char text[] = "Wig 42";
+	opaque.writeCharString(3, 5, text);
+	clear.writeCharString(3, 5, text);
+	opaque.writeChar(W - 5, H - 6, 'M'); // clipped
+	clear.writeChar(W - 5, H - 6, 'M');
+	uint32_t errors = 0;
+	for (uint16_t y = 0; y < H; y++)
+		for (uint16_t x = 0; x < W; x++)
+		{
+			const uint16_t want = (opaque.getPanelPixel(x, y) == key) ? static_cast<uint16_t>(0x0841 * (y % 16)) : fg;
+			errors += (clear.getPanelPixel(x, y) != want);
+		}
+	return errors;
+}
+}
+
+TEST_CASE(transparent_text_sends_only_set_pixels)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	CHECK(!tft.getTextTransparent());
+	stripes(tft);
+	tft.setTextColor(0xFFFF);
+	CHECK(tft.getTextTransparent());
+	uint32_t setBits = 0;
+	for (uint32_t i = 0; i < 8; i++)
+		for (uint8_t b = 0; b < 8; b++)
+			setBits += (FontDefault[4 + ('H' - 0x20) * 8 + i] >> b) & 1;
+	mock_counters_t c = tft.measure([&]{ tft.writeChar(8, 8, 'H'); });
+	CHECK_EQ(c.pixelsWritten, setBits);
+	CHECK(c.addrWindows < setBits / 2); // vertical strokes merged into spans
+	uint32_t left = 0;
+	for (uint16_t cy = 0; cy < 8; cy++)
+		for (uint16_t cx = 0; cx < 8; cx++)
+			left += (tft.getPanelPixel(8 + cx, 8 + cy) == static_cast<uint16_t>(0x0841 * ((8 + cy) % 16)));
+	CHECK_EQ(left, 64u - setBits);
+	// the box is not filled either
+	c = tft.measure([&]{ tft.drawTextBox(0, 20, 100, 30, "H", display16_graphics_LTSM::TextAlignCentre); });
+	CHECK_EQ(c.pixelsWritten, setBits);
+	tft.setTextColor(0xFFFF, 0x0000);
+	CHECK(!tft.getTextTransparent());
+	tft.setTextTransparent(true);
+	CHECK(tft.getTextTransparent());
+}
+
+TEST_CASE(transparent_text_all_fonts_and_modes)
+{
+	const std::vector<uint8_t> prop = makeProportionalFont(FontDefault);
+	const std::vector<uint8_t> packed = makeExtendedFont(FontDefault, 2, true);
+	for (const uint8_t *font : {FontDefault, prop.data(), packed.data()})
+		for (uint8_t scale : {1, 2})
+			for (bool pixelMode : {false, true})
+				CHECK_EQ(transparentMismatches(font, scale, pixelMode), 0u);
+	// anti-aliased fonts without a screen buffer draw pixels of half coverage and up
+	const std::vector<uint8_t> aa = makeAntiAliasedFont(FontDefault, 2);
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	tft.fillScreen(0x0000);
+	tft.setFont(aa.data());
+	tft.setTextColor(0xFFFF);
+	tft.writeChar(0, 0, 'A');
+	CHECK_EQ(glyphMismatches(tft, 0, 0, FontDefault, 'A', 0xFFFF, 0x0000), 0u);
+}
+
+TEST_CASE(utf8_print_through_codepoint_map)
+{
+	const std::vector<uint8_t> prop = makeProportionalFont(FontDefault);
+	const std::vector<uint8_t> mapped = withCodepointMap(prop,
+		{{0xB0, 'o'}, {0x3A9, 'W'}, {0x2192, '>'}, {0x1F600, '@'}});
+	display16_mock_LTSM plain(W, H), utf8(W, H);
+	for (display16_mock_LTSM *t : {&plain, &utf8})
+	{
+		t->begin();
+		t->fillScreen(0x0000);
+		t->setTextColor(0xFFFF, 0x001F);
+	}
+	plain.setFont(prop.data());
+	plain.setTextUTF8(false);
+	CHECK(!plain.getTextUTF8());
+	plain.setCursor(0, 0);
+	plain.print("20oC 5W x>y @ ");
+	plain.writeCharString(0, 20, const_cast<char *>("Hello"));
+	CHECK_EQ(utf8.setFont(mapped.data()), DisLib16::Success);
+	CHECK(utf8.getTextUTF8());
+	utf8.setCursor(0, 0);
+	utf8.print("20\u00B0C 5\u03A9 x\u2192y \U0001F600 ");
+	utf8.writeCharString(0, 20, const_cast<char *>("Hello")); // ASCII through the moved glyph table
+	CHECK_EQ(panelDifferences(plain, utf8, W, H), 0u);
+	CHECK_EQ(utf8.getWriteError(), 0);
+	// a run is split around the multi byte sequences, ASCII between them still one window
+	mock_counters_t c = utf8.measure([&]{ utf8.setCursor(0, 40); utf8.print("ab\u00B0cd"); });
+	CHECK_EQ(c.addrWindows, 3u);
+	plain.setCursor(0, 40);
+	plain.print("abocd");
+	// codepoints the font has no glyph for, cut sequences and overlong forms set the write error,
+	// nothing is drawn for them and the next character is
+	plain.setCursor(0, 50);
+	plain.print("AB");
+	utf8.setCursor(0, 50);
+	utf8.print("\u20AC" "\xE2\x86" "A");
+	CHECK_EQ(utf8.getWriteError(), DisLib16::CharFontASCIIRange);
+	utf8.clearWriteError();
+	utf8.print("\xC0\xAF" "B");
+	CHECK(utf8.getWriteError() != 0);
+	utf8.clearWriteError();
+	CHECK_EQ(panelDifferences(plain, utf8, W, H), 0u);
+	// a fixed font has no map, bytes past ASCII decode to Latin-1 codepoints
+	utf8.setFont(FontDefault);
+	utf8.print("\u00E9");
+	CHECK_EQ(utf8.getWriteError(), DisLib16::CharFontASCIIRange);
+	utf8.clearWriteError();
+	utf8.setCursor(0, 60);
+	utf8.print("\x7E"); // single bytes below 0x80 are unchanged
+	CHECK_EQ(glyphMismatches(utf8, 0, 60, FontDefault, '~', 0xFFFF, 0x001F), 0u);
+}
+
+TEST_CASE(codepoint_map_search)
+{
+	// 255 entries, all two byte sequences, every one found, gaps between them not
+	const std::vector<uint8_t> prop = makeProportionalFont(FontDefault);
+	std::vector<std::pair<uint32_t, uint8_t>> entries;
+	for (uint32_t i = 0; i < 255; i++)
+		entries.push_back({0x100 + i * 7, static_cast<uint8_t>(0x21 + (i % 90))});
+	const std::vector<uint8_t> mapped = withCodepointMap(prop, entries);
+	display16_mock_LTSM plain(W, H), utf8(W, H);
+	plain.begin();
+	utf8.begin();
+	plain.setFont(prop.data());
+	utf8.setFont(mapped.data());
+	for (uint32_t i = 0; i < 255; i += 17)
+	{
+		const uint32_t cp = entries[i].first;
+		const char text[4] = {static_cast<char>(0xC0 | (cp >> 6)), static_cast<char>(0x80 | (cp & 0x3F)), 0, 0};
+		plain.setCursor(0, 0);
+		utf8.setCursor(0, 0);
+		plain.write(entries[i].second);
+		plain.write('|');
+		const char gap[4] = {static_cast<char>(0xC0 | ((cp + 1) >> 6)), static_cast<char>(0x80 | ((cp + 1) & 0x3F)), 0, 0};
+		utf8.print(text);
+		utf8.print(gap);
+		CHECK_EQ(utf8.getWriteError(), DisLib16::CharFontASCIIRange);
+		utf8.clearWriteError();
+		utf8.write('|');
+		CHECK_EQ(panelDifferences(plain, utf8, W, H), 0u);
+	}
+}
+
+TEST_CASE(numeric_field_repaints_changed_cells)
+{
+	display16_mock_LTSM tft(320, 96), ref(320, 96);
+	constexpr uint16_t cell = 32 * 50;
+	for (display16_mock_LTSM *t : {&tft, &ref})
+	{
+		t->begin();
+		t->fillScreen(0x0000);
+		t->setTextColor(0xFFE0, 0x001F);
+	}
+	// reference, the same text in fixed cells with the blanks filled
+	auto reference = [&](const char *text, uint16_t bg = 0x001F) {
+		ref.setFont(FontSevenSeg);
+		for (uint8_t i = 0; text[i] != '\0'; i++)
+		{
+			if (text[i] == ' ')
+				ref.fillRect(10 + i * 32, 20, 32, 50, bg);
+			else
+				ref.writeChar(10 + i * 32, 20, text[i]);
+		}
+		ref.setFont(FontDefault);
+	};
+	display16_graphics_LTSM::numeric_field_t field;
+	CHECK_EQ(tft.setNumericField(field, 10, 20, nullptr, 6), DisLib16::FontPtrNullptr);
+	CHECK_EQ(tft.setNumericField(field, 10, 20, FontSevenSeg, 0), DisLib16::GenericError);
+	CHECK_EQ(tft.setNumericField(field, 10, 20, FontSevenSeg, 17), DisLib16::GenericError);
+	CHECK_EQ(tft.setNumericField(field, 10, 20, FontSevenSeg, 3, 3), DisLib16::GenericError);
+	CHECK_EQ(tft.drawNumericField(field, 1), DisLib16::FontPtrNullptr);
+	CHECK_EQ(tft.setNumericField(field, 10, 20, FontSevenSeg, 7, 1), DisLib16::Success);
+	// first draw paints every cell
+	mock_counters_t c = tft.measure([&]{ CHECK_EQ(tft.drawNumericField(field, 12345), DisLib16::Success); });
+	CHECK_EQ(c.pixelsWritten, 7u * cell);
+	reference(" 1234.5");
+	CHECK_EQ(panelDifferences(tft, ref, 320, 96), 0u);
+	// one digit changes, one cell sent
+	c = tft.measure([&]{ tft.drawNumericField(field, 12346); });
+	CHECK_EQ(c.pixelsWritten, 1u * cell);
+	CHECK_EQ(c.addrWindows, 1u);
+	c = tft.measure([&]{ tft.drawNumericField(field, 12346); });
+	CHECK_EQ(c.pixelsWritten, 0u);
+	// sign, a shorter value and a leading zero before the point
+	tft.drawNumericField(field, -75);
+	reference("   -7.5");
+	CHECK_EQ(panelDifferences(tft, ref, 320, 96), 0u);
+	tft.drawNumericField(field, -5);
+	reference("   -0.5");
+	CHECK_EQ(panelDifferences(tft, ref, 320, 96), 0u);
+	tft.drawNumericField(field, 0);
+	reference("    0.0");
+	CHECK_EQ(panelDifferences(tft, ref, 320, 96), 0u);
+	// zero padding after the sign
+	tft.setNumericField(field, 10, 20, FontSevenSeg, 7, 2, true);
+	tft.drawNumericField(field, -1234);
+	reference("-012.34");
+	CHECK_EQ(panelDifferences(tft, ref, 320, 96), 0u);
+	tft.drawNumericField(field, INT32_MIN); // too long
+	CHECK_EQ(tft.drawNumericField(field, INT32_MIN), DisLib16::TextTruncated);
+	reference("-------");
+	CHECK_EQ(panelDifferences(tft, ref, 320, 96), 0u);
+	// text, and a colour change repaints every cell
+	CHECK_EQ(tft.drawNumericFieldText(field, "12:30"), DisLib16::Success);
+	reference("  12:30");
+	CHECK_EQ(panelDifferences(tft, ref, 320, 96), 0u);
+	tft.setTextColor(0xFFFF, 0x0000);
+	ref.setTextColor(0xFFFF, 0x0000);
+	c = tft.measure([&]{ tft.drawNumericFieldText(field, "12:30"); });
+	CHECK_EQ(c.pixelsWritten, 7u * cell);
+	reference("  12:30", 0x0000);
+	CHECK_EQ(panelDifferences(tft, ref, 320, 96), 0u);
+	CHECK_EQ(tft.drawNumericFieldText(field, "1A"), DisLib16::CharFontASCIIRange);
+	CHECK_EQ(tft.drawNumericFieldText(field, nullptr), DisLib16::CharArrayNullptr);
+	// the active font and transparent text are restored
+	tft.setTextColor(0xFFFF);
+	tft.drawNumericFieldText(field, "1");
+	CHECK(tft.getTextTransparent());
+	tft.setTextColor(0xFFFF, 0x0000);
+	tft.writeChar(0, 80, 'A');
+	CHECK_EQ(glyphMismatches(tft, 0, 80, FontDefault, 'A', 0xFFFF, 0x0000), 0u);
+	// the caller's font invert is used for the field and kept
+	tft.setInvertFont(true);
+	tft.drawNumericFieldText(field, "45:67");
+	CHECK(tft.getInvertFont());
+	ref.writeChar(0, 80, 'A');
+	ref.setTextColor(0x0000, 0xFFFF);
+	reference("  45:67", 0xFFFF);
+	CHECK_EQ(panelDifferences(tft, ref, 320, 96), 0u);
+}
+
+TEST_CASE(traffic_report)
+{
+	display16_mock_LTSM tft(240, 320);
+	tft.begin();
+	static uint8_t rgb565[32 * 32 * 2];
+	static uint8_t mono[4 * 32];
+	printf("  Bus traffic per draw call, 240x320 panel\n");
+	printCounters("drawPixel", tft.measure([&]{ tft.drawPixel(1, 1, 0xFFFF); }));
+	printCounters("drawLine 100px", tft.measure([&]{ tft.drawLine(0, 0, 99, 40, 0xFFFF); }));
+	printCounters("drawCircle r=40", tft.measure([&]{ tft.drawCircle(120, 160, 40, 0xFFFF); }));
+	printCounters("fillRect 100x100", tft.measure([&]{ tft.fillRect(0, 0, 100, 100, 0xFFFF); }));
+	printCounters("fillRectBuffer 100x100", tft.measure([&]{ tft.fillRectBuffer(0, 0, 100, 100, 0xFFFF); }));
+	printCounters("fillScreen", tft.measure([&]{ tft.fillScreen(0x0000); }));
+	printCounters("writeChar 8x8", tft.measure([&]{ tft.writeChar(0, 0, 'A'); }));
+	tft.setTextCharPixelOrBuffer(true);
+	printCounters("writeChar 8x8 pixel mode", tft.measure([&]{ tft.writeChar(0, 0, 'A'); }));
+	tft.setTextCharPixelOrBuffer(false);
+	char text[] = "Status: 1234.5 V";
+	printCounters("writeCharString 16 chars", tft.measure([&]{ tft.writeCharString(0, 0, text); }));
+	printCounters("drawBitmap 32x32", tft.measure([&]{ tft.drawBitmap(0, 0, 32, 32, 0xFFFF, 0, mono); }));
+	printCounters("drawBitmap16Data 32x32", tft.measure([&]{ tft.drawBitmap16Data(0, 0, rgb565, 32, 32); }));
+	printCounters("drawSpriteData 32x32", tft.measure([&]{ tft.drawSpriteData(0, 0, rgb565, 32, 32, 0x0001, false); }));
+	static uint8_t ring[32 * 32 * 2]; // ring of radius 10 to 15, 0x0001 outside and inside
+	for (int j = 0; j < 32; j++)
+		for (int i = 0; i < 32; i++)
+		{
+			const int d2 = (i - 16) * (i - 16) + (j - 16) * (j - 16);
+			ring[(j * 32 + i) * 2 + 1] = (d2 >= 100 && d2 <= 225) ? 0xE0 : 0x01;
+		}
+	std::vector<uint8_t> ringRuns(1024);
+	uint32_t ringUsed = 0;
+	tft.buildSpriteRuns(ring, 32, 32, 0x0001, ringRuns.data(), ringRuns.size(), ringUsed);
+	printCounters("drawSpriteData ring 32x32", tft.measure([&]{ tft.drawSpriteData(0, 0, ring, 32, 32, 0x0001, false); }));
+	printCounters("drawSpriteRuns ring 32x32", tft.measure([&]{ tft.drawSpriteRuns(0, 0, ring, ringRuns.data()); }));
+	const std::vector<uint8_t> seg = makeExtendedFont(FontSevenSeg, 2, false);
+	tft.setFont(FontSevenSeg);
+	printCounters("writeChar 32x50", tft.measure([&]{ tft.writeChar(0, 0, '8'); }));
+	tft.setFont(seg.data());
+	printCounters("writeChar 32x50 compressed", tft.measure([&]{ tft.writeChar(0, 0, '8'); }));
+	tft.setFont(FontDefault);
+	tft.setTextScale(4);
+	printCounters("writeChar 8x8 at scale 4", tft.measure([&]{ tft.writeChar(0, 0, 'A'); }));
+	tft.setTextScale(1);
+	display16_graphics_LTSM::numeric_field_t field;
+	tft.setNumericField(field, 0, 100, FontSevenSeg, 6, 1);
+	tft.drawNumericField(field, 12345);
+	field.drawn = false;
+	printCounters("drawNumericField 6 cells 32x50", tft.measure([&]{ tft.drawNumericField(field, 12345); }));
+	printCounters("drawNumericField 1234.6 32x50", tft.measure([&]{ tft.drawNumericField(field, 12346); }));
+	printf("  Address windows saved by pixel runs: %lu\n", static_cast<unsigned long>(tft.getPixelWindowsSaved()));
+}
+
+TEST_MAIN()
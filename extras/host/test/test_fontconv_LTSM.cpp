@@ -0,0 +1,311 @@
+/*!
+	@file    test_fontconv_LTSM.cpp
+	@brief   Host tests for the ltsm_fontconv font converter, fonts drawn by the library.
+	@details First argument, if given, is the ltsm_fontconv executable, run on a generated BDF file.
+*/
+
+#include "test_util_LTSM.hpp"
+#include <fontconv_LTSM.hpp>
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace TestLTSM;
+using namespace FontConvLTSM;
+
+namespace {
+constexpr uint16_t W = 128;
+constexpr uint16_t H = 64;
+std::string converterPath;
+
+// BDF text of a fixed library font, every glyph a full cell on the baseline
+template <size_t N>
+std::string bdfFromFixed(const uint8_t (&fixed)[N])
+{
+	const int fontX = fixed[0], fontY = fixed[1], offset = fixed[2], count = fixedGlyphCount(fixed, N);
+	std::ostringstream bdf;
+	bdf << "STARTFONT 2.1\nFONT test\nSIZE 8 75 75\nFONTBOUNDINGBOX " << fontX << " " << fontY << " 0 0\n"
+		<< "STARTPROPERTIES 2\nFONT_ASCENT " << fontY << "\nFONT_DESCENT 0\nENDPROPERTIES\nCHARS " << count << "\n";
+	for (int i = 0; i < count; i++)
+	{
+		bdf << "STARTCHAR c" << i << "\nENCODING " << (offset + i) << "\nSWIDTH 500 0\nDWIDTH " << fontX
+			<< " 0\nBBX " << fontX << " " << fontY << " 0 0\nBITMAP\n";
+		for (int y = 0; y < fontY; y++)
+		{
+			char hex[4];
+			for (int b = 0; b < fontX / 8; b++)
+			{
+				snprintf(hex, sizeof(hex), "%02X", fixed[4 + i * (fontX * fontY / 8) + y * (fontX / 8) + b]);
+				bdf << hex;
+			}
+			bdf << "\n";
+		}
+		bdf << "ENDCHAR\n";
+	}
+	bdf << "ENDFONT\n";
+	return bdf.str();
+}
+
+// A small hand made BDF: ascent 7, descent 2, 'i' narrow, 'g' with a descender
+const char *kSmallBDF =
+	"STARTFONT 2.1\nFONT small\nSIZE 9 75 75\nFONTBOUNDINGBOX 5 9 0 -2\n"
+	"STARTPROPERTIES 2\nFONT_ASCENT 7\nFONT_DESCENT 2\nENDPROPERTIES\nCHARS 3\n"
+	"STARTCHAR space\nENCODING 32\nDWIDTH 3 0\nBBX 0 0 0 0\nBITMAP\nENDCHAR\n"
+	"STARTCHAR g\nENCODING 103\nDWIDTH 6 0\nBBX 4 6 1 -2\nBITMAP\n70\n90\n90\n70\n10\nE0\nENDCHAR\n"
+	"STARTCHAR i\nENCODING 105\nDWIDTH 3 0\nBBX 1 6 1 0\nBITMAP\n80\n00\n80\n80\n80\n80\nENDCHAR\n"
+	"ENDFONT\n";
+
+// The small BDF with an Omega and an arrow past Latin-1
+const std::string kMappedBDF = std::string(kSmallBDF).substr(0, std::string(kSmallBDF).find("ENDFONT")) +
+	"STARTCHAR Omega\nENCODING 937\nDWIDTH 6 0\nBBX 5 5 0 0\nBITMAP\n70\n88\n88\n50\nD8\nENDCHAR\n"
+	"STARTCHAR arrow\nENCODING 8594\nDWIDTH 5 0\nBBX 4 3 0 2\nBITMAP\n20\nF0\n20\nENDCHAR\n"
+	"ENDFONT\n";
+
+// Panel cell against the converter glyph model
+uint32_t cellMismatches(const display16_mock_LTSM &tft, uint16_t x, uint16_t y, const font_t &font, int code,
+	uint16_t fg, uint16_t bg)
+{
+	const glyph_t &glyph = font.glyphs.at(code);
+	uint32_t errors = 0;
+	for (int cy = 0; cy < font.lineHeight; cy++)
+		for (int cx = 0; cx < glyph.advance; cx++)
+			if (tft.getPanelPixel(x + cx, y + cy) != (glyph.cellPixel(cx, cy) ? fg : bg))
+				errors++;
+	return errors;
+}
+}
+
+TEST_CASE(fixed_output_matches_library_font)
+{
+	std::istringstream in(bdfFromFixed(FontDefault));
+	font_t font;
+	std::string error;
+	CHECK(loadBDF(in, font, error));
+	CHECK_EQ(font.lineHeight, 8);
+	std::vector<uint8_t> bytes;
+	CHECK(encode(font, 0x20, 0x7E, FormatFixed, bytes, error));
+	CHECK_EQ(bytes.size(), sizeof(FontDefault));
+	// control byte 3 is last - first, FontDefault holds its glyph count there, the glyph data is the same
+	CHECK(std::equal(bytes.begin(), bytes.begin() + 3, FontDefault));
+	CHECK_EQ(bytes[3], fixedGlyphCount(FontDefault, sizeof(FontDefault)) - 1);
+	CHECK(std::equal(bytes.begin() + 4, bytes.end(), FontDefault + 4));
+	const font_stats_t stats = measure(font, 0x20, 0x7E);
+	CHECK_EQ(stats.present, 95);
+	CHECK_EQ(stats.fixedBytes, sizeof(FontDefault));
+	CHECK(stats.compressedBytes > 0u);
+}
+
+TEST_CASE(bdf_metrics_place_glyphs_in_cells)
+{
+	std::istringstream in(kSmallBDF);
+	font_t font;
+	std::string error;
+	CHECK(loadBDF(in, font, error));
+	CHECK_EQ(font.lineHeight, 9);
+	const glyph_t &g = font.glyphs.at('g');
+	CHECK_EQ(g.advance, 6);
+	CHECK_EQ(g.xOffset, 1);
+	CHECK_EQ(g.yOffset, 3); // 7 ascent - (-2 + 6)
+	const glyph_t &i = font.glyphs.at('i');
+	CHECK_EQ(i.yOffset, 1);
+	CHECK_EQ(i.advance, 3);
+	std::istringstream bad("not a font\n");
+	font_t none;
+	CHECK(!loadBDF(bad, none, error));
+}
+
+TEST_CASE(every_format_draws_the_same_text)
+{
+	std::istringstream in(kSmallBDF);
+	font_t font;
+	std::string error;
+	loadBDF(in, font, error);
+	char text[] = "gig i";
+	for (format_e format : {FormatFixed, FormatProportional, FormatCompressed})
+	{
+		std::vector<uint8_t> bytes;
+		CHECK(encode(font, 0x20, 0x69, format, bytes, error));
+		display16_mock_LTSM tft(W, H);
+		tft.begin();
+		tft.fillScreen(0x0000);
+		CHECK_EQ(tft.setFont(bytes.data()), DisLib16::Success);
+		tft.setTextColor(0xFFFF, 0x001F);
+		CHECK_EQ(tft.writeCharString(0, 0, text), DisLib16::Success);
+		uint16_t x = 0;
+		const uint16_t fixedWidth = 8;
+		for (int k = 0; text[k] != '\0'; k++)
+		{
+			CHECK_EQ(cellMismatches(tft, x, 0, font, text[k], 0xFFFF, 0x001F), 0u);
+			x += (format == FormatFixed) ? fixedWidth : font.glyphs.at(text[k]).advance;
+		}
+	}
+}
+
+TEST_CASE(subset_keeps_only_listed_glyphs)
+{
+	std::istringstream in(bdfFromFixed(FontDefault));
+	font_t font;
+	std::string error;
+	loadBDF(in, font, error);
+	const font_t digits = selectGlyphs(font, 0x30, 0x39, "0123");
+	CHECK_EQ(digits.glyphs.size(), 4u);
+	std::vector<uint8_t> subset, whole;
+	CHECK(encode(digits, 0x30, 0x39, FormatProportional, subset, error));
+	CHECK(encode(selectGlyphs(font, 0x30, 0x39, ""), 0x30, 0x39, FormatProportional, whole, error));
+	CHECK(subset.size() < whole.size());
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	tft.setFont(subset.data());
+	mock_counters_t c = tft.measure([&]{ tft.writeChar(0, 0, '9'); }); // no glyph, nothing drawn
+	CHECK_EQ(c.pixelsWritten, 0u);
+	CHECK_EQ(tft.writeChar(0, 0, 'A'), DisLib16::CharFontASCIIRange);
+	CHECK(!encode(font, 0x00, 0xFF, FormatFixed, whole, error)); // 256 characters do not fit
+}
+
+TEST_CASE(pgm_sheet_cells)
+{
+	// 2 cells of 4x3, '-' then '|', dark ink on white
+	std::istringstream in("P2\n# sheet\n8 3\n255\n"
+		"255 255 255 255  255 0 255 255\n"
+		"0   0   0   255  255 0 255 255\n"
+		"255 255 255 255  255 0 255 255\n");
+	font_t font;
+	std::string error;
+	CHECK(loadPGM(in, 4, 3, '-', 128, 1, font, error));
+	CHECK_EQ(font.lineHeight, 3);
+	CHECK_EQ(font.glyphs.at('-').width, 3);
+	CHECK_EQ(font.glyphs.at('-').advance, 4);
+	CHECK_EQ(font.glyphs.at('.').width, 1); // second cell
+	CHECK_EQ(font.glyphs.at('.').height, 3);
+	CHECK_EQ(font.glyphs.at('.').advance, 2);
+	std::istringstream bad("P6\n1 1\n255\n");
+	font_t none;
+	CHECK(!loadPGM(bad, 4, 3, '-', 128, 1, none, error));
+}
+
+TEST_CASE(pgm_grey_levels_make_antialiased_fonts)
+{
+	// one 4x3 cell, a grey ramp either side of a dark stroke
+	std::istringstream in("P2\n4 3\n255\n"
+		"255 170 85  255\n"
+		"200 0   0   120\n"
+		"255 170 85  255\n");
+	font_t font;
+	std::string error;
+	CHECK(loadPGM(in, 4, 3, 'A', 128, -1, font, error));
+	const glyph_t &glyph = font.glyphs.at('A');
+	CHECK_EQ(glyph.cellCoverage(1, 1), 255);
+	CHECK(glyph.cellPixel(2, 0));  // 85, darker than the threshold
+	CHECK(!glyph.cellPixel(1, 0)); // 170, lighter
+	CHECK(glyph.cellCoverage(1, 0) > 0);
+	for (format_e format : {FormatAntiAlias2, FormatAntiAlias4})
+	{
+		const int top = (format == FormatAntiAlias4) ? 15 : 3;
+		std::vector<uint8_t> bytes;
+		CHECK(encode(font, 'A', 'A', format, bytes, error));
+		CHECK_EQ(bytes[1], static_cast<uint8_t>(format));
+		display16_mock_LTSM tft(W, H);
+		tft.begin();
+		CHECK_EQ(tft.setFont(bytes.data()), DisLib16::Success);
+		tft.setTextColor(0xFFFF, 0x0000);
+		tft.writeChar(0, 0, 'A');
+		uint32_t errors = 0, blended = 0;
+		for (int cy = 0; cy < 3; cy++)
+			for (int cx = 0; cx < 4; cx++)
+			{
+				const int level = (glyph.cellCoverage(cx, cy) * top + 127) / 255;
+				const uint16_t color = tft.getPanelPixel(cx, cy);
+				errors += (color != blend565(0xFFFF, 0x0000, level, top));
+				blended += (color != 0xFFFF && color != 0x0000);
+			}
+		CHECK_EQ(errors, 0u);
+		CHECK(blended > 0u);
+	}
+}
+
+TEST_CASE(codepoints_get_a_map_and_print_as_utf8)
+{
+	std::istringstream in(kMappedBDF);
+	font_t font;
+	std::string error;
+	CHECK(loadBDF(in, font, error));
+	CHECK_EQ(font.glyphs.count(0x3A9), 1u);
+	const std::vector<int> codepoints = {0x2192, 0x3A9};
+	std::vector<uint8_t> bytes;
+	CHECK(!encode(font, 0x20, 0x69, FormatFixed, bytes, error, codepoints));
+	CHECK(!encode(font, 0x20, 0x69, FormatProportional, bytes, error, {0x41}));
+	for (format_e format : {FormatProportional, FormatCompressed, FormatAntiAlias4})
+	{
+		CHECK(encode(font, 0x20, 0x69, format, bytes, error, codepoints));
+		CHECK_EQ(bytes[5], 0x01);
+		CHECK_EQ(bytes[6], 2); // sorted, Omega then the arrow, characters after the range
+		CHECK_EQ((bytes[7] << 16) | (bytes[8] << 8) | bytes[9], 0x3A9);
+		CHECK_EQ(bytes[10], 0x6A);
+		CHECK_EQ(bytes[14], 0x6B);
+		display16_mock_LTSM tft(W, H);
+		tft.begin();
+		tft.fillScreen(0x0000);
+		CHECK_EQ(tft.setFont(bytes.data()), DisLib16::Success);
+		tft.setTextColor(0xFFFF, 0x001F);
+		tft.setCursor(0, 0);
+		tft.print("g\u03A9i\u2192g");
+		CHECK_EQ(tft.getWriteError(), 0);
+		if (format == FormatAntiAlias4)
+			continue; // 1 bit BDF ink, the same pixels at the top level
+		int x = 0;
+		for (int code : {int('g'), 0x3A9, int('i'), 0x2192, int('g')})
+		{
+			CHECK_EQ(cellMismatches(tft, x, 0, font, code, 0xFFFF, 0x001F), 0u);
+			x += font.glyphs.at(code).advance;
+		}
+	}
+	const font_stats_t stats = measure(font, 0x20, 0x69, codepoints);
+	CHECK_EQ(stats.present, 5);
+	CHECK_EQ(stats.fixedBytes, 0u);
+	CHECK(stats.proportionalBytes > 0u);
+}
+
+TEST_CASE(command_line_writes_a_header)
+{
+	if (converterPath.empty())
+		return;
+	{
+		std::ofstream bdf("fontconv_test.bdf");
+		bdf << bdfFromFixed(FontDefault);
+	}
+	const std::string command = converterPath + " -f all -r 0x30-0x39 -n FontTestDigits -o fontconv_test_LTSM.hpp fontconv_test.bdf";
+	CHECK_EQ(system(command.c_str()), 0);
+	std::ifstream header("fontconv_test_LTSM.hpp");
+	std::stringstream text;
+	text << header.rdbuf();
+	const std::string out = text.str();
+	CHECK(out.find("static const uint8_t FontTestDigits[84] FLASH_STORAGE") != std::string::npos);
+	CHECK(out.find("FontTestDigitsProp[") != std::string::npos);
+	CHECK(out.find("FontTestDigitsRle[") != std::string::npos);
+	CHECK(out.find("FontTestDigitsAa4[") == std::string::npos); // not part of all
+	CHECK(out.find("#pragma once") != std::string::npos);
+	CHECK(system((converterPath + " -r 1-2-3 fontconv_test.bdf > /dev/null 2>&1").c_str()) != 0);
+	{
+		std::ofstream bdf("fontconv_mapped.bdf");
+		bdf << kMappedBDF;
+	}
+	const std::string mapped = converterPath + " -f all -r 0x20-0x69 -u 0x3A9,0x2190-0x2193 -n FontTestMapped "
+		"-o fontconv_mapped_LTSM.hpp fontconv_mapped.bdf 2> /dev/null";
+	CHECK_EQ(system(mapped.c_str()), 0);
+	std::ifstream mappedHeader("fontconv_mapped_LTSM.hpp");
+	std::stringstream mappedText;
+	mappedText << mappedHeader.rdbuf();
+	CHECK(mappedText.str().find("// U+2192") != std::string::npos);
+	CHECK(mappedText.str().find("FontTestMappedProp[") != std::string::npos);
+	CHECK(mappedText.str().find("FontTestMapped[") == std::string::npos); // no fixed format with a map
+	CHECK(system((converterPath + " -f fixed -u 0x3A9 fontconv_mapped.bdf > /dev/null 2>&1").c_str()) != 0);
+}
+
+int main(int argc, char **argv)
+{
+	if (argc > 1)
+		converterPath = argv[1];
+	return TestLTSM::runAll();
+}
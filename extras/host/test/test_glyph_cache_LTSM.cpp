@@ -0,0 +1,187 @@
+/*!
+	@file    test_glyph_cache_LTSM.cpp
+	@brief   Host tests for Display16_LTSM, glyph cache (USER OPTION 6).
+*/
+
+#include "test_util_LTSM.hpp"
+#include <fonts_LTSM/FontPico_LTSM.hpp>
+#include <fonts_LTSM/FontSevenSeg_LTSM.hpp>
+
+using namespace TestLTSM;
+
+namespace {
+constexpr uint16_t W = 128;
+constexpr uint16_t H = 64;
+constexpr uint16_t FG = 0xFFE0;
+constexpr uint16_t BG = 0x001F;
+
+// Same text drawn by single characters and by runs, with and without the cache
+void textScene(display16_mock_LTSM &tft)
+{
+	tft.fillScreen(0x0000);
+	tft.setTextColor(FG, BG);
+	tft.writeChar(0, 0, 'A');
+	tft.writeChar(8, 0, 'A');
+	tft.writeCharString(0, 10, const_cast<char *>("HELLO WORLD HELLO"));
+	tft.setInvertFont(true);
+	tft.writeCharString(0, 20, const_cast<char *>("ABBA"));
+	tft.setInvertFont(false);
+	tft.writeChar(W - 4, 30, 'Z'); // clipped at right edge
+	tft.setCursor(0, 40);
+	tft.print("Count 12345");
+}
+}
+
+TEST_CASE(cache_off_by_default)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	tft.writeChar(0, 0, 'A');
+	CHECK_EQ(tft.getGlyphCacheSlots(), 0u);
+	CHECK_EQ(tft.getGlyphCacheHits(), 0u);
+	CHECK_EQ(tft.getGlyphCacheMisses(), 0u);
+}
+
+TEST_CASE(repeat_characters_hit)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	CHECK_EQ(tft.setGlyphCache(8 * 8 * 2 * 4), DisLib16::Success);
+	CHECK_EQ(tft.getGlyphCacheSlots(), 4u);
+	tft.setTextColor(FG, BG);
+	tft.writeChar(0, 0, 'A');
+	CHECK_EQ(tft.getGlyphCacheMisses(), 1u);
+	CHECK_EQ(tft.getGlyphCacheHits(), 0u);
+	mock_counters_t c = tft.measure([&]{ tft.writeChar(8, 0, 'A'); });
+	CHECK_EQ(tft.getGlyphCacheHits(), 1u);
+	CHECK_EQ(c.addrWindows, 1u);
+	CHECK_EQ(glyphMismatches(tft, 0, 0, FontDefault, 'A', FG, BG), 0u);
+	CHECK_EQ(glyphMismatches(tft, 8, 0, FontDefault, 'A', FG, BG), 0u);
+	// colour is part of the key
+	tft.setTextColor(BG, FG);
+	tft.writeChar(16, 0, 'A');
+	CHECK_EQ(tft.getGlyphCacheMisses(), 2u);
+	CHECK_EQ(glyphMismatches(tft, 16, 0, FontDefault, 'A', BG, FG), 0u);
+	// invert swaps colours, same key as the swapped colour pair
+	tft.setTextColor(FG, BG);
+	tft.setInvertFont(true);
+	tft.writeChar(24, 0, 'A');
+	CHECK_EQ(tft.getGlyphCacheHits(), 2u);
+	CHECK_EQ(glyphMismatches(tft, 24, 0, FontDefault, 'A', BG, FG), 0u);
+	tft.resetGlyphCacheStats();
+	CHECK_EQ(tft.getGlyphCacheHits(), 0u);
+	CHECK_EQ(tft.getGlyphCacheMisses(), 0u);
+}
+
+TEST_CASE(least_recently_used_is_replaced)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	tft.setGlyphCache(8 * 8 * 2 * 2);
+	tft.setTextColor(FG, BG);
+	tft.writeChar(0, 0, 'A');
+	tft.writeChar(0, 0, 'B');
+	tft.writeChar(0, 0, 'A'); // B now least recently used
+	tft.writeChar(0, 0, 'C'); // replaces B
+	tft.resetGlyphCacheStats();
+	tft.writeChar(0, 0, 'A');
+	tft.writeChar(0, 0, 'C');
+	CHECK_EQ(tft.getGlyphCacheHits(), 2u);
+	tft.writeChar(0, 0, 'B');
+	CHECK_EQ(tft.getGlyphCacheMisses(), 1u);
+	CHECK_EQ(glyphMismatches(tft, 0, 0, FontDefault, 'B', FG, BG), 0u);
+}
+
+TEST_CASE(run_longer_than_cache_is_drawn)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	tft.setGlyphCache(8 * 8 * 2 * 2);
+	tft.setTextColor(FG, BG);
+	mock_counters_t c = tft.measure([&]{ tft.writeCharString(0, 0, const_cast<char *>("ABCDEF")); });
+	CHECK_EQ(c.addrWindows, 1u);
+	const char *text = "ABCDEF";
+	for (uint16_t i = 0; i < 6; i++)
+		CHECK_EQ(glyphMismatches(tft, i * 8, 0, FontDefault, text[i], FG, BG), 0u);
+}
+
+TEST_CASE(setFont_empties_cache)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	tft.setGlyphCache(1024);
+	CHECK_EQ(tft.getGlyphCacheSlots(), 8u);
+	tft.setTextColor(FG, BG);
+	tft.writeChar(0, 0, 'A');
+	// same font set again still empties the cache
+	tft.setFont(FontDefault);
+	tft.writeChar(0, 0, 'A');
+	CHECK_EQ(tft.getGlyphCacheMisses(), 2u);
+	CHECK_EQ(tft.getGlyphCacheHits(), 0u);
+	// slot size follows the font
+	tft.setFont(FontPico);
+	tft.writeChar(0, 0, 'A');
+	CHECK_EQ(tft.getGlyphCacheSlots(), 5u);
+	CHECK_EQ(glyphMismatches(tft, 0, 0, FontPico, 'A', FG, BG), 0u);
+	tft.clearGlyphCache();
+	tft.writeChar(0, 0, 'A');
+	CHECK_EQ(tft.getGlyphCacheMisses(), 4u);
+	CHECK_EQ(tft.setGlyphCache(0), DisLib16::Success);
+	CHECK_EQ(tft.getGlyphCacheSlots(), 0u);
+	tft.setFont(FontDefault);
+}
+
+TEST_CASE(numeric_field_keeps_cache)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	tft.setGlyphCache(1024);
+	tft.setTextColor(FG, BG);
+	tft.writeChar(0, 0, 'A');
+	// the field swaps its font in and out, the active font slots are kept
+	display16_graphics_LTSM::numeric_field_t field;
+	CHECK_EQ(tft.setNumericField(field, 0, 10, FontSevenSeg, 3), DisLib16::Success);
+	CHECK_EQ(tft.drawNumericField(field, 42), DisLib16::Success);
+	CHECK_EQ(tft.getGlyphCacheSlots(), 8u);
+	tft.writeChar(0, 0, 'A');
+	CHECK_EQ(tft.getGlyphCacheHits(), 1u);
+	CHECK_EQ(tft.getGlyphCacheMisses(), 1u);
+}
+
+TEST_CASE(panel_matches_uncached_render)
+{
+	display16_mock_LTSM plain(W, H), cached(W, H);
+	plain.begin();
+	cached.begin();
+	cached.setGlyphCache(8 * 8 * 2 * 6);
+	textScene(plain);
+	textScene(cached);
+	CHECK_EQ(panelDifferences(plain, cached, W, H), 0u);
+	CHECK(cached.getGlyphCacheHits() > 0u);
+	// with room for every glyph of the scene, the second pass only hits
+	cached.setGlyphCache(8 * 8 * 2 * 64);
+	textScene(cached);
+	cached.resetGlyphCacheStats();
+	textScene(cached);
+	CHECK_EQ(panelDifferences(plain, cached, W, H), 0u);
+	CHECK_EQ(cached.getGlyphCacheMisses(), 0u);
+	CHECK(cached.getGlyphCacheHits() > 0u);
+}
+
+TEST_CASE(screen_buffer_uses_cache)
+{
+	display16_mock_LTSM plain(W, H), cached(W, H);
+	plain.begin();
+	cached.begin();
+	cached.setGlyphCache(8 * 8 * 2 * 6);
+	cached.setBuffer();
+	cached.clearBuffer(0x0000);
+	textScene(plain);
+	textScene(cached);
+	cached.writeBuffer();
+	CHECK_EQ(panelDifferences(plain, cached, W, H), 0u);
+	CHECK(cached.getGlyphCacheHits() > 0u);
+	cached.destroyBuffer();
+}
+
+TEST_MAIN()
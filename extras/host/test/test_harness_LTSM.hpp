@@ -0,0 +1,78 @@
+/*!
+	@file    test_harness_LTSM.hpp
+	@brief   Minimal test harness for the host build of Display16_LTSM. NOT part of the core library.
+	@details Tests register themselves with TEST_CASE, the runner executes them all
+			 and returns non zero if any CHECK failed. No third party framework needed.
+*/
+
+#pragma once
+
+#include <stdio.h>
+#include <vector>
+
+namespace TestLTSM {
+
+/*! @brief A registered test case */
+struct test_case_t
+{
+	const char *name;
+	void (*func)(void);
+};
+
+inline std::vector<test_case_t>& registry(void)
+{
+	static std::vector<test_case_t> cases;
+	return cases;
+}
+
+inline int& failures(void)
+{
+	static int count = 0;
+	return count;
+}
+
+/*! @brief Registers a test case at static initialisation */
+struct registrar_t
+{
+	registrar_t(const char *name, void (*func)(void)) { registry().push_back({name, func}); }
+};
+
+/*!
+	@brief Run all registered test cases
+	@return process exit code, 0 if every check passed
+ */
+inline int runAll(void)
+{
+	int failedCases = 0;
+	for (const test_case_t& tc : registry())
+	{
+		int before = failures();
+		tc.func();
+		bool passed = (failures() == before);
+		if (!passed) failedCases++;
+		printf("[%s] %s\n", passed ? "PASS" : "FAIL", tc.name);
+	}
+	printf("%zu test cases, %d failed\n", registry().size(), failedCases);
+	return failedCases == 0 ? 0 : 1;
+}
+
+} // namespace TestLTSM
+
+#define TEST_CASE(name) \
+	static void name(void); \
+	static TestLTSM::registrar_t name##_registrar(#name, name); \
+	static void name(void)
+
+#define CHECK(cond) \
+	do { if (!(cond)) { \
+		printf("  %s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+		TestLTSM::failures()++; } } while (0)
+
+#define CHECK_EQ(a, b) \
+	do { auto _va = (a); auto _vb = (b); if (!(_va == _vb)) { \
+		printf("  %s:%d: CHECK_EQ failed: %s == %s (%lld vs %lld)\n", __FILE__, __LINE__, #a, #b, \
+			static_cast<long long>(_va), static_cast<long long>(_vb)); \
+		TestLTSM::failures()++; } } while (0)
+
+#define TEST_MAIN() \
+	int main(void) { return TestLTSM::runAll(); }
@@ -0,0 +1,342 @@
+/*!
+	@file    test_imageconv_LTSM.cpp
+	@brief   Host tests for the image converter, bitmaps drawn by the library.
+	@details First argument, if given, is the ltsm_imageconv executable, run on a generated PPM file.
+*/
+
+#include "test_util_LTSM.hpp"
+#include <imageconv_LTSM.hpp>
+#include <bitmap_test_data_LTSM/Bitmap_TEST_Data_16color1.hpp>
+#include <bitmap_test_data_LTSM/Bitmap_TEST_Data_16color2.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <sstream>
+
+using namespace TestLTSM;
+using namespace ImageConvLTSM;
+
+namespace {
+constexpr uint16_t W = 128;
+constexpr uint16_t H = 96;
+std::string converterPath;
+
+// An image of a number of colours, diagonal bands so rows differ
+image_t bands(int width, int height, int colours)
+{
+	image_t image;
+	image.width = width;
+	image.height = height;
+	for (int y = 0; y < height; y++)
+		for (int x = 0; x < width; x++)
+			image.pixels.push_back(static_cast<uint16_t>((((x + 2 * y) % colours) * 0x0841) ^ 0x1234));
+	return image;
+}
+
+// A screen background, vertical gradient with flat panels and a frame
+image_t background(int width, int height)
+{
+	image_t image;
+	image.width = width;
+	image.height = height;
+	for (int y = 0; y < height; y++)
+		for (int x = 0; x < width; x++)
+		{
+			uint16_t color = static_cast<uint16_t>(((y * 31 / height) << 11) | ((y * 20 / height) << 5) | 0x0C);
+			if (x >= 10 && x < width - 10 && (y % 64) >= 16 && (y % 64) < 56)
+				color = ((x == 10 || x == width - 11) ? 0xFFFF : 0x39E7);
+			image.pixels.push_back(color);
+		}
+	return image;
+}
+
+// Pseudo random pixels, nothing to compress
+image_t noise(int width, int height)
+{
+	image_t image;
+	image.width = width;
+	image.height = height;
+	uint32_t state = 12345;
+	for (int i = 0; i < width * height; i++)
+	{
+		state = state * 1103515245u + 12345u;
+		image.pixels.push_back(static_cast<uint16_t>(state >> 16));
+	}
+	return image;
+}
+
+double microsPerDraw(const std::function<void()> &draw, int repeats)
+{
+	const auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < repeats; i++)
+		draw();
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / repeats;
+}
+}
+
+TEST_CASE(indexed_layout)
+{
+	// 3x2, three colours, the most used first
+	const uint8_t rgb565[12] = {0xF8,0x00, 0x00,0x1F, 0x00,0x1F, 0x07,0xE0, 0x00,0x1F, 0xF8,0x00};
+	const image_t image = fromRGB565Bytes(rgb565, 3, 2);
+	CHECK_EQ(paletteOf(image).size(), 3u);
+	CHECK_EQ(paletteOf(image)[0], 0x001F);
+	std::vector<uint8_t> bytes;
+	std::string error;
+	CHECK(encodeIndexed(image, 0, bytes, error));
+	const std::vector<uint8_t> expected = {2, 0, 3, 0, 2, 2, 0x00,0x1F, 0xF8,0x00, 0x07,0xE0,
+		0x40 | 0x00 | 0x00, 0x80 | 0x00 | 0x04}; // 01 00 00, 10 00 01, rows padded
+	CHECK(bytes == expected);
+	CHECK(!encodeIndexed(image, 1, bytes, error));
+	CHECK(!encodeIndexed(image, 3, bytes, error));
+	CHECK_EQ(indexedBitsFor(2), 1);
+	CHECK_EQ(indexedBitsFor(16), 4);
+	CHECK_EQ(indexedBitsFor(17), 8);
+	CHECK_EQ(indexedBitsFor(257), 0);
+}
+
+TEST_CASE(every_depth_draws_like_rgb565)
+{
+	for (int colours : {2, 3, 16, 200})
+	{
+		const image_t image = bands(37, 21, colours);
+		const std::vector<uint8_t> raw = encodeRGB565(image);
+		for (int bits : {0, 8})
+		{
+			std::vector<uint8_t> bytes;
+			std::string error;
+			CHECK(encodeIndexed(image, bits, bytes, error));
+			display16_mock_LTSM indexed(W, H), direct(W, H);
+			indexed.begin();
+			direct.begin();
+			mock_counters_t c = indexed.measure([&]{ CHECK_EQ(indexed.drawBitmapIndexed(5, 7, bytes.data()), DisLib16::Success); });
+			CHECK_EQ(c.addrWindows, 1u);
+			CHECK_EQ(c.pixelsWritten, 37u * 21u);
+			direct.drawBitmap16Data(5, 7, raw.data(), 37, 21);
+			// clipped at the right and bottom edges
+			indexed.drawBitmapIndexed(W - 11, H - 6, bytes.data());
+			direct.drawBitmap16Data(W - 11, H - 6, raw.data(), 37, 21);
+			CHECK_EQ(panelDifferences(indexed, direct, W, H), 0u);
+			if (bits == 0)
+				CHECK(bytes.size() <= raw.size() / 2 + 6 + colours * 2u);
+		}
+	}
+}
+
+TEST_CASE(indexed_errors)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	std::vector<uint8_t> bytes;
+	std::string error;
+	encodeIndexed(bands(4, 4, 4), 2, bytes, error);
+	CHECK_EQ(tft.drawBitmapIndexed(0, 0, nullptr), DisLib16::BitmapDataEmpty);
+	CHECK_EQ(tft.drawBitmapIndexed(W, 0, bytes.data()), DisLib16::BitmapScreenBounds);
+	bytes[0] = 3;
+	CHECK_EQ(tft.drawBitmapIndexed(0, 0, bytes.data()), DisLib16::BitmapFormat);
+	bytes[0] = 2;
+	bytes[2] = 0;
+	CHECK_EQ(tft.drawBitmapIndexed(0, 0, bytes.data()), DisLib16::BitmapFormat);
+	// indices past the palette use its last colour
+	const uint8_t small[] = {2, 0, 4, 0, 1, 1, 0xF8,0x00, 0x07,0xE0, 0x1B};
+	CHECK_EQ(tft.drawBitmapIndexed(0, 0, small), DisLib16::Success);
+	CHECK_EQ(tft.getPanelPixel(0, 0), 0xF800);
+	CHECK_EQ(tft.getPanelPixel(1, 0), 0x07E0);
+	CHECK_EQ(tft.getPanelPixel(2, 0), 0x07E0);
+	CHECK_EQ(tft.getPanelPixel(3, 0), 0x07E0);
+}
+
+TEST_CASE(quantize_keeps_the_closest_colours)
+{
+	const image_t image = bands(40, 8, 40);
+	CHECK_EQ(paletteOf(quantize(image, 64)).size(), 40u); // fits, unchanged
+	const image_t reduced = quantize(image, 16);
+	CHECK_EQ(paletteOf(reduced).size(), 16u);
+	CHECK_EQ(reduced.pixels.size(), image.pixels.size());
+	// two colours far apart stay apart
+	image_t pair;
+	pair.width = 4;
+	pair.height = 1;
+	pair.pixels = {0x0000, 0x0001, 0xFFFF, 0xFFDF};
+	const image_t two = quantize(pair, 2);
+	CHECK_EQ(two.pixels[0], two.pixels[1]);
+	CHECK_EQ(two.pixels[2], two.pixels[3]);
+	CHECK(two.pixels[0] != two.pixels[2]);
+}
+
+TEST_CASE(size_report)
+{
+	const image_t motor = fromRGB565Bytes(MotorImage, 128, 128);
+	std::vector<uint8_t> bytes;
+	std::string error;
+	CHECK(!encodeIndexed(motor, 0, bytes, error)); // a photo, too many colours as it is
+	printf("  MotorImage 128x128: %zu colours, RGB565 %zu bytes\n", paletteOf(motor).size(), sizeof(MotorImage));
+	for (size_t colours : {256u, 16u})
+	{
+		const image_t reduced = quantize(motor, colours);
+		CHECK(encodeIndexed(reduced, 0, bytes, error));
+		uint64_t error2 = 0;
+		for (size_t i = 0; i < motor.pixels.size(); i++)
+		{
+			const int dr = (motor.pixels[i] >> 11) - (reduced.pixels[i] >> 11);
+			const int dg = ((motor.pixels[i] >> 5) & 0x3F) - ((reduced.pixels[i] >> 5) & 0x3F);
+			const int db = (motor.pixels[i] & 0x1F) - (reduced.pixels[i] & 0x1F);
+			error2 += dr * dr + dg * dg + db * db;
+		}
+		printf("  quantized to %3zu colours: indexed %5zu bytes, mean square error %.2f\n", colours, bytes.size(),
+			static_cast<double>(error2) / motor.pixels.size());
+		CHECK(bytes.size() <= sizeof(MotorImage) / 2 + 6 + 512);
+	}
+	const image_t icon = bands(32, 32, 12);
+	encodeIndexed(icon, 0, bytes, error);
+	printf("  Icon 32x32, 12 colours: RGB565 %zu bytes, indexed %zu bytes\n", icon.pixels.size() * 2, bytes.size());
+	CHECK(bytes.size() * 3 < icon.pixels.size() * 2);
+}
+
+TEST_CASE(compressed_layout)
+{
+	// black run, diff, luma, literal, index, run over the row end
+	image_t image;
+	image.width = 6;
+	image.height = 2;
+	image.pixels = {0x0000, 0x0000, 0x0821, 0x2945, 0x8000, 0x0821,
+		0x0821, 0x0821, 0x0821, 0x0821, 0x0821, 0x0821};
+	std::vector<uint8_t> bytes;
+	std::string error;
+	CHECK(encodeCompressed(image, bytes, error));
+	const std::vector<uint8_t> expected = {0x51, 0, 6, 0, 2, 0xC1, 0x7F, 0xA9, 0x88, 0xFE, 0x80, 0x00, 0x0F, 0xC5};
+	CHECK(bytes == expected);
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	CHECK_EQ(tft.drawBitmapCompressed(0, 0, bytes.data()), DisLib16::Success);
+	for (int i = 0; i < 12; i++)
+		CHECK_EQ(tft.getPanelPixel(i % 6, i / 6), image.pixels[i]);
+	// long runs
+	image.width = 100;
+	image.height = 4;
+	image.pixels.assign(400, 0x1234);
+	CHECK(encodeCompressed(image, bytes, error));
+	CHECK_EQ(bytes.size(), 5u + 3u + 4u); // literal, run of 255 + 63, run of 81
+	CHECK_EQ(bytes[8], 0xFF);
+	CHECK_EQ(bytes[9], 0xFF);
+	CHECK_EQ(bytes[10], 0xFF);
+	CHECK_EQ(bytes[11], 81 - 63);
+}
+
+TEST_CASE(compressed_draws_like_rgb565)
+{
+	const image_t images[] = {fromRGB565Bytes(MotorImage, 128, 128), fromRGB565Bytes(PosterImage, 80, 48),
+		fromRGB565Bytes(SpriteTest16, 32, 32), bands(37, 21, 200), background(40, 90), noise(23, 17)};
+	for (const image_t &image : images)
+	{
+		std::vector<uint8_t> bytes;
+		std::string error;
+		CHECK(encodeCompressed(image, bytes, error));
+		const std::vector<uint8_t> raw = encodeRGB565(image);
+		display16_mock_LTSM compressed(W, H), direct(W, H);
+		compressed.begin();
+		direct.begin();
+		mock_counters_t c = compressed.measure([&]{ CHECK_EQ(compressed.drawBitmapCompressed(3, 2, bytes.data()), DisLib16::Success); });
+		CHECK_EQ(c.addrWindows, 1u);
+		direct.drawBitmap16Data(3, 2, raw.data(), image.width, image.height);
+		// clipped at the right and bottom edges
+		compressed.drawBitmapCompressed(W - 11, H - 6, bytes.data());
+		direct.drawBitmap16Data(W - 11, H - 6, raw.data(), image.width, image.height);
+		CHECK_EQ(panelDifferences(compressed, direct, W, H), 0u);
+	}
+}
+
+TEST_CASE(compressed_errors)
+{
+	display16_mock_LTSM tft(W, H);
+	tft.begin();
+	std::vector<uint8_t> bytes;
+	std::string error;
+	encodeCompressed(bands(4, 4, 4), bytes, error);
+	CHECK_EQ(tft.drawBitmapCompressed(0, 0, nullptr), DisLib16::BitmapDataEmpty);
+	CHECK_EQ(tft.drawBitmapCompressed(0, H, bytes.data()), DisLib16::BitmapScreenBounds);
+	bytes[0] = 2; // an indexed bitmap header
+	CHECK_EQ(tft.drawBitmapCompressed(0, 0, bytes.data()), DisLib16::BitmapFormat);
+	bytes[0] = 0x51;
+	bytes[4] = 0;
+	CHECK_EQ(tft.drawBitmapCompressed(0, 0, bytes.data()), DisLib16::BitmapFormat);
+	image_t empty;
+	CHECK(!encodeCompressed(empty, bytes, error));
+}
+
+TEST_CASE(compressed_benchmark)
+{
+	// Library time per draw with the panel model detached, the copy or decode and the SPI calls,
+	// and the wire time of the pixel bytes at a 40 MHz SPI clock, the same for both
+	display16_mock_LTSM tft(240, 320);
+	tft.begin();
+	const struct { const char *name; image_t image; } cases[] = {
+		{"MotorImage 128x128", fromRGB565Bytes(MotorImage, 128, 128)},
+		{"PosterImage 80x48", fromRGB565Bytes(PosterImage, 80, 48)},
+		{"SpriteTest16 32x32", fromRGB565Bytes(SpriteTest16, 32, 32)},
+		{"Background 240x320", background(240, 320)}};
+	printf("  %-20s %8s %8s %5s %10s %10s %10s\n", "image", "RGB565", "compr.", "size", "copy us", "decode us", "wire us");
+	for (const auto &item : cases)
+	{
+		std::vector<uint8_t> bytes;
+		std::string error;
+		encodeCompressed(item.image, bytes, error);
+		const std::vector<uint8_t> raw = encodeRGB565(item.image);
+		const uint16_t w = static_cast<uint16_t>(item.image.width), h = static_cast<uint16_t>(item.image.height);
+		const mock_counters_t copy = tft.measure([&]{ tft.drawBitmap16Data(0, 0, raw.data(), w, h); });
+		const mock_counters_t decode = tft.measure([&]{ tft.drawBitmapCompressed(0, 0, bytes.data()); });
+		CHECK_EQ(copy.dataBytes, decode.dataBytes);
+		ArduinoHost::detachDevice(&tft);
+		const int repeats = 50;
+		const double copyMicros = microsPerDraw([&]{ tft.drawBitmap16Data(0, 0, raw.data(), w, h); }, repeats);
+		const double decodeMicros = microsPerDraw([&]{ tft.drawBitmapCompressed(0, 0, bytes.data()); }, repeats);
+		ArduinoHost::attachDevice(&tft);
+		printf("  %-20s %8zu %8zu %4zu%% %10.1f %10.1f %10.1f\n", item.name, raw.size(), bytes.size(),
+			bytes.size() * 100 / raw.size(), copyMicros, decodeMicros, raw.size() * 8 / 40.0);
+		CHECK(bytes.size() < raw.size());
+	}
+}
+
+TEST_CASE(command_line_writes_a_header)
+{
+	if (converterPath.empty())
+		return;
+	const image_t image = background(20, 70);
+	{
+		std::ofstream ppm("imageconv_test.ppm", std::ios::binary);
+		ppm << "P6\n# test\n20 70\n255\n";
+		for (uint16_t color : image.pixels)
+		{
+			ppm.put(static_cast<char>((color >> 11) << 3));
+			ppm.put(static_cast<char>(((color >> 5) & 0x3F) << 2));
+			ppm.put(static_cast<char>((color & 0x1F) << 3));
+		}
+	}
+	std::ifstream in("imageconv_test.ppm", std::ios::binary);
+	image_t loaded;
+	std::string error;
+	CHECK(loadPPM(in, loaded, error));
+	CHECK(loaded.pixels == image.pixels);
+	std::vector<uint8_t> bytes;
+	encodeCompressed(image, bytes, error);
+	const std::string command = converterPath + " -n ImageTest -o imageconv_test_LTSM.hpp imageconv_test.ppm 2> /dev/null";
+	CHECK_EQ(system(command.c_str()), 0);
+	std::ifstream header("imageconv_test_LTSM.hpp");
+	std::stringstream text;
+	text << header.rdbuf();
+	CHECK(text.str().find("static const uint8_t ImageTest[" + std::to_string(bytes.size()) + "] FLASH_STORAGE") !=
+		std::string::npos);
+	CHECK(text.str().find("0x51,0x00,0x14,0x00,0x46,") != std::string::npos);
+	CHECK_EQ(system((converterPath + " -f indexed -b 1 imageconv_test.ppm > /dev/null 2>&1").c_str()) != 0, true);
+	CHECK_EQ(system((converterPath + " -f indexed -c 2 -b 1 --stats imageconv_test.ppm 2> /dev/null").c_str()), 0);
+	CHECK(system((converterPath + " imageconv_test.raw > /dev/null 2>&1").c_str()) != 0);
+}
+
+int main(int argc, char **argv)
+{
+	if (argc > 1)
+		converterPath = argv[1];
+	return TestLTSM::runAll();
+}
@@ -0,0 +1,379 @@
+/*!
+	@file    test_util_LTSM.hpp
+	@brief   Reference helpers shared by the host tests of Display16_LTSM. NOT part of the core library.
+*/
+
+#pragma once
+
+#include "test_harness_LTSM.hpp"
+#include <display16_mock_LTSM.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace TestLTSM {
+
+/*!
+	@brief Check a glyph cell on the panel against the font bits
+	@return number of mismatching pixels
+ */
+inline uint32_t glyphMismatches(const display16_mock_LTSM& tft, uint16_t x, uint16_t y,
+	const uint8_t *font, char value, uint16_t fg, uint16_t bg)
+{
+	uint8_t fontX = font[0], fontY = font[1], offset = font[2];
+	uint32_t bytesPerChar = (fontX * fontY) / 8;
+	const uint8_t *glyph = font + 4 + (static_cast<uint8_t>(value) - offset) * bytesPerChar;
+	uint32_t errors = 0;
+	for (uint16_t cy = 0; cy < fontY; cy++)
+	{
+		for (uint16_t cx = 0; cx < fontX; cx++)
+		{
+			uint8_t byte = glyph[cy * (fontX / 8) + cx / 8];
+			uint16_t expected = (byte & (0x80 >> (cx % 8))) ? fg : bg;
+			if (tft.getPanelPixel(x + cx, y + cy) != expected)
+				errors++;
+		}
+	}
+	return errors;
+}
+
+/*!
+	@brief Count panel pixels in a rectangle that differ from a colour
+ */
+inline uint32_t rectMismatches(const display16_mock_LTSM& tft, uint16_t x, uint16_t y,
+	uint16_t w, uint16_t h, uint16_t color)
+{
+	uint32_t errors = 0;
+	for (uint16_t j = 0; j < h; j++)
+		for (uint16_t i = 0; i < w; i++)
+			if (tft.getPanelPixel(x + i, y + j) != color)
+				errors++;
+	return errors;
+}
+
+/*!
+	@brief Count pixels of the whole panel equal to a colour
+ */
+inline uint32_t countColor(const display16_mock_LTSM& tft, uint16_t w, uint16_t h, uint16_t color)
+{
+	uint32_t count = 0;
+	for (uint16_t j = 0; j < h; j++)
+		for (uint16_t i = 0; i < w; i++)
+			if (tft.getPanelPixel(i, j) == color)
+				count++;
+	return count;
+}
+
+/*!
+	@brief Count pixels that differ between two panels of the same size
+ */
+inline uint32_t panelDifferences(const display16_mock_LTSM& a, const display16_mock_LTSM& b,
+	uint16_t w, uint16_t h)
+{
+	uint32_t count = 0;
+	for (uint16_t j = 0; j < h; j++)
+		for (uint16_t i = 0; i < w; i++)
+			if (a.getPanelPixel(i, j) != b.getPanelPixel(i, j))
+				count++;
+	return count;
+}
+
+/*!
+	@brief Check a scaled cell on one panel against the unscaled cell on another,
+		each pixel of the small cell a scale x scale block of the big one
+	@return number of mismatching pixels
+ */
+inline uint32_t scaledCellMismatches(const display16_mock_LTSM& small, uint16_t sx, uint16_t sy,
+	const display16_mock_LTSM& big, uint16_t bx, uint16_t by, uint16_t w, uint16_t h, uint8_t scale)
+{
+	uint32_t errors = 0;
+	for (uint16_t y = 0; y < h * scale; y++)
+		for (uint16_t x = 0; x < w * scale; x++)
+			if (big.getPanelPixel(bx + x, by + y) != small.getPanelPixel(sx + x / scale, sy + y / scale))
+				errors++;
+	return errors;
+}
+
+/*!
+	@brief Print the counters of one draw call, used for the traffic report
+ */
+inline void printCounters(const char *label, const mock_counters_t& c)
+{
+	printf("  %-28s bytes %7u  data %7u  spiCalls %6u  trans %5u  cs %5u  dc %5u  windows %5u\n",
+		label, c.bytesSent, c.dataBytes, c.spiCalls, c.transactions, c.csToggles, c.dcToggles, c.addrWindows);
+}
+
+/*!
+	@brief Glyphs held by a fixed font
+	@param fixed fixed font
+	@param fixedSize bytes in the font array
+	@details Control byte 3 is last - first in some bundled fonts and the glyph count in others, 
+		so the count is bounded by the glyph data in the array.
+ */
+inline uint16_t fixedGlyphCount(const uint8_t *fixed, size_t fixedSize)
+{
+	const size_t bytesPerChar = (static_cast<size_t>(fixed[0]) * fixed[1]) / 8;
+	const size_t inData = (fixedSize - 4) / bytesPerChar;
+	return static_cast<uint16_t>(std::min<size_t>(fixed[3] + 1u, inData));
+}
+
+/*!
+	@brief Build an extended font from a fixed font
+	@param fixed fixed font
+	@param fixedSize bytes in the font array
+	@param type 1 proportional, packed glyph bits, 2 compressed, rows of runs
+	@param trim true: blank columns and rows trimmed, glyphs get a 1 pixel left bearing and 1 pixel after,
+		blank glyphs an advance of half a cell. false: cells of the fixed font.
+ */
+inline std::vector<uint8_t> makeExtendedFont(const uint8_t *fixed, size_t fixedSize, uint8_t type, bool trim)
+{
+	const uint8_t fontX = fixed[0], fontY = fixed[1], offset = fixed[2];
+	const uint16_t numChars = fixedGlyphCount(fixed, fixedSize);
+	const uint32_t bytesPerChar = (fontX * fontY) / 8;
+	std::vector<uint8_t> font = {0x00, type, fontY, offset, static_cast<uint8_t>(numChars - 1), 0x00};
+	std::vector<uint8_t> table, data;
+	for (uint16_t i = 0; i < numChars; i++)
+	{
+		const uint8_t *glyph = fixed + 4 + i * bytesPerChar;
+		auto on = [&](int cx, int cy) { return (glyph[cy * (fontX / 8) + cx / 8] & (0x80 >> (cx % 8))) != 0; };
+		int minX = fontX, maxX = -1, minY = fontY, maxY = -1;
+		for (int cy = 0; cy < fontY; cy++)
+			for (int cx = 0; cx < fontX; cx++)
+				if (on(cx, cy))
+				{
+					if (cx < minX) minX = cx;
+					if (cx > maxX) maxX = cx;
+					if (cy < minY) minY = cy;
+					if (cy > maxY) maxY = cy;
+				}
+		const bool blank = trim && maxX < 0;
+		if (!trim || blank)
+		{
+			minX = 0;
+			maxX = fontX - 1;
+			minY = 0;
+			maxY = fontY - 1;
+		}
+		const uint8_t w = blank ? 0 : maxX - minX + 1;
+		const uint8_t h = blank ? 0 : maxY - minY + 1;
+		const uint8_t xOff = (trim && !blank) ? 1 : 0;
+		const uint8_t yOff = blank ? 0 : minY;
+		const uint8_t advance = !trim ? fontX : (blank ? fontX / 2 : w + 2);
+		const uint16_t offsetBytes = static_cast<uint16_t>(data.size());
+		if (type == 1)
+		{
+			uint32_t bit = 0;
+			for (int cy = 0; cy < h; cy++)
+				for (int cx = 0; cx < w; cx++, bit++)
+				{
+					if ((bit & 7) == 0)
+						data.push_back(0);
+					if (on(minX + cx, minY + cy))
+						data.back() |= 0x80 >> (bit & 7);
+				}
+		}
+		else // rows of runs: 1lllllll foreground, 00llllll background, 01rrrrrr repeat last row
+		{
+			std::vector<int> lastRow;
+			int repeats = 0;
+			for (int cy = 0; cy < fontY; cy++)
+			{
+				std::vector<int> row;
+				for (int cx = 0; cx < advance; cx++)
+				{
+					const int gx = cx - xOff + minX;
+					row.push_back((!blank && cx >= xOff && cx < xOff + w && cy >= minY && cy <= maxY && on(gx, cy)) ? 1 : 0);
+				}
+				if (cy > 0 && row == lastRow && repeats < 64)
+				{
+					repeats++;
+					continue;
+				}
+				if (repeats > 0)
+					data.push_back(static_cast<uint8_t>(0x40 | (repeats - 1)));
+				repeats = 0;
+				if (cy > 0 && row == lastRow) // 64 repeats done, one more
+				{
+					repeats = 1;
+					continue;
+				}
+				for (int cx = 0; cx < advance;)
+				{
+					const int maxRun = row[cx] ? 128 : 64;
+					int length = 0;
+					while (cx + length < advance && row[cx + length] == row[cx] && length < maxRun)
+						length++;
+					data.push_back(static_cast<uint8_t>((row[cx] ? 0x80 : 0x00) | (length - 1)));
+					cx += length;
+				}
+				lastRow = row;
+			}
+			if (repeats > 0)
+				data.push_back(static_cast<uint8_t>(0x40 | (repeats - 1)));
+		}
+		const uint8_t entry[8] = {static_cast<uint8_t>(offsetBytes >> 8), static_cast<uint8_t>(offsetBytes & 0xFF),
+			w, h, xOff, yOff, advance, 0};
+		table.insert(table.end(), entry, entry + 8);
+	}
+	font.insert(font.end(), table.begin(), table.end());
+	font.insert(font.end(), data.begin(), data.end());
+	return font;
+}
+
+/*! @brief makeExtendedFont of a font array, sized by its type */
+template <size_t N>
+inline std::vector<uint8_t> makeExtendedFont(const uint8_t (&fixed)[N], uint8_t type, bool trim)
+{
+	return makeExtendedFont(fixed, N, type, trim);
+}
+
+/*!
+	@brief Build a proportional font from a fixed font, blank columns and rows trimmed
+ */
+template <size_t N>
+inline std::vector<uint8_t> makeProportionalFont(const uint8_t (&fixed)[N])
+{
+	return makeExtendedFont(fixed, N, 1, true);
+}
+
+/*!
+	@brief Build an anti-aliased font from a fixed font, full cells, set pixels at full coverage
+		and a partial coverage edge next to them, so every level up to the top is used
+	@param fixedSize bytes in the font array
+	@param bitsPerPixel 2 or 4, font type 3 or 4
+ */
+inline std::vector<uint8_t> makeAntiAliasedFont(const uint8_t *fixed, size_t fixedSize, uint8_t bitsPerPixel)
+{
+	const uint8_t fontX = fixed[0], fontY = fixed[1], offset = fixed[2];
+	const uint16_t numChars = fixedGlyphCount(fixed, fixedSize);
+	const uint32_t bytesPerChar = (fontX * fontY) / 8;
+	const int top = (1 << bitsPerPixel) - 1;
+	std::vector<uint8_t> font = {0x00, static_cast<uint8_t>(bitsPerPixel == 4 ? 4 : 3), fontY, offset,
+		static_cast<uint8_t>(numChars - 1), 0x00};
+	std::vector<uint8_t> table, data;
+	for (uint16_t i = 0; i < numChars; i++)
+	{
+		const uint8_t *glyph = fixed + 4 + i * bytesPerChar;
+		auto on = [&](int cx, int cy) {
+			return cx >= 0 && cy >= 0 && cx < fontX && cy < fontY &&
+				(glyph[cy * (fontX / 8) + cx / 8] & (0x80 >> (cx % 8))) != 0; };
+		const uint16_t offsetBytes = static_cast<uint16_t>(data.size());
+		uint32_t bit = 0;
+		for (int cy = 0; cy < fontY; cy++)
+			for (int cx = 0; cx < fontX; cx++, bit += bitsPerPixel)
+			{
+				int level = top;
+				if (!on(cx, cy))
+				{
+					const int touching = on(cx - 1, cy) + on(cx + 1, cy) + on(cx, cy - 1) + on(cx, cy + 1);
+					level = (touching * top) / 5;
+				}
+				if ((bit & 7) == 0)
+					data.push_back(0);
+				data.back() |= static_cast<uint8_t>(level << (8 - bitsPerPixel - (bit & 7)));
+			}
+		const uint8_t entry[8] = {static_cast<uint8_t>(offsetBytes >> 8), static_cast<uint8_t>(offsetBytes & 0xFF),
+			fontX, fontY, 0, 0, fontX, 0};
+		table.insert(table.end(), entry, entry + 8);
+	}
+	font.insert(font.end(), table.begin(), table.end());
+	font.insert(font.end(), data.begin(), data.end());
+	return font;
+}
+
+/*! @brief makeAntiAliasedFont of a font array, sized by its type */
+template <size_t N>
+inline std::vector<uint8_t> makeAntiAliasedFont(const uint8_t (&fixed)[N], uint8_t bitsPerPixel)
+{
+	return makeAntiAliasedFont(fixed, N, bitsPerPixel);
+}
+
+/*!
+	@brief Add a codepoint map to an extended font, the glyph table moves after it
+	@param entries codepoint and font character pairs, sorted by codepoint
+ */
+inline std::vector<uint8_t> withCodepointMap(const std::vector<uint8_t>& font,
+	const std::vector<std::pair<uint32_t, uint8_t>>& entries)
+{
+	std::vector<uint8_t> mapped(font.begin(), font.begin() + 6);
+	mapped[5] |= 0x01;
+	mapped.push_back(static_cast<uint8_t>(entries.size()));
+	for (const auto& entry : entries)
+	{
+		const uint8_t bytes[4] = {static_cast<uint8_t>(entry.first >> 16), static_cast<uint8_t>((entry.first >> 8) & 0xFF),
+			static_cast<uint8_t>(entry.first & 0xFF), entry.second};
+		mapped.insert(mapped.end(), bytes, bytes + 4);
+	}
+	mapped.insert(mapped.end(), font.begin() + 6, font.end());
+	return mapped;
+}
+
+/*!
+	@brief Reference blend of two RGB565 colours, level of top, rounded per channel
+ */
+inline uint16_t blend565(uint16_t fg, uint16_t bg, int level, int top)
+{
+	auto mix = [&](int f, int b) { return (b * (top - level) + f * level + top / 2) / top; };
+	return static_cast<uint16_t>((mix(fg >> 11, bg >> 11) << 11) | (mix((fg >> 5) & 0x3F, (bg >> 5) & 0x3F) << 5) |
+		mix(fg & 0x1F, bg & 0x1F));
+}
+
+/*!
+	@brief Check an anti-aliased glyph cell on the panel against the font coverage blended fg over bg
+	@return number of mismatching pixels
+ */
+inline uint32_t aaGlyphMismatches(const display16_mock_LTSM& tft, uint16_t x, uint16_t y,
+	const std::vector<uint8_t>& font, char value, uint16_t fg, uint16_t bg)
+{
+	const int bpp = (font[1] == 4) ? 4 : 2, top = (1 << bpp) - 1;
+	const uint8_t *entry = &font[6 + (static_cast<uint8_t>(value) - font[3]) * 8];
+	const uint8_t *glyph = &font[6 + (font[4] + 1) * 8 + ((entry[0] << 8) | entry[1])];
+	uint32_t errors = 0;
+	for (int cy = 0; cy < entry[3]; cy++)
+		for (int cx = 0; cx < entry[2]; cx++)
+		{
+			const int bit = (cy * entry[2] + cx) * bpp;
+			const int level = (glyph[bit / 8] >> (8 - bpp - bit % 8)) & top;
+			if (tft.getPanelPixel(x + cx, y + cy) != blend565(fg, bg, level, top))
+				errors++;
+		}
+	return errors;
+}
+
+/*!
+	@brief Advance of a character in a proportional font
+ */
+inline uint8_t propAdvance(const std::vector<uint8_t>& font, char value)
+{
+	return font[6 + (static_cast<uint8_t>(value) - font[3]) * 8 + 6];
+}
+
+/*!
+	@brief Check a proportional glyph cell, advance by line height, on the panel against the font
+	@return number of mismatching pixels
+ */
+inline uint32_t propGlyphMismatches(const display16_mock_LTSM& tft, uint16_t x, uint16_t y,
+	const std::vector<uint8_t>& font, char value, uint16_t fg, uint16_t bg)
+{
+	const uint8_t *entry = &font[6 + (static_cast<uint8_t>(value) - font[3]) * 8];
+	const uint8_t *glyph = &font[6 + (font[4] + 1) * 8 + ((entry[0] << 8) | entry[1])];
+	const int w = entry[2], h = entry[3], xOff = static_cast<int8_t>(entry[4]), yOff = static_cast<int8_t>(entry[5]);
+	uint32_t errors = 0;
+	for (int cy = 0; cy < font[2]; cy++)
+	{
+		for (int cx = 0; cx < entry[6]; cx++)
+		{
+			const int gx = cx - xOff, gy = cy - yOff;
+			bool on = false;
+			if (gx >= 0 && gy >= 0 && gx < w && gy < h)
+			{
+				const int bit = gy * w + gx;
+				on = (glyph[bit / 8] & (0x80 >> (bit % 8))) != 0;
+			}
+			if (tft.getPanelPixel(x + cx, y + cy) != (on ? fg : bg))
+				errors++;
+		}
+	}
+	return errors;
+}
+
+} // namespace TestLTSM
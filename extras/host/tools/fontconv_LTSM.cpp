@@ -0,0 +1,697 @@
+/*!
+	@file    fontconv_LTSM.cpp
+	@brief   Font converter for Display16_LTSM, readers, encoders and header writer.
+		Host tool, NOT part of the core library.
+*/
+
+#include "fontconv_LTSM.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+namespace FontConvLTSM {
+
+namespace {
+
+constexpr int kExtHeader = 6;   // control bytes of an extended font
+constexpr int kGlyphEntry = 8;  // bytes per glyph table entry
+constexpr int kCodepointEntry = 4; // bytes per codepoint map entry
+constexpr uint8_t kFlagCodepointMap = 0x01; // flags bit, codepoint map after the control bytes
+
+// Next whitespace separated token of a PGM file, skipping # comments
+bool pgmToken(std::istream &in, std::string &token)
+{
+	token.clear();
+	int c;
+	while ((c = in.get()) != EOF)
+	{
+		if (c == '#')
+		{
+			while ((c = in.get()) != EOF && c != '\n') {}
+			continue;
+		}
+		if (!isspace(c))
+		{
+			token.push_back(static_cast<char>(c));
+			break;
+		}
+	}
+	while ((c = in.peek()) != EOF && !isspace(c))
+		token.push_back(static_cast<char>(in.get()));
+	return !token.empty();
+}
+
+// Comment text for a character, safe at the end of a C++ line
+std::string charName(int code)
+{
+	char text[16];
+	if (code == ' ')
+		return "<Space>";
+	if (code == '\\')
+		return "<Backslash>";
+	if (code > ' ' && code < 0x7F)
+	{
+		snprintf(text, sizeof(text), "%c", code);
+		return text;
+	}
+	snprintf(text, sizeof(text), "0x%02X", code);
+	return text;
+}
+
+// Appends the run codes of one glyph cell, rows of runs with row repeats
+void encodeRuns(const glyph_t &glyph, int lineHeight, std::vector<uint8_t> &out)
+{
+	std::vector<uint8_t> lastRow;
+	int repeats = 0;
+	for (int cy = 0; cy < lineHeight; cy++)
+	{
+		std::vector<uint8_t> row(glyph.advance);
+		for (int cx = 0; cx < glyph.advance; cx++)
+			row[cx] = glyph.cellPixel(cx, cy) ? 1 : 0;
+		if (cy > 0 && row == lastRow)
+		{
+			if (repeats == 64)
+			{
+				out.push_back(static_cast<uint8_t>(0x40 | (repeats - 1)));
+				repeats = 0;
+			}
+			repeats++;
+			continue;
+		}
+		if (repeats > 0)
+			out.push_back(static_cast<uint8_t>(0x40 | (repeats - 1)));
+		repeats = 0;
+		for (int cx = 0; cx < glyph.advance;)
+		{
+			const int maxRun = row[cx] ? 128 : 64;
+			int length = 0;
+			while (cx + length < glyph.advance && row[cx + length] == row[cx] && length < maxRun)
+				length++;
+			out.push_back(static_cast<uint8_t>((row[cx] ? 0x80 : 0x00) | (length - 1)));
+			cx += length;
+		}
+		lastRow = row;
+	}
+	if (repeats > 0)
+		out.push_back(static_cast<uint8_t>(0x40 | (repeats - 1)));
+}
+
+// Ink coverage of a PGM grey level, threshold-1 and darker map to 128 and up
+uint8_t pgmCoverage(int grey, int maxValue, int threshold)
+{
+	threshold = std::max(1, std::min(threshold, maxValue));
+	if (grey < threshold)
+		return static_cast<uint8_t>(128 + ((threshold - 1 - grey) * 127) / std::max(threshold - 1, 1));
+	return static_cast<uint8_t>(((maxValue - grey) * 127) / std::max(maxValue - threshold, 1));
+}
+
+int fixedCellWidth(const font_t &font, int first, int last)
+{
+	int width = 0;
+	for (int code = first; code <= last; code++)
+	{
+		auto it = font.glyphs.find(code);
+		if (it != font.glyphs.end())
+			width = std::max(width, it->second.advance);
+	}
+	return std::max(8, (width + 7) & ~7);
+}
+
+} // namespace
+
+/*!
+	@brief Is a pixel of the glyph cell ink
+	@param cx column in the cell
+	@param cy row in the cell
+	@return true for ink
+*/
+bool glyph_t::cellPixel(int cx, int cy) const
+{
+	const int gx = cx - xOffset;
+	const int gy = cy - yOffset;
+	if (gx < 0 || gy < 0 || gx >= width || gy >= height)
+		return false;
+	return pixel(gx, gy);
+}
+
+/*!
+	@brief Ink coverage of a pixel of the glyph cell
+	@param cx column in the cell
+	@param cy row in the cell
+	@return 0 for none up to 255 for full ink
+*/
+uint8_t glyph_t::cellCoverage(int cx, int cy) const
+{
+	const int gx = cx - xOffset;
+	const int gy = cy - yOffset;
+	if (gx < 0 || gy < 0 || gx >= width || gy >= height)
+		return 0;
+	return coverage(gx, gy);
+}
+
+/*!
+	@brief Trims a glyph to its ink, any coverage, and keeps it inside its cell
+	@param glyph glyph, changed in place
+	@param lineHeight rows of the cell, ink below is dropped
+	@details Ink left of the cell or above the line is dropped, ink right of the
+		advance widens the cell so no ink is lost.
+*/
+void fitGlyph(glyph_t &glyph, int lineHeight)
+{
+	int minX = glyph.width, maxX = -1, minY = glyph.height, maxY = -1;
+	for (int y = 0; y < glyph.height; y++)
+	{
+		const int cy = y + glyph.yOffset;
+		if (cy < 0 || cy >= lineHeight)
+			continue;
+		for (int x = 0; x < glyph.width; x++)
+		{
+			if (x + glyph.xOffset < 0 || glyph.coverage(x, y) == 0)
+				continue;
+			minX = std::min(minX, x);
+			maxX = std::max(maxX, x);
+			minY = std::min(minY, y);
+			maxY = std::max(maxY, y);
+		}
+	}
+	glyph_t fitted;
+	fitted.advance = std::max(glyph.advance, 0);
+	if (maxX >= 0)
+	{
+		fitted.width = maxX - minX + 1;
+		fitted.height = maxY - minY + 1;
+		fitted.xOffset = glyph.xOffset + minX;
+		fitted.yOffset = glyph.yOffset + minY;
+		fitted.pixels.resize(static_cast<size_t>(fitted.width) * fitted.height);
+		for (int y = 0; y < fitted.height; y++)
+			for (int x = 0; x < fitted.width; x++)
+				fitted.pixels[static_cast<size_t>(y) * fitted.width + x] = glyph.coverage(minX + x, minY + y);
+		fitted.advance = std::max(fitted.advance, fitted.xOffset + fitted.width);
+	}
+	glyph = fitted;
+}
+
+/*!
+	@brief Reads a BDF bitmap font
+	@param in BDF text
+	@param font filled with the glyphs that have an ENCODING, line height FONT_ASCENT + FONT_DESCENT
+	@param error set on failure
+	@return true on success
+*/
+bool loadBDF(std::istream &in, font_t &font, std::string &error)
+{
+	int ascent = -1, descent = -1;
+	int boxHeight = 0, boxYOffset = 0;
+	std::string line;
+	std::vector<glyph_t> pending;
+	std::vector<int> pendingCodes;
+	std::vector<int> pendingBottoms; // BBX y offset, from the baseline
+	bool started = false;
+	while (std::getline(in, line))
+	{
+		std::istringstream words(line);
+		std::string key;
+		words >> key;
+		if (key == "STARTFONT")
+			started = true;
+		else if (key == "FONTBOUNDINGBOX")
+		{
+			int w = 0, xo = 0;
+			words >> w >> boxHeight >> xo >> boxYOffset;
+		}
+		else if (key == "FONT_ASCENT")
+			words >> ascent;
+		else if (key == "FONT_DESCENT")
+			words >> descent;
+		else if (key == "STARTCHAR")
+		{
+			glyph_t glyph;
+			int code = -1, bottom = 0;
+			bool inBitmap = false;
+			int row = 0;
+			while (std::getline(in, line))
+			{
+				std::istringstream fields(line);
+				std::string field;
+				fields >> field;
+				if (field == "ENDCHAR")
+					break;
+				if (inBitmap)
+				{
+					if (row >= glyph.height)
+						continue;
+					for (int x = 0; x < glyph.width; x++)
+					{
+						const size_t nibble = x / 4;
+						if (nibble >= field.size())
+						{
+							error = "BDF bitmap row too short";
+							return false;
+						}
+						const int value = std::stoi(field.substr(nibble, 1), nullptr, 16);
+						glyph.pixels[static_cast<size_t>(row) * glyph.width + x] = ((value >> (3 - (x % 4))) & 1) ? 255 : 0;
+					}
+					row++;
+				}
+				else if (field == "ENCODING")
+					fields >> code;
+				else if (field == "DWIDTH")
+					fields >> glyph.advance;
+				else if (field == "BBX")
+				{
+					fields >> glyph.width >> glyph.height >> glyph.xOffset >> bottom;
+					glyph.pixels.assign(static_cast<size_t>(std::max(glyph.width, 0)) * std::max(glyph.height, 0), 0);
+				}
+				else if (field == "BITMAP")
+					inBitmap = true;
+			}
+			if (code >= 0)
+			{
+				pending.push_back(glyph);
+				pendingCodes.push_back(code);
+				pendingBottoms.push_back(bottom);
+			}
+		}
+	}
+	if (!started)
+	{
+		error = "not a BDF file, no STARTFONT";
+		return false;
+	}
+	if (ascent < 0 || descent < 0)
+	{
+		ascent = boxHeight + boxYOffset;
+		descent = -boxYOffset;
+	}
+	font.lineHeight = ascent + descent;
+	if (font.lineHeight <= 0 || font.lineHeight > 255)
+	{
+		error = "line height out of range 1-255";
+		return false;
+	}
+	for (size_t i = 0; i < pending.size(); i++)
+	{
+		glyph_t glyph = pending[i];
+		glyph.yOffset = ascent - (pendingBottoms[i] + glyph.height);
+		fitGlyph(glyph, font.lineHeight);
+		font.glyphs[pendingCodes[i]] = glyph;
+	}
+	return true;
+}
+
+/*!
+	@brief Reads a bitmap sheet, a PGM image (P2 or P5) of equal cells in character order
+	@param in PGM file
+	@param cellWidth cell width in pixels
+	@param cellHeight cell height in pixels, the line height
+	@param first code of the top left cell, cells run left to right then down
+	@param threshold grey level below which a pixel is ink, dark text on a light sheet
+	@details Grey levels become ink coverage, the threshold maps to the middle so 1 bit formats
+		cut there, the anti-aliased formats keep the grey steps either side of it.
+	@param spacing less than 0: advance is the cell width, else ink width + spacing
+	@param font filled with a glyph per cell, blank cells included
+	@param error set on failure
+	@return true on success
+*/
+bool loadPGM(std::istream &in, int cellWidth, int cellHeight, int first, int threshold, int spacing,
+	font_t &font, std::string &error)
+{
+	std::string magic, token;
+	if (!pgmToken(in, magic) || (magic != "P2" && magic != "P5"))
+	{
+		error = "not a PGM file, P2 or P5 expected";
+		return false;
+	}
+	int dims[3] = {0, 0, 0};
+	for (int &value : dims)
+	{
+		if (!pgmToken(in, token))
+		{
+			error = "PGM header truncated";
+			return false;
+		}
+		value = std::stoi(token);
+	}
+	const int width = dims[0], height = dims[1], maxValue = dims[2];
+	if (width <= 0 || height <= 0 || maxValue <= 0 || maxValue > 255)
+	{
+		error = "PGM size or maximum value not supported, 8 bit grey only";
+		return false;
+	}
+	if (cellWidth <= 0 || cellHeight <= 0 || cellWidth > width || cellHeight > height || cellHeight > 255)
+	{
+		error = "cell size does not fit the sheet";
+		return false;
+	}
+	std::vector<uint8_t> grey(static_cast<size_t>(width) * height);
+	if (magic == "P5")
+	{
+		in.get(); // single whitespace after the header
+		in.read(reinterpret_cast<char *>(grey.data()), grey.size());
+		if (static_cast<size_t>(in.gcount()) != grey.size())
+		{
+			error = "PGM pixel data truncated";
+			return false;
+		}
+	}
+	else
+	{
+		for (uint8_t &value : grey)
+		{
+			if (!pgmToken(in, token))
+			{
+				error = "PGM pixel data truncated";
+				return false;
+			}
+			value = static_cast<uint8_t>(std::stoi(token));
+		}
+	}
+	font.lineHeight = cellHeight;
+	const int columns = width / cellWidth;
+	const int rows = height / cellHeight;
+	for (int cell = 0; cell < columns * rows && first + cell <= 255; cell++)
+	{
+		const int left = (cell % columns) * cellWidth;
+		const int top = (cell / columns) * cellHeight;
+		glyph_t glyph;
+		glyph.advance = cellWidth;
+		glyph.width = cellWidth;
+		glyph.height = cellHeight;
+		glyph.pixels.resize(static_cast<size_t>(cellWidth) * cellHeight);
+		for (int y = 0; y < cellHeight; y++)
+			for (int x = 0; x < cellWidth; x++)
+				glyph.pixels[static_cast<size_t>(y) * cellWidth + x] =
+					pgmCoverage(grey[static_cast<size_t>(top + y) * width + left + x], maxValue, threshold);
+		fitGlyph(glyph, cellHeight);
+		if (spacing >= 0)
+		{
+			if (glyph.width > 0)
+			{
+				glyph.xOffset = spacing / 2;
+				glyph.advance = glyph.width + spacing;
+			}
+			else
+				glyph.advance = cellWidth / 2;
+		}
+		font.glyphs[first + cell] = glyph;
+	}
+	return true;
+}
+
+/*!
+	@brief Keeps the glyphs of a range, and of a subset if given
+	@param font source font
+	@param first first code kept
+	@param last last code kept
+	@param subset characters kept, empty keeps the whole range
+	@return font with the kept glyphs
+*/
+font_t selectGlyphs(const font_t &font, int first, int last, const std::string &subset)
+{
+	font_t selected;
+	selected.lineHeight = font.lineHeight;
+	for (const auto &entry : font.glyphs)
+	{
+		if (entry.first < first || entry.first > last)
+			continue;
+		if (!subset.empty() && subset.find(static_cast<char>(entry.first)) == std::string::npos)
+			continue;
+		selected.glyphs[entry.first] = entry.second;
+	}
+	return selected;
+}
+
+/*!
+	@brief Encodes a font range in one of the fonts_LTSM formats
+	@param font glyphs, codes in range without a glyph are blank, advance 0 except in the fixed format
+	@param first first character
+	@param last last character, at most 254 after first
+	@param format output format
+	@param out font bytes
+	@param error set on failure
+	@param codepoints Unicode codepoints past the range, their glyphs take the characters after last 
+		and a codepoint map is written, with the range characters from 0x80 mapped to themselves
+	@return true on success
+*/
+bool encode(const font_t &font, int first, int last, format_e format, std::vector<uint8_t> &out, std::string &error,
+	const std::vector<int> &codepoints)
+{
+	out.clear();
+	if (first < 0 || last > 255 || last < first || (last - first) > 0xFE)
+	{
+		error = "character range must be within 0-255 and hold at most 255 characters";
+		return false;
+	}
+	std::vector<int> extra(codepoints);
+	std::sort(extra.begin(), extra.end());
+	extra.erase(std::unique(extra.begin(), extra.end()), extra.end());
+	if (!extra.empty())
+	{
+		if (format == FormatFixed)
+		{
+			error = "the fixed format has no codepoint map";
+			return false;
+		}
+		if (extra.front() <= last || extra.front() < 0x80 || extra.back() > 0x10FFFF)
+		{
+			error = "codepoints must be past the character range, and 0x80 to 0x10FFFF";
+			return false;
+		}
+		if (last + static_cast<int>(extra.size()) > 255 || (last - first) + static_cast<int>(extra.size()) > 0xFE)
+		{
+			error = "character range and codepoints hold more than 255 characters";
+			return false;
+		}
+	}
+	const glyph_t blank;
+	if (format == FormatFixed)
+	{
+		const int cellWidth = fixedCellWidth(font, first, last);
+		if (cellWidth > 255)
+		{
+			error = "glyphs too wide for the fixed format";
+			return false;
+		}
+		out = {static_cast<uint8_t>(cellWidth), static_cast<uint8_t>(font.lineHeight),
+			static_cast<uint8_t>(first), static_cast<uint8_t>(last - first)};
+		for (int code = first; code <= last; code++)
+		{
+			auto it = font.glyphs.find(code);
+			const glyph_t &glyph = (it != font.glyphs.end()) ? it->second : blank;
+			for (int cy = 0; cy < font.lineHeight; cy++)
+				for (int bx = 0; bx < cellWidth; bx += 8)
+				{
+					uint8_t bits = 0;
+					for (int b = 0; b < 8; b++)
+						if (glyph.cellPixel(bx + b, cy))
+							bits |= 0x80 >> b;
+					out.push_back(bits);
+				}
+		}
+		return true;
+	}
+	// source code of each character, the range then the codepoints
+	std::vector<int> sources;
+	std::vector<uint8_t> map;
+	for (int code = first; code <= last; code++)
+		sources.push_back(code);
+	sources.insert(sources.end(), extra.begin(), extra.end());
+	for (size_t i = 0; i < sources.size() && !extra.empty(); i++)
+	{
+		const int source = sources[i];
+		if (source < 0x80 || (source <= last && font.glyphs.find(source) == font.glyphs.end()))
+			continue;
+		const uint8_t entry[kCodepointEntry] = {static_cast<uint8_t>(source >> 16), static_cast<uint8_t>((source >> 8) & 0xFF),
+			static_cast<uint8_t>(source & 0xFF), static_cast<uint8_t>(first + i)};
+		map.insert(map.end(), entry, entry + kCodepointEntry);
+	}
+	std::vector<uint8_t> table, data;
+	for (size_t i = 0; i < sources.size(); i++)
+	{
+		const int code = sources[i];
+		auto it = font.glyphs.find(code);
+		const glyph_t &glyph = (it != font.glyphs.end()) ? it->second : blank;
+		if (glyph.advance > 255 || glyph.width > 255 || glyph.height > 255 || glyph.xOffset > 127 || glyph.yOffset > 127)
+		{
+			error = "glyph " + charName(code) + " too large for the glyph table";
+			return false;
+		}
+		if (data.size() > 0xFFFF)
+		{
+			error = "glyph data over 64 KB, use a smaller range";
+			return false;
+		}
+		const uint16_t offset = static_cast<uint16_t>(data.size());
+		const uint8_t entry[kGlyphEntry] = {static_cast<uint8_t>(offset >> 8), static_cast<uint8_t>(offset & 0xFF),
+			static_cast<uint8_t>(glyph.width), static_cast<uint8_t>(glyph.height),
+			static_cast<uint8_t>(glyph.xOffset), static_cast<uint8_t>(glyph.yOffset),
+			static_cast<uint8_t>(glyph.advance), 0x00};
+		table.insert(table.end(), entry, entry + kGlyphEntry);
+		if (format == FormatAntiAlias2 || format == FormatAntiAlias4)
+		{
+			const int bits = (format == FormatAntiAlias4) ? 4 : 2;
+			const int top = (1 << bits) - 1;
+			uint32_t bit = 0;
+			for (int y = 0; y < glyph.height; y++)
+				for (int x = 0; x < glyph.width; x++, bit += bits)
+				{
+					if ((bit & 7) == 0)
+						data.push_back(0);
+					const int level = (glyph.coverage(x, y) * top + 127) / 255;
+					data.back() |= static_cast<uint8_t>(level << (8 - bits - (bit & 7)));
+				}
+		}
+		else if (format == FormatProportional)
+		{
+			uint32_t bit = 0;
+			for (int y = 0; y < glyph.height; y++)
+				for (int x = 0; x < glyph.width; x++, bit++)
+				{
+					if ((bit & 7) == 0)
+						data.push_back(0);
+					if (glyph.pixel(x, y))
+						data.back() |= 0x80 >> (bit & 7);
+				}
+		}
+		else
+			encodeRuns(glyph, font.lineHeight, data);
+	}
+	out = {0x00, static_cast<uint8_t>(format), static_cast<uint8_t>(font.lineHeight),
+		static_cast<uint8_t>(first), static_cast<uint8_t>(sources.size() - 1), 0x00};
+	if (!extra.empty())
+	{
+		out[5] |= kFlagCodepointMap;
+		out.push_back(static_cast<uint8_t>(map.size() / kCodepointEntry));
+		out.insert(out.end(), map.begin(), map.end());
+	}
+	out.insert(out.end(), table.begin(), table.end());
+	out.insert(out.end(), data.begin(), data.end());
+	return true;
+}
+
+/*!
+	@brief Sizes of a font range in each format
+	@param font glyphs
+	@param first first character
+	@param last last character
+	@param codepoints codepoints added after the range, see encode
+	@return stats, sizes 0 for a format that cannot hold the font
+*/
+font_stats_t measure(const font_t &font, int first, int last, const std::vector<int> &codepoints)
+{
+	font_stats_t stats;
+	stats.first = first;
+	stats.last = last;
+	stats.lineHeight = font.lineHeight;
+	for (int code = first; code <= last; code++)
+	{
+		auto it = font.glyphs.find(code);
+		if (it == font.glyphs.end())
+			continue;
+		stats.present++;
+		stats.maxAdvance = std::max(stats.maxAdvance, it->second.advance);
+	}
+	for (int codepoint : codepoints)
+	{
+		auto it = font.glyphs.find(codepoint);
+		if (it == font.glyphs.end())
+			continue;
+		stats.present++;
+		stats.maxAdvance = std::max(stats.maxAdvance, it->second.advance);
+	}
+	stats.fixedWidth = fixedCellWidth(font, first, last);
+	std::vector<uint8_t> bytes;
+	std::string error;
+	if (encode(font, first, last, FormatFixed, bytes, error, codepoints))
+		stats.fixedBytes = bytes.size();
+	if (encode(font, first, last, FormatProportional, bytes, error, codepoints))
+		stats.proportionalBytes = bytes.size();
+	if (encode(font, first, last, FormatCompressed, bytes, error, codepoints))
+		stats.compressedBytes = bytes.size();
+	if (encode(font, first, last, FormatAntiAlias2, bytes, error, codepoints))
+		stats.antiAlias2Bytes = bytes.size();
+	if (encode(font, first, last, FormatAntiAlias4, bytes, error, codepoints))
+		stats.antiAlias4Bytes = bytes.size();
+	return stats;
+}
+
+/*!
+	@brief Writes a fonts_LTSM style header holding one or more font arrays
+	@param out header text
+	@param source name of the source file, for the comment
+	@param fileStem header name without extension
+	@param arrays array name and font bytes, any format
+	@param first first character, for the glyph comments
+	@param last last character
+*/
+void writeHeader(std::ostream &out, const std::string &source, const std::string &fileStem,
+	const std::vector<std::pair<std::string, std::vector<uint8_t>>> &arrays, int first, int last)
+{
+	char hex[8];
+	out << "/*!\n\t@file    " << fileStem << ".hpp\n"
+		<< "\t@brief   Library font file, generated by ltsm_fontconv from " << source << ".\n*/\n\n"
+		<< "#pragma once\n#include <display16_common_LTSM.hpp>\n\n// === Font Data ===\n\n/// @cond\n";
+	for (const auto &array : arrays)
+	{
+		const std::vector<uint8_t> &font = array.second;
+		const bool fixed = font[0] != 0x00;
+		const char *kinds[] = {"Fixed", "Proportional", "Compressed", "Anti-aliased 2 bit", "Anti-aliased 4 bit"};
+		const char *kind = kinds[fixed ? 0 : std::min<int>(font[1], FormatAntiAlias4)];
+		out << "\n/*!\n\t" << kind << " font, line height " << static_cast<int>(fixed ? font[1] : font[2]) << "\n"
+			<< "\tASCII Range " << (last - first + 1) << " chars\n"
+			<< "\tMemory usage : " << font.size() << " bytes\n*/\n"
+			<< "static const uint8_t " << array.first << "[" << font.size() << "] FLASH_STORAGE = {\n";
+		auto emit = [&](size_t from, size_t to, const std::string &comment) {
+			for (size_t i = from; i < to; i++)
+			{
+				snprintf(hex, sizeof(hex), "0x%02X,", font[i]);
+				out << hex;
+				if (comment.empty() && ((i - from) % 16 == 15) && i + 1 < to)
+					out << "\n";
+			}
+			if (!comment.empty())
+				out << " // " << comment;
+			out << "\n";
+		};
+		if (fixed)
+		{
+			const size_t glyphBytes = (static_cast<size_t>(font[0]) * font[1]) / 8;
+			emit(0, 4, "");
+			for (int code = first; code <= last; code++)
+			{
+				const size_t start = 4 + (code - first) * glyphBytes;
+				emit(start, start + glyphBytes, charName(code));
+			}
+		}
+		else
+		{
+			size_t tableStart = kExtHeader;
+			emit(0, kExtHeader, "marker, type, line height, offset, last-offset, flags");
+			if (font[5] & kFlagCodepointMap)
+			{
+				emit(kExtHeader, kExtHeader + 1, "codepoint map entries");
+				tableStart += 1 + static_cast<size_t>(font[kExtHeader]) * kCodepointEntry;
+				for (size_t start = kExtHeader + 1; start < tableStart; start += kCodepointEntry)
+				{
+					char name[24];
+					snprintf(name, sizeof(name), "U+%04X", (font[start] << 16) | (font[start + 1] << 8) | font[start + 2]);
+					emit(start, start + kCodepointEntry, name);
+				}
+			}
+			const int count = font[4] + 1;
+			const size_t tableEnd = tableStart + static_cast<size_t>(count) * kGlyphEntry;
+			for (int k = 0; k < count; k++)
+			{
+				const size_t start = tableStart + k * kGlyphEntry;
+				emit(start, start + kGlyphEntry, (font[3] + k <= last) ? charName(font[3] + k) : "mapped " + charName(font[3] + k));
+			}
+			if (font.size() > tableEnd)
+				emit(tableEnd, font.size(), "");
+		}
+		out << "};\n";
+	}
+	out << "\n/// @endcond\n";
+}
+
+} // namespace FontConvLTSM
@@ -0,0 +1,80 @@
+/*!
+	@file    fontconv_LTSM.hpp
+	@brief   Font converter for Display16_LTSM, BDF or PGM sheet to fonts_LTSM headers.
+		Host tool, NOT part of the core library.
+	@details Fonts are read into a glyph model, top left origin, then encoded in the
+		fixed, proportional, compressed or anti-aliased font format, see extras/doc/fonts/README.md.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace FontConvLTSM {
+
+/*! @brief One glyph, placed in a cell of its advance by the line height */
+struct glyph_t
+{
+	int advance = 0;               /**< Cell width, cursor advance */
+	int xOffset = 0;               /**< Columns from the cell left to the ink */
+	int yOffset = 0;               /**< Rows from the line top to the ink */
+	int width = 0;                 /**< Ink width */
+	int height = 0;                /**< Ink height */
+	std::vector<uint8_t> pixels;   /**< width * height, ink coverage 0 to 255 */
+
+	uint8_t coverage(int x, int y) const { return pixels[static_cast<size_t>(y) * width + x]; }
+	bool pixel(int x, int y) const { return coverage(x, y) >= 128; }
+	bool cellPixel(int cx, int cy) const;
+	uint8_t cellCoverage(int cx, int cy) const;
+};
+
+/*! @brief A font read from a source file, glyphs by character code */
+struct font_t
+{
+	int lineHeight = 0;               /**< Text line height, Font_Y_Size */
+	std::map<int, glyph_t> glyphs;    /**< Glyphs by code */
+};
+
+/*! @brief Size and range report of a conversion */
+struct font_stats_t
+{
+	int first = 0;          /**< First character code */
+	int last = 0;           /**< Last character code */
+	int present = 0;        /**< Glyphs in range, and codepoints, with a definition */
+	int lineHeight = 0;     /**< Line height */
+	int maxAdvance = 0;     /**< Widest advance */
+	int fixedWidth = 0;     /**< Cell width of the fixed format, a multiple of 8 */
+	size_t fixedBytes = 0;          /**< Size in the fixed format */
+	size_t proportionalBytes = 0;   /**< Size in the proportional format */
+	size_t compressedBytes = 0;     /**< Size in the compressed format */
+	size_t antiAlias2Bytes = 0;     /**< Size in the 2 bit anti-aliased format */
+	size_t antiAlias4Bytes = 0;     /**< Size in the 4 bit anti-aliased format */
+};
+
+/*! Output formats */
+enum format_e : uint8_t
+{
+	FormatFixed = 0,         /**< 4 control bytes, fixed cells */
+	FormatProportional = 1,  /**< Extended font type 0x01 */
+	FormatCompressed = 2,    /**< Extended font type 0x02 */
+	FormatAntiAlias2 = 3,    /**< Extended font type 0x03, 2 bits per pixel coverage */
+	FormatAntiAlias4 = 4     /**< Extended font type 0x04, 4 bits per pixel coverage */
+};
+
+bool loadBDF(std::istream &in, font_t &font, std::string &error);
+bool loadPGM(std::istream &in, int cellWidth, int cellHeight, int first, int threshold, int spacing,
+	font_t &font, std::string &error);
+void fitGlyph(glyph_t &glyph, int lineHeight);
+font_t selectGlyphs(const font_t &font, int first, int last, const std::string &subset);
+bool encode(const font_t &font, int first, int last, format_e format, std::vector<uint8_t> &out, std::string &error,
+	const std::vector<int> &codepoints = {});
+font_stats_t measure(const font_t &font, int first, int last, const std::vector<int> &codepoints = {});
+void writeHeader(std::ostream &out, const std::string &source, const std::string &fileStem,
+	const std::vector<std::pair<std::string, std::vector<uint8_t>>> &arrays, int first, int last);
+
+} // namespace FontConvLTSM
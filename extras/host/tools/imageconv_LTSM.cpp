@@ -0,0 +1,395 @@
+/*!
+	@file    imageconv_LTSM.cpp
+	@brief   Image converter for Display16_LTSM, RGB565 images to the library bitmap formats.
+		Host tool, NOT part of the core library.
+*/
+
+#include "imageconv_LTSM.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace ImageConvLTSM {
+
+/*!
+	@brief Reads an RGB565 bitmap as drawn by drawBitmap16Data, high byte first
+	@param data width * height * 2 bytes
+	@param width width in pixels
+	@param height height in pixels
+	@return the image
+*/
+image_t fromRGB565Bytes(const uint8_t *data, int width, int height)
+{
+	image_t image;
+	image.width = width;
+	image.height = height;
+	image.pixels.resize(static_cast<size_t>(width) * height);
+	for (size_t i = 0; i < image.pixels.size(); i++)
+		image.pixels[i] = static_cast<uint16_t>((data[i * 2] << 8) | data[i * 2 + 1]);
+	return image;
+}
+
+/*!
+	@brief Reads a binary PPM, P6 with a maximum value of 255, to RGB565
+	@param in PPM file
+	@param image set on success
+	@param error set on failure
+	@return true on success
+*/
+bool loadPPM(std::istream &in, image_t &image, std::string &error)
+{
+	std::string magic;
+	int values[3] = {0, 0, 0};
+	in >> magic;
+	for (int &value : values)
+	{
+		in >> std::ws;
+		while (in.peek() == '#')
+		{
+			std::string comment;
+			std::getline(in, comment);
+			in >> std::ws;
+		}
+		in >> value;
+	}
+	if (!in || magic != "P6" || values[0] <= 0 || values[1] <= 0 || values[2] != 255)
+	{
+		error = "not a binary PPM, P6 with maximum value 255";
+		return false;
+	}
+	in.get(); // one white space byte before the pixels
+	std::vector<uint8_t> rgb(static_cast<size_t>(values[0]) * values[1] * 3);
+	if (!in.read(reinterpret_cast<char *>(rgb.data()), rgb.size()))
+	{
+		error = "PPM pixel data is short";
+		return false;
+	}
+	image.width = values[0];
+	image.height = values[1];
+	image.pixels.resize(static_cast<size_t>(image.width) * image.height);
+	for (size_t i = 0; i < image.pixels.size(); i++)
+		image.pixels[i] = static_cast<uint16_t>(((rgb[i * 3] >> 3) << 11) | ((rgb[i * 3 + 1] >> 2) << 5) | (rgb[i * 3 + 2] >> 3));
+	return true;
+}
+
+/*!
+	@brief Reads a raw RGB565 file, high byte first, as the arrays of drawBitmap16Data
+	@param in raw file
+	@param width width in pixels
+	@param height height in pixels
+	@param image set on success
+	@param error set on failure
+	@return true on success
+*/
+bool loadRGB565(std::istream &in, int width, int height, image_t &image, std::string &error)
+{
+	if (width <= 0 || height <= 0)
+	{
+		error = "raw RGB565 input needs a size";
+		return false;
+	}
+	std::vector<uint8_t> bytes(static_cast<size_t>(width) * height * 2);
+	if (!in.read(reinterpret_cast<char *>(bytes.data()), bytes.size()))
+	{
+		error = "raw RGB565 data is short for " + std::to_string(width) + "x" + std::to_string(height);
+		return false;
+	}
+	image = fromRGB565Bytes(bytes.data(), width, height);
+	return true;
+}
+
+/*!
+	@brief The colours of an image, most used first, ties in colour order
+	@param image the image
+	@return the palette
+*/
+std::vector<uint16_t> paletteOf(const image_t &image)
+{
+	std::vector<uint32_t> counts(0x10000, 0);
+	for (uint16_t color : image.pixels)
+		counts[color]++;
+	std::vector<uint16_t> palette;
+	for (uint32_t color = 0; color < counts.size(); color++)
+		if (counts[color] > 0)
+			palette.push_back(static_cast<uint16_t>(color));
+	std::stable_sort(palette.begin(), palette.end(),
+		[&](uint16_t a, uint16_t b) { return counts[a] > counts[b]; });
+	return palette;
+}
+
+/*!
+	@brief The fewest bits per pixel of the indexed format that hold a number of colours
+	@param colours palette size
+	@return 1, 2, 4 or 8, 0 if more than 256 colours
+*/
+int indexedBitsFor(size_t colours)
+{
+	for (int bits : {1, 2, 4, 8})
+		if (colours <= (1u << bits))
+			return bits;
+	return 0;
+}
+
+/*!
+	@brief Reduces an image to a number of colours by median cut
+	@param image the image
+	@param colours most colours kept, 1 to 256
+	@return the image unchanged if it has no more colours, else each pixel replaced by 
+		the weighted mean colour of its box
+	@details Boxes of the colours in use are split at the count weighted median of their 
+		widest channel, red and blue counted at the 6 bit scale of green, until there are 
+		enough boxes or no box has two colours.
+*/
+image_t quantize(const image_t &image, size_t colours)
+{
+	std::vector<uint32_t> counts(0x10000, 0);
+	for (uint16_t color : image.pixels)
+		counts[color]++;
+	std::vector<uint16_t> used;
+	for (uint32_t color = 0; color < counts.size(); color++)
+		if (counts[color] > 0)
+			used.push_back(static_cast<uint16_t>(color));
+	if (colours == 0 || used.size() <= colours)
+		return image;
+	auto channel = [](uint16_t color, int c) {
+		return (c == 0) ? ((color >> 11) << 1) : ((c == 1) ? ((color >> 5) & 0x3F) : ((color & 0x1F) << 1));
+	};
+	struct box_t { size_t first; size_t last; }; // used[first, last)
+	std::vector<box_t> boxes = {{0, used.size()}};
+	while (boxes.size() < colours)
+	{
+		int best = -1, bestChannel = 0, bestRange = 0;
+		for (size_t b = 0; b < boxes.size(); b++)
+			for (int c = 0; c < 3; c++)
+			{
+				int low = 0xFF, high = 0;
+				for (size_t i = boxes[b].first; i < boxes[b].last; i++)
+				{
+					low = std::min(low, channel(used[i], c));
+					high = std::max(high, channel(used[i], c));
+				}
+				if (high - low > bestRange)
+				{
+					best = static_cast<int>(b);
+					bestChannel = c;
+					bestRange = high - low;
+				}
+			}
+		if (best < 0)
+			break;
+		box_t &box = boxes[best];
+		std::sort(used.begin() + box.first, used.begin() + box.last,
+			[&](uint16_t a, uint16_t b) { return channel(a, bestChannel) < channel(b, bestChannel); });
+		uint64_t total = 0, running = 0;
+		for (size_t i = box.first; i < box.last; i++)
+			total += counts[used[i]];
+		size_t split = box.first + 1;
+		for (size_t i = box.first; i + 1 < box.last; i++)
+		{
+			running += counts[used[i]];
+			split = i + 1;
+			if (running * 2 >= total)
+				break;
+		}
+		const box_t upper = {split, box.last};
+		box.last = split;
+		boxes.push_back(upper);
+	}
+	std::vector<uint16_t> mapped(0x10000, 0);
+	for (const box_t &box : boxes)
+	{
+		uint64_t total = 0, red = 0, green = 0, blue = 0;
+		for (size_t i = box.first; i < box.last; i++)
+		{
+			const uint32_t count = counts[used[i]];
+			total += count;
+			red += static_cast<uint64_t>(used[i] >> 11) * count;
+			green += static_cast<uint64_t>((used[i] >> 5) & 0x3F) * count;
+			blue += static_cast<uint64_t>(used[i] & 0x1F) * count;
+		}
+		const uint16_t mean = static_cast<uint16_t>((((red + total / 2) / total) << 11) |
+			(((green + total / 2) / total) << 5) | ((blue + total / 2) / total));
+		for (size_t i = box.first; i < box.last; i++)
+			mapped[used[i]] = mean;
+	}
+	image_t reduced = image;
+	for (uint16_t &color : reduced.pixels)
+		color = mapped[color];
+	return reduced;
+}
+
+/*!
+	@brief Encodes an image in the indexed bitmap format of drawBitmapIndexed
+	@param image the image, at most 256 colours
+	@param bitsPerPixel 1, 2, 4 or 8, 0 for the fewest that hold the colours
+	@param out bitmap bytes, header, palette, rows padded to a byte
+	@param error set on failure
+	@return true on success
+*/
+bool encodeIndexed(const image_t &image, int bitsPerPixel, std::vector<uint8_t> &out, std::string &error)
+{
+	out.clear();
+	if (image.width <= 0 || image.height <= 0 || image.width > 0xFFFF || image.height > 0xFFFF)
+	{
+		error = "image size out of range 1-65535";
+		return false;
+	}
+	const std::vector<uint16_t> palette = paletteOf(image);
+	if (bitsPerPixel == 0)
+		bitsPerPixel = indexedBitsFor(palette.size());
+	if (bitsPerPixel != 1 && bitsPerPixel != 2 && bitsPerPixel != 4 && bitsPerPixel != 8)
+	{
+		error = "more than 256 colours, or bits per pixel not 1, 2, 4 or 8";
+		return false;
+	}
+	if (palette.size() > (1u << bitsPerPixel))
+	{
+		error = std::to_string(palette.size()) + " colours do not fit " + std::to_string(bitsPerPixel) + " bits per pixel";
+		return false;
+	}
+	std::vector<uint8_t> indexOf(0x10000, 0);
+	for (size_t i = 0; i < palette.size(); i++)
+		indexOf[palette[i]] = static_cast<uint8_t>(i);
+	out = {static_cast<uint8_t>(bitsPerPixel), static_cast<uint8_t>(image.width >> 8), static_cast<uint8_t>(image.width & 0xFF),
+		static_cast<uint8_t>(image.height >> 8), static_cast<uint8_t>(image.height & 0xFF),
+		static_cast<uint8_t>(palette.size() - 1)};
+	for (uint16_t color : palette)
+	{
+		out.push_back(static_cast<uint8_t>(color >> 8));
+		out.push_back(static_cast<uint8_t>(color & 0xFF));
+	}
+	for (int y = 0; y < image.height; y++)
+	{
+		int bit = 0;
+		for (int x = 0; x < image.width; x++, bit += bitsPerPixel)
+		{
+			if ((bit & 7) == 0)
+				out.push_back(0);
+			const uint8_t index = indexOf[image.pixels[static_cast<size_t>(y) * image.width + x]];
+			out.back() |= static_cast<uint8_t>(index << (8 - bitsPerPixel - (bit & 7)));
+		}
+	}
+	return true;
+}
+
+/*!
+	@brief Encodes an image in the compressed bitmap format of drawBitmapCompressed
+	@param image the image
+	@param out bitmap bytes, header then stream
+	@param error set on failure
+	@return true on success
+	@details Each pixel takes the first of: a run of the previous pixel, an index of a colour 
+		seen before, a small difference, a green led difference, or the pixel itself. 
+		See drawBitmapCompressed for the operations.
+*/
+bool encodeCompressed(const image_t &image, std::vector<uint8_t> &out, std::string &error)
+{
+	out.clear();
+	if (image.width <= 0 || image.height <= 0 || image.width > 0xFFFF || image.height > 0xFFFF)
+	{
+		error = "image size out of range 1-65535";
+		return false;
+	}
+	out = {0x51, static_cast<uint8_t>(image.width >> 8), static_cast<uint8_t>(image.width & 0xFF),
+		static_cast<uint8_t>(image.height >> 8), static_cast<uint8_t>(image.height & 0xFF)};
+	uint16_t seen[64] = {0};
+	uint16_t previous = 0x0000;
+	size_t run = 0;
+	auto flushRun = [&]() {
+		while (run > 0)
+		{
+			const size_t count = std::min<size_t>(run, 63 + 0xFF);
+			if (count <= 62)
+				out.push_back(static_cast<uint8_t>(0xC0 + count - 1));
+			else
+			{
+				out.push_back(0xFF);
+				out.push_back(static_cast<uint8_t>(count - 63));
+			}
+			run -= count;
+		}
+	};
+	for (uint16_t color : image.pixels)
+	{
+		if (color == previous)
+		{
+			run++;
+			continue;
+		}
+		flushRun();
+		const int r = color >> 11, g = (color >> 5) & 0x3F, b = color & 0x1F;
+		const int hash = (r * 3 + g * 5 + b * 7) & 0x3F;
+		if (seen[hash] == color)
+			out.push_back(static_cast<uint8_t>(hash));
+		else
+		{
+			seen[hash] = color;
+			const int dr = ((r - (previous >> 11) + 16) & 0x1F) - 16;
+			const int dg = ((g - ((previous >> 5) & 0x3F) + 32) & 0x3F) - 32;
+			const int db = ((b - (previous & 0x1F) + 16) & 0x1F) - 16;
+			const int drg = dr - dg / 2, dbg = db - dg / 2;
+			if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1)
+				out.push_back(static_cast<uint8_t>(0x40 | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2)));
+			else if (drg >= -8 && drg <= 7 && dbg >= -8 && dbg <= 7)
+			{
+				out.push_back(static_cast<uint8_t>(0x80 | (dg + 32)));
+				out.push_back(static_cast<uint8_t>(((drg + 8) << 4) | (dbg + 8)));
+			}
+			else
+			{
+				out.push_back(0xFE);
+				out.push_back(static_cast<uint8_t>(color >> 8));
+				out.push_back(static_cast<uint8_t>(color & 0xFF));
+			}
+		}
+		previous = color;
+	}
+	flushRun();
+	return true;
+}
+
+/*!
+	@brief Encodes an image as drawn by drawBitmap16Data, RGB565 high byte first
+	@param image the image
+	@return width * height * 2 bytes
+*/
+std::vector<uint8_t> encodeRGB565(const image_t &image)
+{
+	std::vector<uint8_t> bytes;
+	bytes.reserve(image.pixels.size() * 2);
+	for (uint16_t color : image.pixels)
+	{
+		bytes.push_back(static_cast<uint8_t>(color >> 8));
+		bytes.push_back(static_cast<uint8_t>(color & 0xFF));
+	}
+	return bytes;
+}
+
+/*!
+	@brief Writes a bitmap as a header file in the style of bitmap_test_data_LTSM
+	@param out header output
+	@param source input file name, for the file comment
+	@param fileStem header file name without extension
+	@param name array name
+	@param kind format description, for the array comment
+	@param image the image, for its size
+	@param bytes bitmap bytes
+*/
+void writeHeader(std::ostream &out, const std::string &source, const std::string &fileStem,
+	const std::string &name, const std::string &kind, const image_t &image, const std::vector<uint8_t> &bytes)
+{
+	char hex[8];
+	out << "/*!\n\t@file    " << fileStem << ".hpp\n"
+		<< "\t@brief   Bitmap file, generated by ltsm_imageconv from " << source << ".\n*/\n\n"
+		<< "#pragma once\n#include <display16_common_LTSM.hpp>\n\n/// @cond\n\n"
+		<< "// " << kind << ", " << image.width << "x" << image.height << ", array size is " << bytes.size() << "\n"
+		<< "static const uint8_t " << name << "[" << bytes.size() << "] FLASH_STORAGE = {\n";
+	for (size_t i = 0; i < bytes.size(); i++)
+	{
+		snprintf(hex, sizeof(hex), "0x%02X,", bytes[i]);
+		out << hex << (((i % 16) == 15 || i + 1 == bytes.size()) ? "\n" : "");
+	}
+	out << "};\n\n/// @endcond\n";
+}
+
+} // namespace ImageConvLTSM
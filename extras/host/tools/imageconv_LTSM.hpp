@@ -0,0 +1,40 @@
+/*!
+	@file    imageconv_LTSM.hpp
+	@brief   Image converter for Display16_LTSM, RGB565 images to the library bitmap formats.
+		Host tool, NOT part of the core library.
+	@details Images are read from PPM or raw RGB565 files and held as RGB565 pixels. They are 
+		encoded in the indexed bitmap format drawn by drawBitmapIndexed, reduced to a palette by 
+		median cut if they have too many colours, or in the compressed format drawn by drawBitmapCompressed.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ImageConvLTSM {
+
+/*! @brief An RGB565 image, row major */
+struct image_t
+{
+	int width = 0;                  /**< Width in pixels */
+	int height = 0;                 /**< Height in pixels */
+	std::vector<uint16_t> pixels;   /**< width * height RGB565 colours */
+};
+
+image_t fromRGB565Bytes(const uint8_t *data, int width, int height);
+bool loadPPM(std::istream &in, image_t &image, std::string &error);
+bool loadRGB565(std::istream &in, int width, int height, image_t &image, std::string &error);
+std::vector<uint16_t> paletteOf(const image_t &image);
+int indexedBitsFor(size_t colours);
+image_t quantize(const image_t &image, size_t colours);
+bool encodeIndexed(const image_t &image, int bitsPerPixel, std::vector<uint8_t> &out, std::string &error);
+bool encodeCompressed(const image_t &image, std::vector<uint8_t> &out, std::string &error);
+std::vector<uint8_t> encodeRGB565(const image_t &image);
+void writeHeader(std::ostream &out, const std::string &source, const std::string &fileStem,
+	const std::string &name, const std::string &kind, const image_t &image, const std::vector<uint8_t> &bytes);
+
+} // namespace ImageConvLTSM
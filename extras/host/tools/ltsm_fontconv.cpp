@@ -0,0 +1,269 @@
+/*!
+	@file    ltsm_fontconv.cpp
+	@brief   Command line font converter for Display16_LTSM. Host tool, NOT part of the core library.
+	@details Reads a BDF font, or a PGM sheet of equal cells, and writes a fonts_LTSM style header
+		holding the font in the fixed, proportional, compressed and or anti-aliased format, with a size report.
+		See extras/doc/fonts/README.md.
+*/
+
+#include "fontconv_LTSM.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace FontConvLTSM;
+
+namespace {
+
+void usage(void)
+{
+	fprintf(stderr,
+		"Usage: ltsm_fontconv [options] input.bdf|input.pgm\n"
+		"  -n NAME       font array name, default from the input file name\n"
+		"  -o FILE       output header, default stdout\n"
+		"  -f FORMATS    fixed, prop, rle, aa2, aa4 or all, comma separated, default fixed,\n"
+		"                all is the three 1 bit formats, aa2 and aa4 keep PGM grey levels\n"
+		"  -r FIRST-LAST character range, decimal or 0x hex, default 0x20-0x7E\n"
+		"  -s CHARS      subset, only these characters keep a glyph\n"
+		"  -u LIST       Unicode codepoints added after the range with a codepoint map,\n"
+		"                comma separated codes or FIRST-LAST ranges, e.g. 0xB0,0x3A9,0x2190-0x2193\n"
+		"  --cell WxH    PGM cell size, needed for PGM input\n"
+		"  --first CODE  PGM character of the top left cell, default the range start\n"
+		"  --threshold N PGM grey level below which a pixel is ink, default 128\n"
+		"  --spacing N   PGM advance = ink width + N, default the cell width\n"
+		"  --stats       print the size report only\n");
+}
+
+bool parseCode(const char *text, int &code)
+{
+	char *end = nullptr;
+	const long value = strtol(text, &end, 0);
+	if (end == text || *end != '\0' || value < 0 || value > 255)
+		return false;
+	code = static_cast<int>(value);
+	return true;
+}
+
+bool parseCodepoints(const std::string &list, std::vector<int> &codepoints)
+{
+	std::stringstream items(list);
+	std::string item;
+	while (std::getline(items, item, ','))
+	{
+		char *end = nullptr;
+		const long from = strtol(item.c_str(), &end, 0);
+		long to = from;
+		if (end != item.c_str() && *end == '-')
+		{
+			const char *start = end + 1;
+			to = strtol(start, &end, 0);
+			if (end == start)
+				return false;
+		}
+		if (end == item.c_str() || *end != '\0' || from < 0 || to < from || to > 0x10FFFF || (to - from) > 0xFF)
+			return false;
+		for (long code = from; code <= to; code++)
+			codepoints.push_back(static_cast<int>(code));
+	}
+	return !codepoints.empty();
+}
+
+std::string stemOf(const std::string &path)
+{
+	size_t slash = path.find_last_of("/\\");
+	std::string stem = (slash == std::string::npos) ? path : path.substr(slash + 1);
+	size_t dot = stem.find_last_of('.');
+	if (dot != std::string::npos)
+		stem = stem.substr(0, dot);
+	std::string name;
+	for (char c : stem)
+		name.push_back(isalnum(static_cast<unsigned char>(c)) ? c : '_');
+	if (name.empty() || isdigit(static_cast<unsigned char>(name[0])))
+		name = "Font" + name;
+	return name;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	std::string input, output, name, formats = "fixed", subset;
+	int first = 0x20, last = 0x7E, pgmFirst = -1, threshold = 128, spacing = -1;
+	int cellWidth = 0, cellHeight = 0;
+	std::vector<int> codepoints;
+	bool statsOnly = false;
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string arg = argv[i];
+		const bool hasValue = (i + 1 < argc);
+		if (arg == "-h" || arg == "--help")
+		{
+			usage();
+			return 0;
+		}
+		else if (arg == "--stats")
+			statsOnly = true;
+		else if (arg == "-n" && hasValue)
+			name = argv[++i];
+		else if (arg == "-o" && hasValue)
+			output = argv[++i];
+		else if (arg == "-f" && hasValue)
+			formats = argv[++i];
+		else if (arg == "-s" && hasValue)
+			subset = argv[++i];
+		else if (arg == "-r" && hasValue)
+		{
+			std::string range = argv[++i];
+			size_t dash = range.find('-', 1);
+			if (dash == std::string::npos || !parseCode(range.substr(0, dash).c_str(), first) ||
+				!parseCode(range.substr(dash + 1).c_str(), last))
+			{
+				fprintf(stderr, "Error: bad range %s\n", range.c_str());
+				return 1;
+			}
+		}
+		else if (arg == "-u" && hasValue)
+		{
+			if (!parseCodepoints(argv[++i], codepoints))
+			{
+				fprintf(stderr, "Error: bad codepoint list %s\n", argv[i]);
+				return 1;
+			}
+		}
+		else if (arg == "--cell" && hasValue)
+		{
+			if (sscanf(argv[++i], "%dx%d", &cellWidth, &cellHeight) != 2)
+			{
+				fprintf(stderr, "Error: bad cell size %s\n", argv[i]);
+				return 1;
+			}
+		}
+		else if (arg == "--first" && hasValue)
+		{
+			if (!parseCode(argv[++i], pgmFirst))
+			{
+				fprintf(stderr, "Error: bad first character %s\n", argv[i]);
+				return 1;
+			}
+		}
+		else if (arg == "--threshold" && hasValue)
+			threshold = atoi(argv[++i]);
+		else if (arg == "--spacing" && hasValue)
+			spacing = atoi(argv[++i]);
+		else if (arg[0] == '-' || !input.empty())
+		{
+			usage();
+			return 1;
+		}
+		else
+			input = arg;
+	}
+	if (input.empty())
+	{
+		usage();
+		return 1;
+	}
+	std::ifstream in(input, std::ios::binary);
+	if (!in)
+	{
+		fprintf(stderr, "Error: cannot open %s\n", input.c_str());
+		return 1;
+	}
+	font_t font;
+	std::string error;
+	const bool pgm = input.size() > 4 && input.compare(input.size() - 4, 4, ".pgm") == 0;
+	bool loaded;
+	if (pgm)
+	{
+		if (cellWidth <= 0)
+		{
+			fprintf(stderr, "Error: PGM input needs --cell WxH\n");
+			return 1;
+		}
+		loaded = loadPGM(in, cellWidth, cellHeight, pgmFirst >= 0 ? pgmFirst : first, threshold, spacing, font, error);
+	}
+	else
+		loaded = loadBDF(in, font, error);
+	if (!loaded)
+	{
+		fprintf(stderr, "Error: %s: %s\n", input.c_str(), error.c_str());
+		return 1;
+	}
+	const font_t source = font;
+	font = selectGlyphs(font, first, last, subset);
+	for (int codepoint : codepoints)
+	{
+		auto it = source.glyphs.find(codepoint);
+		if (it != source.glyphs.end())
+			font.glyphs[codepoint] = it->second;
+	}
+	if (name.empty())
+		name = stemOf(input);
+
+	const font_stats_t stats = measure(font, first, last, codepoints);
+	fprintf(stderr, "%s: range 0x%02X-0x%02X, %d chars, %d with glyphs, line height %d, widest advance %d\n",
+		input.c_str(), stats.first, stats.last, stats.last - stats.first + 1, stats.present,
+		stats.lineHeight, stats.maxAdvance);
+	if (!codepoints.empty())
+		fprintf(stderr, "  codepoint map: %zu codepoints, fixed format not available\n", codepoints.size());
+	else
+		fprintf(stderr, "  fixed %dx%d  : %6zu bytes\n", stats.fixedWidth, stats.lineHeight, stats.fixedBytes);
+	if (stats.fixedBytes > 0)
+	{
+		fprintf(stderr, "  proportional : %6zu bytes, %3zu%% of fixed\n", stats.proportionalBytes,
+			stats.proportionalBytes * 100 / stats.fixedBytes);
+		fprintf(stderr, "  compressed   : %6zu bytes, %3zu%% of fixed\n", stats.compressedBytes,
+			stats.compressedBytes * 100 / stats.fixedBytes);
+		fprintf(stderr, "  anti-aliased : %6zu bytes 2 bit, %zu bytes 4 bit\n", stats.antiAlias2Bytes,
+			stats.antiAlias4Bytes);
+	}
+	else
+		fprintf(stderr, "  proportional : %6zu bytes, compressed %zu bytes, anti-aliased %zu / %zu bytes\n",
+			stats.proportionalBytes, stats.compressedBytes, stats.antiAlias2Bytes, stats.antiAlias4Bytes);
+	if (statsOnly)
+		return 0;
+
+	std::vector<std::pair<std::string, std::vector<uint8_t>>> arrays;
+	const bool all = formats.find("all") != std::string::npos;
+	const struct { const char *key; format_e format; const char *suffix; bool inAll; } kinds[] = {
+		{"fixed", FormatFixed, "", true}, {"prop", FormatProportional, "Prop", true},
+		{"rle", FormatCompressed, "Rle", true}, {"aa2", FormatAntiAlias2, "Aa2", false},
+		{"aa4", FormatAntiAlias4, "Aa4", false}};
+	for (const auto &kind : kinds)
+	{
+		if (!(all && kind.inAll) && formats.find(kind.key) == std::string::npos)
+			continue;
+		std::vector<uint8_t> bytes;
+		if (!codepoints.empty() && kind.format == FormatFixed && all && formats.find(kind.key) == std::string::npos)
+			continue; // all with a codepoint map is the extended formats
+		if (!encode(font, first, last, kind.format, bytes, error, codepoints))
+		{
+			fprintf(stderr, "Error: %s format: %s\n", kind.key, error.c_str());
+			return 1;
+		}
+		arrays.push_back({name + kind.suffix, bytes});
+	}
+	if (arrays.empty())
+	{
+		fprintf(stderr, "Error: no format in %s, use fixed, prop, rle, aa2, aa4 or all\n", formats.c_str());
+		return 1;
+	}
+	const std::string fileStem = output.empty() ? name + "_LTSM" : stemOf(output);
+	if (output.empty())
+		writeHeader(std::cout, input, fileStem, arrays, first, last);
+	else
+	{
+		std::ofstream out(output);
+		writeHeader(out, input, fileStem, arrays, first, last);
+		if (!out)
+		{
+			fprintf(stderr, "Error: cannot write %s\n", output.c_str());
+			return 1;
+		}
+	}
+	return 0;
+}
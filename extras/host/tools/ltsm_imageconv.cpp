@@ -0,0 +1,173 @@
+/*!
+	@file    ltsm_imageconv.cpp
+	@brief   Command line image converter for Display16_LTSM. Host tool, NOT part of the core library.
+	@details Reads a binary PPM, or a raw RGB565 file, and writes a bitmap_test_data_LTSM style header
+		holding the image in the compressed, indexed or RGB565 bitmap format, with a size report.
+*/
+
+#include "imageconv_LTSM.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+using namespace ImageConvLTSM;
+
+namespace {
+
+void usage(void)
+{
+	fprintf(stderr,
+		"Usage: ltsm_imageconv [options] input.ppm|input.raw\n"
+		"  -n NAME       array name, default from the input file name\n"
+		"  -o FILE       output header, default stdout\n"
+		"  -f FORMAT     compressed, indexed or rgb565, default compressed,\n"
+		"                drawn by drawBitmapCompressed, drawBitmapIndexed and drawBitmap16Data\n"
+		"  -b BITS       indexed bits per pixel, 1, 2, 4 or 8, default the fewest that hold the colours\n"
+		"  -c COLOURS    reduce to this many colours first, 1 to 256, median cut\n"
+		"  --size WxH    raw RGB565 input size, needed for raw input\n"
+		"  --stats       print the size report only\n");
+}
+
+std::string stemOf(const std::string &path)
+{
+	size_t slash = path.find_last_of("/\\");
+	std::string stem = (slash == std::string::npos) ? path : path.substr(slash + 1);
+	size_t dot = stem.find_last_of('.');
+	if (dot != std::string::npos)
+		stem = stem.substr(0, dot);
+	std::string name;
+	for (char c : stem)
+		name.push_back(isalnum(static_cast<unsigned char>(c)) ? c : '_');
+	if (name.empty() || isdigit(static_cast<unsigned char>(name[0])))
+		name = "Image" + name;
+	return name;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	std::string input, output, name, format = "compressed";
+	int bits = 0, colours = 0, width = 0, height = 0;
+	bool statsOnly = false;
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string arg = argv[i];
+		const bool hasValue = (i + 1 < argc);
+		if (arg == "-h" || arg == "--help")
+		{
+			usage();
+			return 0;
+		}
+		else if (arg == "--stats")
+			statsOnly = true;
+		else if (arg == "-n" && hasValue)
+			name = argv[++i];
+		else if (arg == "-o" && hasValue)
+			output = argv[++i];
+		else if (arg == "-f" && hasValue)
+			format = argv[++i];
+		else if (arg == "-b" && hasValue)
+			bits = atoi(argv[++i]);
+		else if (arg == "-c" && hasValue)
+		{
+			colours = atoi(argv[++i]);
+			if (colours < 1 || colours > 256)
+			{
+				fprintf(stderr, "Error: bad colour count %s\n", argv[i]);
+				return 1;
+			}
+		}
+		else if (arg == "--size" && hasValue)
+		{
+			if (sscanf(argv[++i], "%dx%d", &width, &height) != 2)
+			{
+				fprintf(stderr, "Error: bad size %s\n", argv[i]);
+				return 1;
+			}
+		}
+		else if (arg[0] == '-' || !input.empty())
+		{
+			usage();
+			return 1;
+		}
+		else
+			input = arg;
+	}
+	if (input.empty())
+	{
+		usage();
+		return 1;
+	}
+	std::ifstream in(input, std::ios::binary);
+	if (!in)
+	{
+		fprintf(stderr, "Error: cannot open %s\n", input.c_str());
+		return 1;
+	}
+	image_t image;
+	std::string error;
+	const bool ppm = input.size() > 4 && input.compare(input.size() - 4, 4, ".ppm") == 0;
+	const bool loaded = ppm ? loadPPM(in, image, error) : loadRGB565(in, width, height, image, error);
+	if (!loaded)
+	{
+		fprintf(stderr, "Error: %s: %s\n", input.c_str(), error.c_str());
+		return 1;
+	}
+	if (colours > 0)
+		image = quantize(image, colours);
+	if (name.empty())
+		name = stemOf(input);
+
+	std::vector<uint8_t> bytes;
+	std::string kind;
+	bool encoded = true;
+	if (format == "compressed")
+	{
+		encoded = encodeCompressed(image, bytes, error);
+		kind = "Compressed RGB565, drawBitmapCompressed";
+	}
+	else if (format == "indexed")
+	{
+		encoded = encodeIndexed(image, bits, bytes, error);
+		kind = "Indexed colour, drawBitmapIndexed";
+	}
+	else if (format == "rgb565")
+	{
+		bytes = encodeRGB565(image);
+		kind = "RGB565, drawBitmap16Data";
+	}
+	else
+	{
+		fprintf(stderr, "Error: no format %s, use compressed, indexed or rgb565\n", format.c_str());
+		return 1;
+	}
+	if (!encoded)
+	{
+		fprintf(stderr, "Error: %s format: %s\n", format.c_str(), error.c_str());
+		return 1;
+	}
+	const size_t rgb565Bytes = image.pixels.size() * 2;
+	fprintf(stderr, "%s: %dx%d, %zu colours, RGB565 %zu bytes, %s %zu bytes, %zu%%\n", input.c_str(),
+		image.width, image.height, paletteOf(image).size(), rgb565Bytes, format.c_str(), bytes.size(),
+		bytes.size() * 100 / rgb565Bytes);
+	if (statsOnly)
+		return 0;
+
+	const std::string fileStem = output.empty() ? name + "_LTSM" : stemOf(output);
+	if (output.empty())
+		writeHeader(std::cout, input, fileStem, name, kind, image, bytes);
+	else
+	{
+		std::ofstream out(output);
+		writeHeader(out, input, fileStem, name, kind, image, bytes);
+		if (!out)
+		{
+			fprintf(stderr, "Error: cannot write %s\n", output.c_str());
+			return 1;
+		}
+	}
+	return 0;
+}
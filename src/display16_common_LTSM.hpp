@@ -6,6 +6,9 @@
 				-# Option 1: dislib16_ADVANCED_GRAPHICS_ENABLE enables advanced graphic functions
 				-# Option 2: dislib16_ADVANCED_SCREEN_BUFFER_ENABLE enables screen buffer mode.
 				-# Option 3: dislib16_DEBUG_MODE_ENABLE enables debug messages.
+				-# Option 4: dislib16_SPI_BYTE_TRANSFER_ENABLE forces byte by byte hardware SPI writes.
+				-# Option 5: dislib16_SCRATCH_BYTES size of the scratch arena for glyphs and bitmap rows.
+				-# Option 6: dislib16_GLYPH_CACHE_ENABLE enables the glyph cache.
  */
 
 #pragma once
@@ -31,6 +34,13 @@
 #ifndef pgm_read_byte
 #define pgm_read_byte(addr) (*(const uint8_t *)(addr))
 #endif
+#ifndef pgm_read_word
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#endif
+// AVR and ESP8266 bitmaps are in flash that only pgm reads may access, elsewhere a plain copy
+#if !defined(__AVR__) && !defined(ESP8266) && !defined(memcpy_P)
+#define memcpy_P(dst, src, len) memcpy((dst), (src), (len))
+#endif
 
 // Section: User options 
 // ================================================================
@@ -46,6 +56,26 @@
 // default is off
 //#define dislib16_DEBUG_MODE_ENABLE
 // ================================================================
+// ===== USER OPTION 4 turns off block SPI transfers if commented in
+// Hardware SPI buffers are sent with the cores block transfer by default,
+// enable this for cores that lack SPI.transfer(buffer, size).
+// default is off
+//#define dislib16_SPI_BYTE_TRANSFER_ENABLE
+// ================================================================
+// ===== USER OPTION 5 bytes in each display's scratch arena, used to build text
+// characters and bitmap rows before sending. Larger items are sent in chunks.
+// A larger buffer can be given at run time with setScratchBuffer().
+// default is 128
+#ifndef dislib16_SCRATCH_BYTES
+#define dislib16_SCRATCH_BYTES 128
+#endif
+// ================================================================
+// ===== USER OPTION 6 turns on the glyph cache if commented in
+// Text characters are kept as ready to send RGB565 blocks, byte budget
+// set at run time with setGlyphCache(). Needs std::vector support.
+// default is off
+//#define dislib16_GLYPH_CACHE_ENABLE
+// ================================================================
 // End of user options section
 
 /*! namespace for Error enum*/
@@ -75,7 +105,9 @@ enum Ret_Codes_e : uint8_t
 	BitmapDataEmpty = 19,        /**< Empty bitmap span object  */
 	GenericError = 20,           /**< Generic Error */
 	FontDataEmpty = 21,          /**< There is no data in selected font. */
-	MemoryAError = 22            /**<  Memory allocation failure*/
+	MemoryAError = 22,           /**<  Memory allocation failure*/
+	TextTruncated = 23,          /**< Text did not fit its box, the characters that fit were drawn */
+	BitmapFormat = 24            /**< Bitmap header is not a supported format, check the bitmap data */
 };
 }
 
@@ -19,9 +19,29 @@ display_Fonts::display_Fonts(){setFont(FontDefault); };
 	@return	Will return rdlib::Return_Codes_e  enum
 		-# Pass rdlib::Success
 		-# Error 1 rdlib::FontPtrNullptr
+		-# DisLib16::WrongFont unknown extended font type, font unchanged
+	@details The first control byte tells the format, a fixed font starts with its
+		width, never 0, an extended font with 0x00 then its FontType_e.
  */
 DisLib16::Ret_Codes_e  display_Fonts::setFont(const uint8_t* font) {
 
+	const DisLib16::Ret_Codes_e result = swapFont(font);
+	if (result != DisLib16::Success)
+		return result;
+	_FontInverted = false;
+	_FontChangeCount++;
+	return DisLib16::Success;
+}
+
+/*!
+	@brief Selects a font for a while, e.g. one numeric field, swap back with the previous font after
+	@param font Selected Font Name
+	@return as setFont
+	@details Unlike setFont the invert flag and _FontChangeCount are kept, 
+		so caches of font data do not see a change of font.
+ */
+DisLib16::Ret_Codes_e display_Fonts::swapFont(const uint8_t* font)
+{
 	if (font == nullptr)
 	{
 		#ifdef dislib16_DEBUG_MODE_ENABLE
@@ -29,13 +49,52 @@ DisLib16::Ret_Codes_e  display_Fonts::setFont(const uint8_t* font) {
 		#endif
 		return DisLib16::FontPtrNullptr;
 	}
+	if (pgm_read_byte(&font[0]) == 0x00) // extended font, marker then type
+	{
+		const uint8_t type = pgm_read_byte(&font[1]);
+		if (type < FontTypeProportional || type > FontTypeAntiAlias4)
+		{
+			#ifdef dislib16_DEBUG_MODE_ENABLE
+				Serial.println("Error setFont, unknown font type");
+			#endif
+			return DisLib16::WrongFont;
+		}
+		_FontType     = static_cast<FontType_e>(type);
+		_FontBitsPerPixel = (type == FontTypeAntiAlias4) ? 4 : ((type == FontTypeAntiAlias2) ? 2 : 1);
+		_Font_Y_Size  = pgm_read_byte(&font[2]);
+		_FontOffset   = pgm_read_byte(&font[3]);
+		_FontNumChars = pgm_read_byte(&font[4]);
+		_FontGlyphTable = font + _FontExtHeader;
+		_FontCodepointMap = nullptr;
+		_FontCodepointCount = 0;
+		if (pgm_read_byte(&font[5]) & _FontFlagCodepointMap) // count, entries, then the glyph table
+		{
+			_FontCodepointCount = pgm_read_byte(&font[_FontExtHeader]);
+			_FontCodepointMap = font + _FontExtHeader + 1;
+			_FontGlyphTable = _FontCodepointMap + (_FontCodepointCount * _FontCodepointEntry);
+		}
+		// X size is the widest advance, for wrap checks and bounds
+		_Font_X_Size = 0;
+		for (uint16_t i = 0; i <= _FontNumChars; i++)
+		{
+			const uint8_t advance = pgm_read_byte(&_FontGlyphTable[(i * _FontGlyphEntry) + 6]);
+			if (advance > _Font_X_Size)
+				_Font_X_Size = advance;
+		}
+	}
+	else
+	{
+		_FontType     = FontTypeFixed;
+		_FontBitsPerPixel = 1;
+		_FontGlyphTable = nullptr;
+		_FontCodepointMap = nullptr;
+		_FontCodepointCount = 0;
+		_Font_X_Size  = font[0];
+		_Font_Y_Size  = font[1];
+		_FontOffset   = font[2];
+		_FontNumChars = font[3];
+	}
 	_FontSelect   = font;
-	_Font_X_Size  = _FontSelect[0];
-	_Font_Y_Size  = _FontSelect[1];
-	_FontOffset   = _FontSelect[2];
-	_FontNumChars = _FontSelect[3];
-	_FontInverted = false;
-
 	return DisLib16::Success;
 }
 
@@ -54,4 +113,93 @@ void display_Fonts::setInvertFont(bool invertStatus) {
 bool display_Fonts::getInvertFont()
 { return _FontInverted; }
 
+/*!
+	@brief getFontType
+	@return format of the active font
+*/
+display_Fonts::FontType_e display_Fonts::getFontType(void) const
+{ return _FontType; }
+
+/*!
+	@brief Reads a glyph table entry of the active proportional font.
+	@param character character in font range
+	@param glyph filled with the metrics and bits of the character
+	@details Entry layout: data offset hi, lo (from the first byte after the table),
+		width, height, xOffset, yOffset, xAdvance, reserved. 
+		Same table for proportional, compressed and anti-aliased fonts.
+		A fixed font gives its cell, no bearing.
+*/
+void display_Fonts::getFontGlyph(uint8_t character, font_glyph_t &glyph) const
+{
+	if (_FontType == FontTypeFixed)
+	{
+		glyph.bitmap = _FontSelect + 4 + ((character - _FontOffset) * ((_Font_X_Size * _Font_Y_Size) / 8));
+		glyph.width = _Font_X_Size;
+		glyph.height = _Font_Y_Size;
+		glyph.xOffset = 0;
+		glyph.yOffset = 0;
+		glyph.xAdvance = _Font_X_Size;
+		return;
+	}
+	const uint8_t *entry = _FontGlyphTable + ((character - _FontOffset) * _FontGlyphEntry);
+	const uint16_t offset = (pgm_read_byte(&entry[0]) << 8) | pgm_read_byte(&entry[1]);
+	glyph.bitmap = _FontGlyphTable + ((_FontNumChars + 1) * _FontGlyphEntry) + offset;
+	glyph.width = pgm_read_byte(&entry[2]);
+	glyph.height = pgm_read_byte(&entry[3]);
+	glyph.xOffset = static_cast<int8_t>(pgm_read_byte(&entry[4]));
+	glyph.yOffset = static_cast<int8_t>(pgm_read_byte(&entry[5]));
+	glyph.xAdvance = pgm_read_byte(&entry[6]);
+}
+
+/*!
+	@brief Gets the cursor advance of a character in the active font.
+	@param character character
+	@return advance in pixels, Font_X_Size for fixed fonts and characters out of font range
+*/
+uint8_t display_Fonts::getCharAdvance(uint8_t character) const
+{
+	if (_FontType == FontTypeFixed || character < _FontOffset || character > (_FontOffset + _FontNumChars))
+		return _Font_X_Size;
+	return pgm_read_byte(&_FontGlyphTable[((character - _FontOffset) * _FontGlyphEntry) + 6]);
+}
+
+/*!
+	@brief Finds the character of a Unicode codepoint in the active font.
+	@param codepoint Unicode codepoint
+	@param character set to the character to draw, when found
+	@return true if the font has a glyph for the codepoint
+	@details A font with a codepoint map is searched by binary search, entries are sorted 
+		by codepoint, so lookup costs log2(entries) reads. Codepoints below 0x80 and fonts 
+		without a map use the codepoint as the character, 0x80 to 0xFF as Latin-1.
+*/
+bool display_Fonts::getCodepointChar(uint32_t codepoint, uint8_t &character) const
+{
+	if (_FontCodepointMap != nullptr && codepoint >= 0x80)
+	{
+		uint16_t low = 0;
+		uint16_t high = _FontCodepointCount;
+		while (low < high)
+		{
+			const uint16_t mid = (low + high) / 2;
+			const uint8_t *entry = _FontCodepointMap + (mid * _FontCodepointEntry);
+			const uint32_t value = (static_cast<uint32_t>(pgm_read_byte(&entry[0])) << 16) |
+				(static_cast<uint32_t>(pgm_read_byte(&entry[1])) << 8) | pgm_read_byte(&entry[2]);
+			if (value == codepoint)
+			{
+				character = pgm_read_byte(&entry[3]);
+				return true;
+			}
+			if (value < codepoint)
+				low = mid + 1;
+			else
+				high = mid;
+		}
+		return false;
+	}
+	if (codepoint > 0xFF)
+		return false;
+	character = static_cast<uint8_t>(codepoint);
+	return true;
+}
+
 // === End of Font class implementation ===
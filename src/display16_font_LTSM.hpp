@@ -14,12 +14,23 @@
 class display_Fonts
 {
 	public:
+		/*! Font data formats, see fonts README */
+		enum FontType_e : uint8_t
+		{
+			FontTypeFixed = 0,        /**< 4 control bytes, fixed size cells, width a multiple of 8 */
+			FontTypeProportional = 1, /**< 6 control bytes, glyph table, per glyph width, bearing and advance */
+			FontTypeCompressed = 2,   /**< As proportional, each glyph cell stored as runs of one colour */
+			FontTypeAntiAlias2 = 3,   /**< As proportional, 2 bits per pixel coverage, blended with the background */
+			FontTypeAntiAlias4 = 4    /**< As proportional, 4 bits per pixel coverage, blended with the background */
+		};
+
 		display_Fonts();
 		~display_Fonts(){};
 		
 		DisLib16::Ret_Codes_e  setFont(const uint8_t* font);
 		void setInvertFont(bool invertStatus);
 		bool getInvertFont(void);
+		FontType_e getFontType(void) const;
 
 	protected:
 		const uint8_t*  _FontSelect = FontDefault;  /**< Pointer to the active font,  Fonts Stored are Const */
@@ -27,6 +38,31 @@ class display_Fonts
 		uint8_t _Font_Y_Size = 0x08; /**< Height Size of a Font character */
 		uint8_t _FontOffset = 0x20; /**< Offset in the ASCII table 0x00 to 0xFF, where font begins */
 		uint8_t _FontNumChars = 0x5F; /**< Number of characters in font (0x00 to 0xFE) -1 */
+		uint16_t _FontChangeCount = 0; /**< Incremented by each setFont, lets caches of font data detect a change */
+		FontType_e _FontType = FontTypeFixed; /**< Format of the active font */
+		uint8_t _FontBitsPerPixel = 1; /**< Bits per glyph pixel, 2 or 4 for anti-aliased fonts, else 1 */
+		static constexpr uint8_t _FontExtHeader = 6; /**< Control bytes of a proportional font */
+		static constexpr uint8_t _FontGlyphEntry = 8; /**< Bytes per glyph table entry of a proportional font */
+		static constexpr uint8_t _FontFlagCodepointMap = 0x01; /**< Flags bit, a codepoint map follows the control bytes */
+		static constexpr uint8_t _FontCodepointEntry = 4; /**< Bytes per codepoint map entry, 24 bit codepoint then character */
+		const uint8_t *_FontGlyphTable = nullptr; /**< Glyph table of an extended font */
+		const uint8_t *_FontCodepointMap = nullptr; /**< Codepoint map of an extended font, nullptr none */
+		uint8_t _FontCodepointCount = 0; /**< Entries in the codepoint map */
+
+		/*! @brief One glyph of a proportional font, read from the glyph table */
+		struct font_glyph_t
+		{
+			const uint8_t *bitmap; /**< First byte of the glyph data, bits or runs by font type */
+			uint8_t width;         /**< Width of the glyph bits */
+			uint8_t height;        /**< Height of the glyph bits */
+			int8_t xOffset;        /**< Left bearing, columns from the cell left to the glyph bits */
+			int8_t yOffset;        /**< Rows from the top of the text line to the glyph bits */
+			uint8_t xAdvance;      /**< Cell width, cursor advance */
+		};
+		void getFontGlyph(uint8_t character, font_glyph_t &glyph) const;
+		uint8_t getCharAdvance(uint8_t character) const;
+		bool getCodepointChar(uint32_t codepoint, uint8_t &character) const;
+		DisLib16::Ret_Codes_e swapFont(const uint8_t* font);
 	private:
 		bool _FontInverted = false; /**< display font inverted? , False = no invert , true = invert*/
 };
@@ -18,26 +18,1204 @@ display16_graphics_LTSM::display16_graphics_LTSM() {}
 	@param color 565 16-bit
 	@details  By default uses spiWriteDataBuffer method to write each row as a buffer for speed.
 			Much faster than pixel by pixel spi byte writes
-			If dislib16_ADVANCED_SCREEN_BUFFER_ENABLE is defined then the function 
-			will use the screen buffer to draw the pixel into VRAM.
+			If dislib16_ADVANCED_SCREEN_BUFFER_ENABLE is defined and a buffer is set
+			then the function will draw the pixel into the screen buffer instead of VRAM.
 			Will return early if x or y are out of bounds.
+			Between beginPixelBatch and endPixelBatch pixels that continue the last one in 
+			raster order are held as a run and sent through one address window.
 */
 void display16_graphics_LTSM ::drawPixel(uint16_t x, uint16_t y, uint16_t color)
 {
 	if ((x >= _width) || (y >= _height))
 		return;
 #ifdef dislib16_ADVANCED_SCREEN_BUFFER_ENABLE
-	// Calculate the index in the buffer
-	size_t index = (y * _width + x) * 2; // 2 bytes per pixel for RGB565
-	// Write the color to the buffer
-	_screenBuffer[index] = (uint8_t)(color >> 8);     // High byte
-	_screenBuffer[index + 1] = (uint8_t)(color & 0xFF); // Low byte
+	if (isBufferActive())
+	{
+		// Calculate the index in the buffer
+		size_t index = (static_cast<size_t>(y) * _width + x) * 2; // 2 bytes per pixel for RGB565
+		// Write the color to the buffer
+		_screenBuffer[index] = (uint8_t)(color >> 8);     // High byte
+		_screenBuffer[index + 1] = (uint8_t)(color & 0xFF); // Low byte
+		markBufferDirty(x, y, 1, 1);
+		return;
+	}
+#endif
+	pixelRunAppend(x, y, color);
+	if (_pixelBatchDepth == 0)
+		flushPixelRun();
+}
+
+/*!
+	@brief Starts a batch of drawPixel calls. 
+	@details Inside a batch, a pixel to the right of the last one, or at the start of the 
+		next row of the run window, is added to the pending run instead of opening its own
+		address window. The run is sent on a discontinuity, when full, before any other SPI 
+		traffic to the display and at the end of the outermost batch. Batches nest, the 
+		graphics functions that draw by pixel use one internally.
+*/
+void display16_graphics_LTSM::beginPixelBatch(void)
+{
+	if (_pixelBatchDepth < 0xFF)
+		_pixelBatchDepth++;
+}
+
+/*!
+	@brief Ends a batch of drawPixel calls, the outermost end sends the pending run.
+*/
+void display16_graphics_LTSM::endPixelBatch(void)
+{
+	if (_pixelBatchDepth == 0)
+		return;
+	if (--_pixelBatchDepth == 0)
+		flushPixelRun();
+}
+
+/*!
+	@brief Gets the number of address windows drawPixel did not send because 
+		the pixel joined a pending run.
+	@return windows saved since start or resetPixelWindowsSaved
+*/
+uint32_t display16_graphics_LTSM::getPixelWindowsSaved(void) const
+{
+	return _pixelWindowsSaved;
+}
+
+/*!
+	@brief Resets the count of address windows saved by pixel runs.
+*/
+void display16_graphics_LTSM::resetPixelWindowsSaved(void)
+{
+	_pixelWindowsSaved = 0;
+}
+
+/*!
+	@brief Sets the scratch arena used to build text characters and bitmap rows before sending.
+	@param buffer user buffer, must outlive its use by the display, nullptr restores the 
+		internal arena of dislib16_SCRATCH_BYTES (USER OPTION 5)
+	@param size bytes in buffer, at least 2
+	@details Items larger than the arena are sent in chunks of its size, so the arena 
+		only changes the number of SPI block writes, not the output. 
+		getScratchHighWater gives the size that would send every item so far in one piece.
+	@return
+		-# DisLib16::Success
+		-# DisLib16::BufferSize size too small, arena unchanged
+*/
+DisLib16::Ret_Codes_e display16_graphics_LTSM::setScratchBuffer(uint8_t *buffer, uint32_t size)
+{
+	if (buffer == nullptr)
+	{
+		_scratch = _scratchInternal;
+		_scratchSize = dislib16_SCRATCH_BYTES;
+		return DisLib16::Success;
+	}
+	if (size < 2)
+	{
+		#ifdef dislib16_DEBUG_MODE_ENABLE
+			Serial.println("Error: setScratchBuffer: size must be at least 2 bytes");
+		#endif
+		return DisLib16::BufferSize;
+	}
+	_scratch = buffer;
+	_scratchSize = size;
+	return DisLib16::Success;
+}
+
+/*!
+	@brief Gets the size of the scratch arena in use.
+	@return bytes
+*/
+uint32_t display16_graphics_LTSM::getScratchSize(void) const
+{
+	return _scratchSize;
+}
+
+/*!
+	@brief Gets the scratch arena high water mark, the largest piece asked of it:
+		one character of the font for text, one row for bitmaps.
+	@return bytes, an arena this size or larger sends each item in one SPI block write
+*/
+uint32_t display16_graphics_LTSM::getScratchHighWater(void) const
+{
+	return _scratchHighWater;
+}
+
+/*!
+	@brief Resets the scratch arena high water mark.
+*/
+void display16_graphics_LTSM::resetScratchHighWater(void)
+{
+	_scratchHighWater = 0;
+}
+
+#ifdef dislib16_GLYPH_CACHE_ENABLE
+/*!
+	@brief Sets the byte budget of the glyph cache (USER OPTION 6).
+	@param budgetBytes bytes for cached glyphs, 0 frees the cache and turns it off
+	@details Characters drawn in the character frame buffer method, and in screen buffer mode,
+		are kept as ready to send RGB565 blocks of Font_X_Size * Font_Y_Size * 2 bytes, 
+		keyed on font, character and colours (after font invert). 
+		The least recently used glyph is replaced when the cache is full, 
+		up to 254 glyphs are held. setFont empties the cache, the slot size follows the font.
+		Drawing the same characters again then skips the font bit expansion.
+	@return
+		-# DisLib16::Success
+		-# DisLib16::MemoryAError allocation failed, cache off
+*/
+DisLib16::Ret_Codes_e display16_graphics_LTSM::setGlyphCache(uint32_t budgetBytes)
+{
+	_glyphCacheBudget = budgetBytes;
+	_glyphCacheData.clear();
+	_glyphCacheData.shrink_to_fit();
+	_glyphCacheEntries.clear();
+	_glyphCacheEntries.shrink_to_fit();
+	_glyphCacheFont = nullptr; // slots sized on next sync
+	if (budgetBytes == 0)
+		return DisLib16::Success;
+	glyphCacheSync();
+	if (_glyphCacheEntries.empty() && budgetBytes >= _glyphCacheSlotBytes)
+	{
+		#ifdef dislib16_DEBUG_MODE_ENABLE
+			Serial.println("Error: setGlyphCache: Memory allocation failed");
+		#endif
+		_glyphCacheBudget = 0;
+		return DisLib16::MemoryAError;
+	}
+	return DisLib16::Success;
+}
+
+/*!
+	@brief Empties the glyph cache, budget and statistics are kept.
+*/
+void display16_graphics_LTSM::clearGlyphCache(void)
+{
+	for (glyph_cache_entry_t &entry : _glyphCacheEntries)
+		entry.valid = false;
+}
+
+/*!
+	@brief Gets the number of glyphs the cache holds for the current font.
+	@return slots, 0 cache off or budget smaller than one glyph
+*/
+uint8_t display16_graphics_LTSM::getGlyphCacheSlots(void) const
+{
+	return static_cast<uint8_t>(_glyphCacheEntries.size());
+}
+
+/*!
+	@brief Gets the number of glyph lookups found in the cache.
+	@return hits since last resetGlyphCacheStats
+*/
+uint32_t display16_graphics_LTSM::getGlyphCacheHits(void) const
+{
+	return _glyphCacheHits;
+}
+
+/*!
+	@brief Gets the number of glyph lookups not found in the cache.
+	@return misses since last resetGlyphCacheStats
+*/
+uint32_t display16_graphics_LTSM::getGlyphCacheMisses(void) const
+{
+	return _glyphCacheMisses;
+}
+
+/*!
+	@brief Resets the glyph cache hit and miss counters.
+*/
+void display16_graphics_LTSM::resetGlyphCacheStats(void)
+{
+	_glyphCacheHits = 0;
+	_glyphCacheMisses = 0;
+}
+#endif
+
+/// @cond
+
+/*!
+	@brief Adds a pixel to the pending run, or sends the run and starts a new one.
+		The run window is X0..X1 by Y0..YLast, the last row may be partial.
+		X1 is fixed when the run first wraps to the next row.
+	@param x column, on screen
+	@param y row, on screen
+	@param color 565 16-bit
+*/
+void display16_graphics_LTSM::pixelRunAppend(uint16_t x, uint16_t y, uint16_t color)
+{
+	bool extends = false;
+	if (_pixelRunCount > 0 && _pixelRunCount < _pixelRunMax)
+	{
+		if (y == _pixelRunYLast && x == _pixelRunXLast + 1)
+		{
+			extends = (_pixelRunX1 == _pixelRunOpenRow) || (x <= _pixelRunX1);
+		}
+		else if (y == _pixelRunYLast + 1 && x == _pixelRunX0)
+		{
+			if (_pixelRunX1 == _pixelRunOpenRow)
+			{
+				_pixelRunX1 = _pixelRunXLast;
+				extends = true;
+			}
+			else
+			{
+				extends = (_pixelRunXLast == _pixelRunX1);
+			}
+		}
+	}
+	if (extends)
+	{
+		_pixelWindowsSaved++;
+	}
+	else
+	{
+		flushPixelRun();
+		_pixelRunX0 = x;
+		_pixelRunY0 = y;
+		_pixelRunX1 = _pixelRunOpenRow;
+	}
+	_pixelRunXLast = x;
+	_pixelRunYLast = y;
+	_pixelRunBuffer[_pixelRunCount * 2] = color >> 8;
+	_pixelRunBuffer[_pixelRunCount * 2 + 1] = color & 0xFF;
+	_pixelRunCount++;
+}
+
+/*!
+	@brief Sends the pending pixel run, if any, through one address window.
+		The run is emptied first, as setAddrWindow and the data write
+		start transactions which would otherwise send it again.
+*/
+void display16_graphics_LTSM::flushPixelRun(void)
+{
+	if (_pixelRunCount == 0)
+		return;
+	uint8_t count = _pixelRunCount;
+	_pixelRunCount = 0;
+	uint16_t x1 = (_pixelRunX1 == _pixelRunOpenRow) ? _pixelRunXLast : _pixelRunX1;
+	setAddrWindow(_pixelRunX0, _pixelRunY0, x1, _pixelRunYLast);
+	spiWriteScratchBuffer(_pixelRunBuffer, count * 2);
+}
+
+/*!
+	@brief Gets the scratch arena for a piece of pixel data and records the high water mark.
+	@param wanted bytes the piece needs
+	@param granted set to bytes usable per chunk, a whole number of pixels
+	@return the scratch arena
+*/
+uint8_t *display16_graphics_LTSM::scratchAcquire(uint32_t wanted, uint32_t &granted)
+{
+	if (wanted > _scratchHighWater)
+		_scratchHighWater = wanted;
+	granted = (wanted < _scratchSize) ? wanted : (_scratchSize & ~static_cast<uint32_t>(1));
+	return _scratch;
+}
+
+/*!
+	@brief Can text be drawn as character runs, buffered text mode straight to VRAM.
+		Compressed fonts are decoded, scaled and transparent text expanded, one character at a time.
+	@return true if writeCharRun may be used
+*/
+bool display16_graphics_LTSM::charRunEnabled(void) const
+{
+	if (_textCharPixelOrBuffer || _textTransparent || _FontType == FontTypeCompressed || _textScale > 1)
+		return false;
+#ifdef dislib16_ADVANCED_SCREEN_BUFFER_ENABLE
+	if (isBufferActive())
+		return false;
+#endif
+	return true;
+}
+
+/*!
+	@brief Counts the leading characters of a run that are in the font range and fit on the line.
+	@param text characters
+	@param count characters to check at most
+	@param cursor x position of the first character
+	@param wrap true: stop before a character that would pass the right edge, the first is always counted.
+		false: stop at the first character starting past the right edge, the last may be clipped.
+	@param advance set to the width of the counted characters
+	@return number of drawable characters before the first control or out of range character, or the line end
+*/
+uint16_t display16_graphics_LTSM::charRunLength(const uint8_t *text, uint16_t count, int32_t cursor, bool wrap, uint32_t &advance) const
+{
+	uint16_t length = 0;
+	advance = 0;
+	while (length < count)
+	{
+		const uint8_t character = text[length];
+		if (character == '\n' || character == '\r' || character < _FontOffset ||
+			character >= (_FontOffset + _FontNumChars + 1))
+			break;
+		const int32_t start = cursor + static_cast<int32_t>(advance);
+		const uint8_t charWidth = getCharAdvance(character);
+		if (wrap ? (length > 0 && start + charWidth > _width) : (start >= _width))
+			break;
+		advance += charWidth;
+		length++;
+	}
+	return length;
+}
+
+/*!
+	@brief Draws a run of characters on one text line through one address window.
+		Glyph rows are rasterised across the whole run, so the band goes out in 
+		raster order, built in the scratch arena and sent in chunks. 
+		Columns past the right edge of the screen are clipped.
+	@param x left column, on screen
+	@param y top row, on screen
+	@param text characters, all in font range, see charRunLength
+	@param count number of characters
+	@param advance width of the characters, from charRunLength
+*/
+void display16_graphics_LTSM::writeCharRun(uint16_t x, uint16_t y, const uint8_t *text, uint16_t count, uint32_t advance)
+{
+#if defined(ESP8266)
+	// ESP8266 needs a periodic yield() call to avoid watchdog reset.
+	yield();
+#endif
+	uint16_t ltextcolor = _textcolor;
+	uint16_t ltextbgcolor = _textbgcolor;
+	if (getInvertFont() == true)
+	{
+		ltextbgcolor = _textcolor;
+		ltextcolor = _textbgcolor;
+	}
+	const uint8_t fgHi = ltextcolor >> 8, fgLo = ltextcolor & 0xFF;
+	const uint8_t bgHi = ltextbgcolor >> 8, bgLo = ltextbgcolor & 0xFF;
+	const uint32_t glyphBytes = (static_cast<uint32_t>(_Font_X_Size) * _Font_Y_Size) / 8;
+	const uint16_t rowBytes = _Font_X_Size / 8;
+	const bool proportional = (_FontType != FontTypeFixed);
+	if (proportional)
+		textRampSync(ltextcolor, ltextbgcolor);
+	uint32_t visible = advance;
+	if (visible > static_cast<uint32_t>(_width - x))
+		visible = _width - x;
+	if (visible == 0)
+		return;
+	uint32_t chunkBytes = 0;
+	uint8_t *buffer = scratchAcquire(visible * _Font_Y_Size * 2, chunkBytes);
+	uint32_t bufferIndex = 0;
+#ifdef dislib16_GLYPH_CACHE_ENABLE
+	// Look up the visible characters once, cached ones are copied row by row below
+	uint8_t slots[_glyphCacheRunMemo];
+	uint16_t slotCount = proportional ? 0 : static_cast<uint16_t>((visible + _Font_X_Size - 1) / _Font_X_Size);
+	if (slotCount > _glyphCacheRunMemo)
+		slotCount = _glyphCacheRunMemo;
+	_glyphCacheTick++;
+	for (uint16_t i = 0; i < slotCount; i++)
+		slots[i] = glyphCacheFind(text[i], ltextcolor, ltextbgcolor);
+#endif
+	setAddrWindow(x, y, x + visible - 1, y + _Font_Y_Size - 1);
+	spiStartTransaction();
+	DISPLAY16_DC_SetHigh;
+	for (uint16_t cy = 0; cy < _Font_Y_Size; cy++)
+	{
+		uint32_t column = 0;
+		for (uint16_t i = 0; i < count && column < visible; i++)
+		{
+			font_glyph_t glyph;
+			uint16_t glyphCols = _Font_X_Size;
+			if (proportional)
+			{
+				getFontGlyph(text[i], glyph);
+				glyphCols = glyph.xAdvance;
+			}
+			if (glyphCols > visible - column)
+				glyphCols = visible - column;
+			column += glyphCols;
+			if (proportional) // cell row: bearing, glyph pixels, background to the advance
+			{
+				for (uint16_t cx = 0; cx < glyphCols; cx++)
+				{
+					const uint16_t color = _textRamp[glyphLevel(glyph, cx, cy)];
+					buffer[bufferIndex++] = color >> 8;
+					buffer[bufferIndex++] = color & 0xFF;
+					if (bufferIndex == chunkBytes)
+					{
+						spiWriteScratchBytes(buffer, bufferIndex);
+						bufferIndex = 0;
+					}
+				}
+				continue;
+			}
+#ifdef dislib16_GLYPH_CACHE_ENABLE
+			if (i < slotCount && slots[i] != _glyphCacheNone)
+			{
+				const uint8_t *cached = &_glyphCacheData[slots[i] * _glyphCacheSlotBytes + cy * _Font_X_Size * 2];
+				uint32_t remaining = static_cast<uint32_t>(glyphCols) * 2;
+				while (remaining > 0)
+				{
+					uint32_t piece = chunkBytes - bufferIndex;
+					if (piece > remaining)
+						piece = remaining;
+					memcpy(&buffer[bufferIndex], cached, piece);
+					cached += piece;
+					remaining -= piece;
+					bufferIndex += piece;
+					if (bufferIndex == chunkBytes)
+					{
+						spiWriteScratchBytes(buffer, bufferIndex);
+						bufferIndex = 0;
+					}
+				}
+				continue;
+			}
+#endif
+			const uint8_t *src = _FontSelect + 4 + ((text[i] - _FontOffset) * glyphBytes) + (cy * rowBytes);
+			uint8_t bits = 0;
+			for (uint16_t cx = 0; cx < glyphCols; cx++)
+			{
+				if ((cx & 7) == 0)
+					bits = pgm_read_byte(src++);
+				const bool on = bits & 0x80;
+				bits <<= 1;
+				buffer[bufferIndex++] = on ? fgHi : bgHi;
+				buffer[bufferIndex++] = on ? fgLo : bgLo;
+				if (bufferIndex == chunkBytes)
+				{
+					spiWriteScratchBytes(buffer, bufferIndex);
+					bufferIndex = 0;
+				}
+			}
+		}
+	}
+	if (bufferIndex > 0)
+		spiWriteScratchBytes(buffer, bufferIndex);
+	spiEndTransaction();
+}
+
+/*!
+	@brief Coverage level of a pixel of a glyph cell.
+	@param glyph glyph from getFontGlyph
+	@param col column in the cell, 0 to xAdvance-1
+	@param row row in the cell, 0 to Font_Y_Size-1
+	@return 0 for background up to (1 << _FontBitsPerPixel) - 1 for full foreground,
+		an index into _textRamp
+	@details Glyph pixels are packed _FontBitsPerPixel bits each, row major, MSB first,
+		rows not padded to a byte.
+*/
+uint8_t display16_graphics_LTSM::glyphLevel(const font_glyph_t &glyph, uint16_t col, uint16_t row) const
+{
+	const int16_t gx = static_cast<int16_t>(col) - glyph.xOffset;
+	const int16_t gy = static_cast<int16_t>(row) - glyph.yOffset;
+	if (gx < 0 || gy < 0 || gx >= glyph.width || gy >= glyph.height)
+		return 0;
+	const uint16_t bit = ((gy * glyph.width) + gx) * _FontBitsPerPixel;
+	const uint8_t shift = 8 - _FontBitsPerPixel - (bit & 7);
+	return (pgm_read_byte(&glyph.bitmap[bit >> 3]) >> shift) & ((1 << _FontBitsPerPixel) - 1);
+}
+
+/*!
+	@brief Builds the colour ramp of the text colour pair, one RGB565 colour per coverage level.
+	@param fg foreground colour, after any font invert
+	@param bg background colour, after any font invert
+	@details Level 0 is bg, the top level fg, the levels between are blended per channel.
+		Kept until the colours or the bits per pixel of the font change, so each glyph pixel
+		is one table lookup. A 1 bit font has the two entry ramp bg, fg.
+*/
+void display16_graphics_LTSM::textRampSync(uint16_t fg, uint16_t bg)
+{
+	const uint8_t levels = 1 << _FontBitsPerPixel;
+	if (levels == _textRampLevels && fg == _textRampFg && bg == _textRampBg)
+		return;
+	for (uint8_t i = 0; i < levels; i++)
+		_textRamp[i] = blendColor(fg, bg, i, levels - 1);
+	_textRampLevels = levels;
+	_textRampFg = fg;
+	_textRampBg = bg;
+}
+
+/*!
+	@brief Blends two RGB565 colours per channel, rounded
+	@param fg colour at level top
+	@param bg colour at level 0
+	@param level 0 to top
+	@param top highest level, not 0
+	@return blended colour
+*/
+uint16_t display16_graphics_LTSM::blendColor(uint16_t fg, uint16_t bg, uint8_t level, uint8_t top)
+{
+	const uint8_t fgR = fg >> 11, fgG = (fg >> 5) & 0x3F, fgB = fg & 0x1F;
+	const uint8_t bgR = bg >> 11, bgG = (bg >> 5) & 0x3F, bgB = bg & 0x1F;
+	const uint16_t r = (bgR * (top - level) + fgR * level + (top / 2)) / top;
+	const uint16_t g = (bgG * (top - level) + fgG * level + (top / 2)) / top;
+	const uint16_t b = (bgB * (top - level) + fgB * level + (top / 2)) / top;
+	return (r << 11) | (g << 5) | b;
+}
+
+/*!
+	@brief Draws one character of a proportional or anti-aliased font, a cell of its advance by 
+		the line height. Glyph pixels are drawn through the colour ramp of fg and bg, the rest of 
+		the cell in bg. The cell is clipped at the screen edges.
+	@param x left column, on screen
+	@param y top row, on screen
+	@param character character in font range
+	@param fg foreground colour, after any font invert
+	@param bg background colour, after any font invert
+	@return DisLib16::Success
+*/
+DisLib16::Ret_Codes_e display16_graphics_LTSM::writeCharProportional(uint16_t x, uint16_t y, uint8_t character, uint16_t fg, uint16_t bg)
+{
+	font_glyph_t glyph;
+	getFontGlyph(character, glyph);
+	uint16_t cols = glyph.xAdvance;
+	if ((x + cols) > _width)
+		cols = _width - x;
+	uint16_t rows = _Font_Y_Size;
+	if ((y + rows) > _height)
+		rows = _height - y;
+	if (cols == 0 || rows == 0)
+		return DisLib16::Success;
+	textRampSync(fg, bg);
+#ifdef dislib16_ADVANCED_SCREEN_BUFFER_ENABLE
+	if (isBufferActive())
+	{
+		markBufferDirty(x, y, cols, rows);
+		for (uint16_t cy = 0; cy < rows; cy++)
+		{
+			uint8_t *dst = &_screenBuffer[(static_cast<size_t>(y + cy) * _width + x) * 2];
+			for (uint16_t cx = 0; cx < cols; cx++)
+			{
+				const uint16_t color = _textRamp[glyphLevel(glyph, cx, cy)];
+				*dst++ = color >> 8;
+				*dst++ = color & 0xFF;
+			}
+		}
+		return DisLib16::Success;
+	}
+#endif
+	if (_textCharPixelOrBuffer)
+	{
+		beginPixelBatch();
+		for (uint16_t cy = 0; cy < rows; cy++)
+			for (uint16_t cx = 0; cx < cols; cx++)
+				drawPixel(x + cx, y + cy, _textRamp[glyphLevel(glyph, cx, cy)]);
+		endPixelBatch();
+		return DisLib16::Success;
+	}
+#if defined(ESP8266)
+	// ESP8266 needs a periodic yield() call to avoid watchdog reset.
+	yield();
+#endif
+	uint32_t chunkBytes = 0;
+	uint8_t *buffer = scratchAcquire(static_cast<uint32_t>(cols) * rows * 2, chunkBytes);
+	uint32_t bufferIndex = 0;
+	setAddrWindow(x, y, x + cols - 1, y + rows - 1);
+	spiStartTransaction();
+	DISPLAY16_DC_SetHigh;
+	for (uint16_t cy = 0; cy < rows; cy++)
+	{
+		for (uint16_t cx = 0; cx < cols; cx++)
+		{
+			const uint16_t color = _textRamp[glyphLevel(glyph, cx, cy)];
+			buffer[bufferIndex++] = color >> 8;
+			buffer[bufferIndex++] = color & 0xFF;
+			if (bufferIndex == chunkBytes)
+			{
+				spiWriteScratchBytes(buffer, bufferIndex);
+				bufferIndex = 0;
+			}
+		}
+	}
+	if (bufferIndex > 0)
+		spiWriteScratchBytes(buffer, bufferIndex);
+	spiEndTransaction();
+	return DisLib16::Success;
+}
+
+/*!
+	@brief Draws one character of a compressed font, a cell of its advance by the line height.
+		The cell is decoded run by run as it is sent, each run a span fill of the scratch arena,
+		on ESP32 and ESP8266 hardware SPI runs of _fontRunFillMin pixels or more go out as 
+		colour pattern writes. The cell is clipped at the screen edges.
+	@param x left column, on screen
+	@param y top row, on screen
+	@param character character in font range
+	@param fg foreground colour, after any font invert
+	@param bg background colour, after any font invert
+	@details The cell is stored row by row, a code byte each:
+		-# 1lllllll foreground run of l+1 pixels
+		-# 00llllll background run of l+1 pixels
+		-# 01rrrrrr the last stored row again, r+1 times
+		Runs do not cross rows. Only the current row is decoded, never the whole glyph.
+	@return DisLib16::Success
+*/
+DisLib16::Ret_Codes_e display16_graphics_LTSM::writeCharCompressed(uint16_t x, uint16_t y, uint8_t character, uint16_t fg, uint16_t bg)
+{
+	font_glyph_t glyph;
+	getFontGlyph(character, glyph);
+	const uint16_t cellW = glyph.xAdvance;
+	uint16_t cols = cellW;
+	if ((x + cols) > _width)
+		cols = _width - x;
+	uint16_t rows = _Font_Y_Size;
+	if ((y + rows) > _height)
+		rows = _height - y;
+	if (cols == 0 || rows == 0)
+		return DisLib16::Success;
+	enum { ToVRAM, ToPixels, ToBuffer } target = _textCharPixelOrBuffer ? ToPixels : ToVRAM;
+#ifdef dislib16_ADVANCED_SCREEN_BUFFER_ENABLE
+	if (isBufferActive())
+	{
+		target = ToBuffer;
+		markBufferDirty(x, y, cols, rows);
+	}
+#endif
+	uint32_t chunkBytes = 0;
+	uint8_t *buffer = nullptr;
+	uint32_t bufferIndex = 0;
+	if (target == ToVRAM)
+	{
+#if defined(ESP8266)
+		// ESP8266 needs a periodic yield() call to avoid watchdog reset.
+		yield();
+#endif
+		buffer = scratchAcquire(static_cast<uint32_t>(cols) * rows * 2, chunkBytes);
+		setAddrWindow(x, y, x + cols - 1, y + rows - 1);
+		spiStartTransaction();
+		DISPLAY16_DC_SetHigh;
+	}
+	else if (target == ToPixels)
+		beginPixelBatch();
+	// Runs are sent as colour fills where the core has a pattern write, else filled in the scratch arena
+#if (defined(ESP32) || defined(ESP8266)) && !defined(dislib16_SPI_BYTE_TRANSFER_ENABLE)
+	const uint16_t fillMin = _hardwareSPI ? _fontRunFillMin : 0xFFFF;
 #else
-	setAddrWindow(x, y, x + 1, y + 1);
-	uint8_t TransmitBuffer[2]{(uint8_t)(color >> 8), (uint8_t)(color & 0xFF)};
-	spiWriteDataBuffer(TransmitBuffer, 2);
+	const uint16_t fillMin = 0xFFFF;
+#endif
+	const uint8_t *src = glyph.bitmap;
+	const uint8_t *rowCodes = src; // runs of the last row stored, for repeats
+	uint8_t repeats = 0;
+	for (uint16_t cy = 0; cy < rows; cy++)
+	{
+		const uint8_t *codes = rowCodes;
+		if (repeats > 0)
+			repeats--;
+		else if ((pgm_read_byte(src) & 0xC0) == 0x40) // repeat the last row, this is the first
+			repeats = pgm_read_byte(src++) & 0x3F;
+		else
+			codes = rowCodes = src;
+		uint16_t cx = 0;
+		while (cx < cellW)
+		{
+			const uint8_t code = pgm_read_byte(codes++);
+			const uint16_t color = (code & 0x80) ? fg : bg;
+			const uint16_t length = (code & 0x80) ? (code & 0x7F) + 1 : (code & 0x3F) + 1;
+			uint16_t visible = (cx < cols) ? cols - cx : 0;
+			if (visible > length)
+				visible = length;
+			const uint16_t runX = cx;
+			cx += length;
+			if (visible == 0)
+				continue; // clipped
+			if (target == ToVRAM)
+			{
+				if (visible >= fillMin)
+				{
+					if (bufferIndex > 0)
+						spiWriteScratchBytes(buffer, bufferIndex);
+					bufferIndex = 0;
+					spiWriteColorRepeat(color, visible);
+					continue;
+				}
+				while (visible > 0) // span fill of the scratch arena, in chunks
+				{
+					uint16_t piece = (chunkBytes - bufferIndex) / 2;
+					if (piece > visible)
+						piece = visible;
+					bufferFillSpan(&buffer[bufferIndex], piece, color);
+					bufferIndex += piece * 2;
+					visible -= piece;
+					if (bufferIndex == chunkBytes)
+					{
+						spiWriteScratchBytes(buffer, bufferIndex);
+						bufferIndex = 0;
+					}
+				}
+			}
+			else if (target == ToPixels)
+			{
+				for (uint16_t i = 0; i < visible; i++)
+					drawPixel(x + runX + i, y + cy, color);
+			}
+#ifdef dislib16_ADVANCED_SCREEN_BUFFER_ENABLE
+			else
+				bufferFillSpan(&_screenBuffer[(static_cast<size_t>(y + cy) * _width + x + runX) * 2], visible, color);
+#endif
+		}
+		if (codes > src)
+			src = codes; // a stored row was read, continue after it
+	}
+	if (target == ToVRAM)
+	{
+		if (bufferIndex > 0)
+			spiWriteScratchBytes(buffer, bufferIndex);
+		spiEndTransaction();
+	}
+	else if (target == ToPixels)
+		endPixelBatch();
+	return DisLib16::Success;
+}
+
+/*!
+	@brief Draws one character at the text scale, a cell of its advance by the line height, 
+		both times the scale. Any font type. The cell is clipped at the screen edges.
+	@param x left column, on screen
+	@param y top row, on screen
+	@param character character in font range
+	@param fg foreground colour, after any font invert
+	@param bg background colour, after any font invert
+	@details Drawn one font row, a band of scale screen rows, at a time. The band row is
+		expanded once into the scratch arena and copied for the other rows of the band 
+		while they fit the chunk, so RAM use is bounded by the scratch arena, not the scale. 
+		A band row wider than the scratch arena is expanded and sent in pieces.
+	@return DisLib16::Success
+*/
+DisLib16::Ret_Codes_e display16_graphics_LTSM::writeCharScaled(uint16_t x, uint16_t y, uint8_t character, uint16_t fg, uint16_t bg)
+{
+	font_glyph_t glyph;
+	getFontGlyph(character, glyph);
+	const uint8_t scale = _textScale;
+	const bool compressed = (_FontType == FontTypeCompressed);
+	uint32_t cols = static_cast<uint32_t>(glyph.xAdvance) * scale;
+	if ((x + cols) > _width)
+		cols = _width - x;
+	uint32_t rows = static_cast<uint32_t>(_Font_Y_Size) * scale;
+	if ((y + rows) > _height)
+		rows = _height - y;
+	if (cols == 0 || rows == 0)
+		return DisLib16::Success;
+	textRampSync(fg, bg);
+	enum { ToVRAM, ToPixels, ToBuffer } target = _textCharPixelOrBuffer ? ToPixels : ToVRAM;
+#ifdef dislib16_ADVANCED_SCREEN_BUFFER_ENABLE
+	if (isBufferActive())
+	{
+		target = ToBuffer;
+		markBufferDirty(x, y, cols, rows);
+	}
+#endif
+	const uint32_t rowBytes = cols * 2;
+	uint32_t chunkBytes = 0;
+	uint8_t *buffer = nullptr;
+	uint32_t bufferIndex = 0;
+	if (target == ToVRAM)
+	{
+#if defined(ESP8266)
+		// ESP8266 needs a periodic yield() call to avoid watchdog reset.
+		yield();
+#endif
+		buffer = scratchAcquire(rowBytes * rows, chunkBytes);
+		setAddrWindow(x, y, x + cols - 1, y + rows - 1);
+		spiStartTransaction();
+		DISPLAY16_DC_SetHigh;
+	}
+	else if (target == ToPixels)
+	{
+		buffer = scratchAcquire(rowBytes, chunkBytes);
+		beginPixelBatch();
+	}
+	const uint8_t *src = glyph.bitmap; // compressed fonts, as writeCharCompressed
+	const uint8_t *rowCodes = src;
+	uint8_t repeats = 0;
+	for (uint16_t cy = 0, band = 0; band < rows; cy++, band += scale)
+	{
+		const uint8_t *codes = nullptr;
+		if (compressed)
+		{
+			codes = rowCodes;
+			if (repeats > 0)
+				repeats--;
+			else if ((pgm_read_byte(src) & 0xC0) == 0x40)
+				repeats = pgm_read_byte(src++) & 0x3F;
+			else
+				codes = rowCodes = src;
+		}
+		const uint8_t *rowEnd = codes;
+		const uint32_t bandRows = (rows - band < scale) ? rows - band : scale;
+		if (target == ToBuffer)
+		{
+#ifdef dislib16_ADVANCED_SCREEN_BUFFER_ENABLE
+			uint8_t *dst = &_screenBuffer[(static_cast<size_t>(y + band) * _width + x) * 2];
+			rowEnd = textScaledRow(glyph, codes, cy, 0, cols, dst);
+			for (uint32_t i = 1; i < bandRows; i++)
+				memcpy(dst + (static_cast<size_t>(i) * _width * 2), dst, rowBytes);
+#endif
+		}
+		else if (target == ToVRAM && rowBytes <= chunkBytes)
+		{
+			for (uint32_t i = 0; i < bandRows; i++)
+			{
+				if (bufferIndex + rowBytes > chunkBytes)
+				{
+					spiWriteScratchBytes(buffer, bufferIndex);
+					bufferIndex = 0;
+				}
+				if (i > 0 && bufferIndex >= rowBytes) // previous row of the band is still in the chunk
+					memcpy(&buffer[bufferIndex], &buffer[bufferIndex - rowBytes], rowBytes);
+				else
+					rowEnd = textScaledRow(glyph, codes, cy, 0, cols, &buffer[bufferIndex]);
+				bufferIndex += rowBytes;
+			}
+		}
+		else // pixel mode, or a row wider than the chunk, in pieces
+		{
+			const uint16_t pieceMax = chunkBytes / 2;
+			for (uint32_t i = 0; i < bandRows; i++)
+			{
+				for (uint16_t col = 0; col < cols; col += pieceMax)
+				{
+					const uint16_t piece = (cols - col < pieceMax) ? cols - col : pieceMax;
+					rowEnd = textScaledRow(glyph, codes, cy, col, piece, buffer);
+					if (target == ToVRAM)
+					{
+						spiWriteScratchBytes(buffer, piece * 2);
+						continue;
+					}
+					for (uint16_t k = 0; k < piece; k++)
+						drawPixel(x + col + k, y + band + i, (buffer[k * 2] << 8) | buffer[(k * 2) + 1]);
+				}
+			}
+		}
+		if (rowEnd > src)
+			src = rowEnd; // a stored row was read, continue after it
+	}
+	if (target == ToVRAM)
+	{
+		if (bufferIndex > 0)
+			spiWriteScratchBytes(buffer, bufferIndex);
+		spiEndTransaction();
+	}
+	else if (target == ToPixels)
+		endPixelBatch();
+	return DisLib16::Success;
+}
+
+/*!
+	@brief Expands columns of one font row at the text scale, each font pixel scale wide.
+	@param glyph glyph from getFontGlyph
+	@param codes compressed fonts, first code of the row, else nullptr
+	@param row font row in the cell
+	@param firstCol first screen column of the cell to expand
+	@param cols number of screen columns to expand
+	@param dst RGB565 bytes, cols * 2
+	@return compressed fonts, the byte after the codes of the row, else nullptr
+*/
+const uint8_t *display16_graphics_LTSM::textScaledRow(const font_glyph_t &glyph, const uint8_t *codes, uint16_t row,
+	uint16_t firstCol, uint16_t cols, uint8_t *dst) const
+{
+	const uint8_t scale = _textScale;
+	const uint32_t lastCol = static_cast<uint32_t>(firstCol) + cols;
+	uint16_t fontCol = codes ? 0 : firstCol / scale; // compressed rows are walked from the start
+	uint32_t spanStart = static_cast<uint32_t>(fontCol) * scale;
+	while (fontCol < glyph.xAdvance)
+	{
+		uint16_t color;
+		uint16_t length = 1;
+		if (codes)
+		{
+			const uint8_t code = pgm_read_byte(codes++);
+			color = _textRamp[(code & 0x80) ? 1 : 0];
+			length = (code & 0x80) ? (code & 0x7F) + 1 : (code & 0x3F) + 1;
+		}
+		else
+		{
+			if (spanStart >= lastCol)
+				break;
+			color = _textRamp[glyphLevel(glyph, fontCol, row)];
+		}
+		fontCol += length;
+		const uint32_t spanEnd = spanStart + (static_cast<uint32_t>(length) * scale);
+		const uint32_t from = (spanStart > firstCol) ? spanStart : firstCol;
+		const uint32_t to = (spanEnd < lastCol) ? spanEnd : lastCol;
+		if (from < to)
+			bufferFillSpan(&dst[(from - firstCol) * 2], to - from, color);
+		spanStart = spanEnd;
+	}
+	return codes;
+}
+
+/*!
+	@brief Cursor advance of a character at the text scale
+	@param character character
+	@return advance in pixels
+*/
+uint16_t display16_graphics_LTSM::textAdvance(uint8_t character) const
+{
+	return static_cast<uint16_t>(getCharAdvance(character)) * _textScale;
+}
+
+/*!
+	@brief Text line height at the text scale
+	@return height in pixels
+*/
+uint16_t display16_graphics_LTSM::textLineHeight(void) const
+{
+	return static_cast<uint16_t>(_Font_Y_Size) * _textScale;
+}
+
+/*!
+	@brief Draws the foreground pixels of one character, the rest of its cell is left as it is.
+		Any font type, at the text scale. Clipped at the screen edges.
+	@param x left column, on screen
+	@param y top row, on screen
+	@param character character in font range
+	@param fg text colour, after any font invert
+	@details Each row is split into runs of set pixels. A run with the same columns as a run
+		of the row above grows that span, so vertical strokes are one rectangle. Spans are 
+		filled with fillRect, one address window each, or drawn by pixel in pixel text mode.
+		Anti-aliased fonts drawn into the screen buffer are blended with the buffer pixels.
+	@return DisLib16::Success
+*/
+DisLib16::Ret_Codes_e display16_graphics_LTSM::writeCharTransparent(uint16_t x, uint16_t y, uint8_t character, uint16_t fg)
+{
+	font_glyph_t glyph;
+	getFontGlyph(character, glyph);
+	const uint8_t scale = _textScale;
+	const uint8_t top = (1 << _FontBitsPerPixel) - 1;
+#ifdef dislib16_ADVANCED_SCREEN_BUFFER_ENABLE
+	if (isBufferActive() && top > 1) // blend each covered pixel with the buffer
+	{
+		for (uint16_t cy = 0; cy < glyph.height; cy++)
+		{
+			const uint32_t rowY = y + static_cast<uint32_t>(glyph.yOffset + cy) * scale;
+			for (uint16_t cx = 0; cx < glyph.width; cx++)
+			{
+				const uint8_t level = glyphLevel(glyph, glyph.xOffset + cx, glyph.yOffset + cy);
+				const uint32_t colX = x + static_cast<uint32_t>(glyph.xOffset + cx) * scale;
+				if (level == 0 || colX >= _width)
+					continue;
+				for (uint32_t py = rowY; py < rowY + scale && py < _height; py++)
+				{
+					for (uint32_t px = colX; px < colX + scale && px < _width; px++)
+					{
+						uint8_t *dst = &_screenBuffer[(static_cast<size_t>(py) * _width + px) * 2];
+						const uint16_t color = blendColor(fg, (dst[0] << 8) | dst[1], level, top);
+						dst[0] = color >> 8;
+						dst[1] = color & 0xFF;
+					}
+				}
+			}
+		}
+		markBufferDirty(x, y, glyph.xAdvance * scale, _Font_Y_Size * scale);
+		return DisLib16::Success;
+	}
+#endif
+	const uint8_t threshold = (top + 1) / 2; // 1 for 1 bit fonts
+	const bool compressed = (_FontType == FontTypeCompressed);
+	text_span_t spans[_textSpanMax];
+	uint8_t spanCount = 0;
+	if (_textCharPixelOrBuffer)
+		beginPixelBatch();
+	const uint8_t *src = glyph.bitmap; // compressed fonts, as writeCharCompressed
+	const uint8_t *rowCodes = src;
+	uint8_t repeats = 0;
+	for (uint16_t cy = 0; cy < _Font_Y_Size; cy++)
+	{
+		const uint32_t rowY = y + static_cast<uint32_t>(cy) * scale;
+		if (rowY >= _height)
+			break;
+		if (compressed)
+		{
+			const uint8_t *codes = rowCodes;
+			if (repeats > 0)
+				repeats--;
+			else if ((pgm_read_byte(src) & 0xC0) == 0x40)
+				repeats = pgm_read_byte(src++) & 0x3F;
+			else
+				codes = rowCodes = src;
+			uint16_t cx = 0;
+			while (cx < glyph.xAdvance)
+			{
+				const uint8_t code = pgm_read_byte(codes++);
+				const uint16_t length = (code & 0x80) ? (code & 0x7F) + 1 : (code & 0x3F) + 1;
+				const uint32_t runX = x + static_cast<uint32_t>(cx) * scale;
+				if ((code & 0x80) && runX < _width)
+					textSpanAdd(spans, spanCount, runX, rowY, length * scale, fg);
+				cx += length;
+			}
+			if (codes > src)
+				src = codes;
+		}
+		else if (cy >= glyph.yOffset && cy < glyph.yOffset + glyph.height)
+		{
+			const int16_t lastCol = glyph.xOffset + glyph.width;
+			int16_t runStart = -1;
+			for (int16_t cx = (glyph.xOffset > 0) ? glyph.xOffset : 0; cx <= lastCol; cx++)
+			{
+				const bool on = (cx < lastCol) && glyphLevel(glyph, cx, cy) >= threshold;
+				if (on && runStart < 0)
+					runStart = cx;
+				else if (!on && runStart >= 0)
+				{
+					const uint32_t runX = x + static_cast<uint32_t>(runStart) * scale;
+					if (runX < _width)
+						textSpanAdd(spans, spanCount, runX, rowY, (cx - runStart) * scale, fg);
+					runStart = -1;
+				}
+			}
+		}
+		// spans not grown by this row are complete
+		for (uint8_t i = 0; i < spanCount;)
+		{
+			if (spans[i].y + spans[i].h == rowY + scale)
+			{
+				i++;
+				continue;
+			}
+			textSpanFill(spans[i], fg);
+			spans[i] = spans[--spanCount];
+		}
+	}
+	for (uint8_t i = 0; i < spanCount; i++)
+		textSpanFill(spans[i], fg);
+	if (_textCharPixelOrBuffer)
+		endPixelBatch();
+	return DisLib16::Success;
+}
+
+/*!
+	@brief Adds a run of transparent text, growing an open span of the row above with the same columns
+	@param spans open spans
+	@param count number of open spans
+	@param x left column of the run
+	@param y top row of the run, its height is the text scale
+	@param w width of the run
+	@param color text colour, a run that can not be held open is filled at once
+*/
+void display16_graphics_LTSM::textSpanAdd(text_span_t *spans, uint8_t &count, uint16_t x, uint16_t y, uint16_t w, uint16_t color)
+{
+	for (uint8_t i = 0; i < count; i++)
+	{
+		if (spans[i].x == x && spans[i].w == w && (spans[i].y + spans[i].h) == y)
+		{
+			spans[i].h += _textScale;
+			return;
+		}
+	}
+	const text_span_t span = {x, y, w, _textScale};
+	if (count < _textSpanMax)
+		spans[count++] = span;
+	else
+		textSpanFill(span, color);
+}
+
+/*!
+	@brief Fills a span of transparent text, a rectangle fill, or by pixel in pixel text mode
+	@param span rectangle, clipped at the screen edges
+	@param color text colour
+*/
+void display16_graphics_LTSM::textSpanFill(const text_span_t &span, uint16_t color)
+{
+#ifdef dislib16_ADVANCED_SCREEN_BUFFER_ENABLE
+	if (isBufferActive())
+	{
+		fillRect(span.x, span.y, span.w, span.h, color);
+		return;
+	}
 #endif
+	if (!_textCharPixelOrBuffer)
+	{
+		fillRect(span.x, span.y, span.w, span.h, color);
+		return;
+	}
+	for (uint16_t py = span.y; py < span.y + span.h; py++)
+		for (uint16_t px = span.x; px < span.x + span.w; px++)
+			drawPixel(px, py, color);
+}
+
+#ifdef dislib16_GLYPH_CACHE_ENABLE
+/*!
+	@brief Sizes the glyph cache slots for the current font, emptying the cache 
+		if the font changed since the last call.
+*/
+void display16_graphics_LTSM::glyphCacheSync(void)
+{
+	const uint32_t slotBytes = static_cast<uint32_t>(_Font_X_Size) * _Font_Y_Size * 2;
+	if (_glyphCacheFont == _FontSelect && _glyphCacheFontChange == _FontChangeCount && _glyphCacheSlotBytes == slotBytes)
+		return;
+	_glyphCacheFont = _FontSelect;
+	_glyphCacheFontChange = _FontChangeCount;
+	_glyphCacheSlotBytes = slotBytes;
+	uint32_t slots = _glyphCacheBudget / slotBytes;
+	if (slots >= _glyphCacheNone) // 0xFF is the no slot value
+		slots = _glyphCacheNone - 1;
+	_glyphCacheEntries.assign(slots, glyph_cache_entry_t{nullptr, 0, 0, 0, false, 0});
+	_glyphCacheData.resize(slots * slotBytes);
+	if (_glyphCacheData.size() != slots * slotBytes || _glyphCacheEntries.size() != slots)
+	{
+		_glyphCacheEntries.clear();
+		_glyphCacheData.clear();
+	}
+}
+
+/*!
+	@brief Finds a glyph in the cache, on a miss expands it into the least recently used slot.
+	@param character character in font range
+	@param fg foreground colour, after any font invert
+	@param bg background colour, after any font invert
+	@return slot index, or _glyphCacheNone if the cache is off or every slot
+		is in use by the current draw call (same _glyphCacheTick)
+*/
+uint8_t display16_graphics_LTSM::glyphCacheFind(uint8_t character, uint16_t fg, uint16_t bg)
+{
+	if (_glyphCacheBudget == 0 || _FontType != FontTypeFixed)
+		return _glyphCacheNone;
+	// font swapped in by swapFont, not setFont, drawn without the cache so it keeps its slots
+	if (_glyphCacheFont != nullptr && _glyphCacheFont != _FontSelect && _glyphCacheFontChange == _FontChangeCount)
+		return _glyphCacheNone;
+	glyphCacheSync();
+	const uint8_t slots = static_cast<uint8_t>(_glyphCacheEntries.size());
+	uint8_t victim = _glyphCacheNone;
+	for (uint8_t i = 0; i < slots; i++)
+	{
+		glyph_cache_entry_t &entry = _glyphCacheEntries[i];
+		if (!entry.valid)
+		{
+			if (victim == _glyphCacheNone || _glyphCacheEntries[victim].valid)
+				victim = i;
+			continue;
+		}
+		if (entry.character == character && entry.fg == fg && entry.bg == bg && entry.font == _FontSelect)
+		{
+			entry.lastUsed = _glyphCacheTick;
+			_glyphCacheHits++;
+			return i;
+		}
+		if (victim == _glyphCacheNone || (_glyphCacheEntries[victim].valid && entry.lastUsed < _glyphCacheEntries[victim].lastUsed))
+			victim = i;
+	}
+	_glyphCacheMisses++;
+	if (victim == _glyphCacheNone)
+		return _glyphCacheNone;
+	glyph_cache_entry_t &entry = _glyphCacheEntries[victim];
+	if (entry.valid && entry.lastUsed == _glyphCacheTick)
+		return _glyphCacheNone;
+	// Expand the glyph bits, row major MSB first, into the slot
+	const uint8_t fgHi = fg >> 8, fgLo = fg & 0xFF;
+	const uint8_t bgHi = bg >> 8, bgLo = bg & 0xFF;
+	const uint32_t glyphPixels = static_cast<uint32_t>(_Font_X_Size) * _Font_Y_Size;
+	const uint8_t *src = _FontSelect + 4 + ((character - _FontOffset) * (glyphPixels / 8));
+	uint8_t *dst = &_glyphCacheData[victim * _glyphCacheSlotBytes];
+	uint8_t bits = 0;
+	for (uint32_t bit = 0; bit < glyphPixels; bit++)
+	{
+		if ((bit & 7) == 0)
+			bits = pgm_read_byte(src++);
+		const bool on = bits & 0x80;
+		bits <<= 1;
+		*dst++ = on ? fgHi : bgHi;
+		*dst++ = on ? fgLo : bgLo;
+	}
+	entry.font = _FontSelect;
+	entry.fg = fg;
+	entry.bg = bg;
+	entry.character = character;
+	entry.valid = true;
+	entry.lastUsed = _glyphCacheTick;
+	return victim;
 }
+#endif
+
+/// @endcond
 
 /*!
 	@brief fills a rectangle starting from coordinates (x,y) with width of w and height of h.
@@ -49,7 +1227,8 @@ void display16_graphics_LTSM ::drawPixel(uint16_t x, uint16_t y, uint16_t color)
 	@return
 		-# Display_Success for success
 		-# Display_ShapeScreenBounds out of screen bounds
-	@note  uses spiWriteBuffer method
+	@note  Same as fillRect with a return code, one address window with the colour 
+		streamed by spiWriteColorRepeat, or a span fill of the screen buffer when one is set.
 */
 DisLib16::Ret_Codes_e display16_graphics_LTSM::fillRectBuffer(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color)
 {
@@ -61,31 +1240,7 @@ DisLib16::Ret_Codes_e display16_graphics_LTSM::fillRectBuffer(uint16_t x, uint16
 		#endif
 		return DisLib16::ShapeScreenBounds;
 	}
-	if ((x + w - 1) >= _width)
-		w = _width - x;
-	if ((y + h - 1) >= _height)
-		h = _height - y;
-
-	// Convert color to bytes
-	uint8_t hi = color >> 8;
-	uint8_t lo = color;
-
-	// Row buffer for one row of the rectangle
-	uint8_t rowBuffer[w * 2]; // Each pixel is 2 bytes (16-bit color)
-	// Fill the row buffer with the color
-	for (uint32_t i = 0; i < w; i++)
-	{
-		rowBuffer[2 * i] = hi;
-		rowBuffer[2 * i + 1] = lo;
-	}
-	// Draw the rectangle row by row
-	for (uint16_t j = 0; j < h; j++)
-	{
-		// Set the address window for the current row
-		setAddrWindow(x, y + j, x + w - 1, y + j);
-		// Write the row buffer to the display
-		spiWriteDataBuffer(rowBuffer, w * 2);
-	}
+	fillRect(x, y, w, h, color);
 	return DisLib16::Success;
 }
 
@@ -107,22 +1262,7 @@ void display16_graphics_LTSM ::fillScreen(uint16_t color)
 */
 void display16_graphics_LTSM ::drawFastVLine(uint16_t x, uint16_t y, uint16_t h, uint16_t color)
 {
-	uint8_t hi, lo;
-	if ((x >= _width) || (y >= _height))
-		return;
-	if ((y + h - 1) >= _height)
-		h = _height - y;
-	hi = color >> 8;
-	lo = color;
-	setAddrWindow(x, y, x, y + h - 1);
-	DISPLAY16_DC_SetHigh;
-	spiStartTransaction();
-	while (h--)
-	{
-		spiWrite(hi);
-		spiWrite(lo);
-	}
-	spiEndTransaction();
+	fillRect(x, y, 1, h, color);
 }
 
 /*!
@@ -134,22 +1274,7 @@ void display16_graphics_LTSM ::drawFastVLine(uint16_t x, uint16_t y, uint16_t h,
 */
 void display16_graphics_LTSM ::drawFastHLine(uint16_t x, uint16_t y, uint16_t w, uint16_t color)
 {
-	uint8_t hi, lo;
-	if ((x >= _width) || (y >= _height))
-		return;
-	if ((x + w - 1) >= _width)
-		w = _width - x;
-	hi = color >> 8;
-	lo = color;
-	setAddrWindow(x, y, x + w - 1, y);
-	DISPLAY16_DC_SetHigh;
-	spiStartTransaction();
-	while (w--)
-	{
-		spiWrite(hi);
-		spiWrite(lo);
-	}
-	spiEndTransaction();
+	fillRect(x, y, w, 1, color);
 }
 
 /*!
@@ -296,13 +1421,13 @@ void display16_graphics_LTSM::fillCircleHelper(int16_t centerX, int16_t centerY,
 		// Draw the vertical lines for each part of the circle based on the cornerFlags
 		if (cornerFlags & 0x1) // Bottom-right corner
 		{
-			drawFastVLine(centerX + x, centerY - y, 2 * y + 1 + verticalOffset, color);
-			drawFastVLine(centerX + y, centerY - x, 2 * x + 1 + verticalOffset, color);
+			fillRect(centerX + x, centerY - y, 1, 2 * y + 1 + verticalOffset, color);
+			fillRect(centerX + y, centerY - x, 1, 2 * x + 1 + verticalOffset, color);
 		}
 		if (cornerFlags & 0x2) // Bottom-left corner
 		{
-			drawFastVLine(centerX - x, centerY - y, 2 * y + 1 + verticalOffset, color);
-			drawFastVLine(centerX - y, centerY - x, 2 * x + 1 + verticalOffset, color);
+			fillRect(centerX - x, centerY - y, 1, 2 * y + 1 + verticalOffset, color);
+			fillRect(centerX - y, centerY - x, 1, 2 * x + 1 + verticalOffset, color);
 		}
 	}
 }
@@ -318,7 +1443,7 @@ void display16_graphics_LTSM::fillCircleHelper(int16_t centerX, int16_t centerY,
 */
 void display16_graphics_LTSM::fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color)
 {
-	drawFastVLine(x0, y0 - r, 2 * r + 1, color);
+	fillRect(x0, y0 - r, 1, 2 * r + 1, color);
 	fillCircleHelper(x0, y0, r, 3, 0, color);
 }
 
@@ -371,6 +1496,7 @@ void display16_graphics_LTSM ::drawLine(int16_t x0, int16_t y0, int16_t x1, int1
 		ystep = -1;
 	}
 
+	beginPixelBatch(); // straight steps become pixel runs
 	for (; x0 <= x1; x0++)
 	{
 		if (steep)
@@ -386,6 +1512,7 @@ void display16_graphics_LTSM ::drawLine(int16_t x0, int16_t y0, int16_t x1, int1
 			err += dx;
 		}
 	}
+	endPixelBatch();
 }
 
 /*!
@@ -395,14 +1522,30 @@ void display16_graphics_LTSM ::drawLine(int16_t x0, int16_t y0, int16_t x1, int1
 	@param w width of the rectangle
 	@param h height of the rectangle
 	@param color color to fill  rectangle 565 16-bit
+	@details Clipped to the screen, then sent as one address window and one transaction,
+		the colour streamed by spiWriteColorRepeat. Used for the spans of the circle,
+		rounded rectangle and triangle fills.
 */
 void display16_graphics_LTSM ::fillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color)
 {
-	uint16_t i;
-	for (i = x; i < x + w; i++)
+	if ((x >= _width) || (y >= _height) || (w == 0) || (h == 0))
+		return;
+	if ((x + w - 1) >= _width)
+		w = _width - x;
+	if ((y + h - 1) >= _height)
+		h = _height - y;
+#ifdef dislib16_ADVANCED_SCREEN_BUFFER_ENABLE
+	if (isBufferActive())
 	{
-		drawFastVLine(i, y, h, color);
+		bufferFillRect(x, y, w, h, color);
+		return;
 	}
+#endif
+	setAddrWindow(x, y, x + w - 1, y + h - 1);
+	spiStartTransaction();
+	DISPLAY16_DC_SetHigh;
+	spiWriteColorRepeat(color, static_cast<uint32_t>(w) * h);
+	spiEndTransaction();
 }
 
 /*!
@@ -501,7 +1644,7 @@ void display16_graphics_LTSM ::fillTriangle(int16_t x0, int16_t y0, int16_t x1,
 			leftX = x2;
 		else if (x2 > rightX)
 			rightX = x2;
-		drawFastHLine(leftX, y0, rightX - leftX + 1, color);
+		fillRect(leftX, y0, rightX - leftX + 1, 1, color);
 		return;
 	}
 	int16_t dx01 = x1 - x0,
@@ -524,7 +1667,7 @@ void display16_graphics_LTSM ::fillTriangle(int16_t x0, int16_t y0, int16_t x1,
 		sb += dx02;
 		if (leftX > rightX)
 			swapint16t(leftX, rightX);
-		drawFastHLine(leftX, y, rightX - leftX + 1, color);
+		fillRect(leftX, y, rightX - leftX + 1, 1, color);
 	}
 	// Reset error terms for the lower part of the triangle
 	sa = dx12 * (y - y1);
@@ -538,7 +1681,7 @@ void display16_graphics_LTSM ::fillTriangle(int16_t x0, int16_t y0, int16_t x1,
 		sb += dx02;
 		if (leftX > rightX)
 			swapint16t(leftX, rightX);
-		drawFastHLine(leftX, y, rightX - leftX + 1, color);
+		fillRect(leftX, y, rightX - leftX + 1, 1, color);
 	}
 }
 
@@ -555,7 +1698,10 @@ void display16_graphics_LTSM ::setTextWrap(bool w) { _textwrap = w; }
 	@param  value Character to be written.
 	@note uses spiWriteDataBuffer method to write each character as a row by row buffer for speed.
 			Much faster than pixel by pixel spi byte writes,
-			if _textCharPixelOrBuffer = false. 
+			if _textCharPixelOrBuffer = false. When a screen buffer is set the
+			character is expanded straight into it in either mode.
+			With a text scale above 1 the character cell is drawn scale times larger, see setTextScale.
+			In transparent text mode only the foreground pixels are drawn, see setTextTransparent.
 	@return Will return DisLib16::Ret_Codes_e enum
 		-# DisLib16::Success  success
 		-# DisLib16::CharScreenBounds co-ords out of bounds check x and y
@@ -594,10 +1740,59 @@ DisLib16::Ret_Codes_e display16_graphics_LTSM::writeChar(uint16_t x, uint16_t y,
 		ltextbgcolor = _textbgcolor;
 		ltextcolor = _textcolor;
 	}
+	if (_textTransparent)
+		return writeCharTransparent(x, y, static_cast<uint8_t>(value), ltextcolor);
+	if (_textScale > 1)
+		return writeCharScaled(x, y, static_cast<uint8_t>(value), ltextcolor, ltextbgcolor);
+	if (_FontType == FontTypeCompressed)
+		return writeCharCompressed(x, y, static_cast<uint8_t>(value), ltextcolor, ltextbgcolor);
+	if (_FontType != FontTypeFixed) // proportional and anti-aliased
+		return writeCharProportional(x, y, static_cast<uint8_t>(value), ltextcolor, ltextbgcolor);
 	// Locate font bitmap
 	uint16_t fontIndex = ((value - _FontOffset) * ((_Font_X_Size * _Font_Y_Size) / 8)) + 4;
+#ifdef dislib16_ADVANCED_SCREEN_BUFFER_ENABLE
+	if (isBufferActive()) // Expand into screen buffer, clipped at right and bottom edges
+	{
+		markBufferDirty(x, y, _Font_X_Size, _Font_Y_Size);
+		const uint8_t fgHi = ltextcolor >> 8, fgLo = ltextcolor & 0xFF;
+		const uint8_t bgHi = ltextbgcolor >> 8, bgLo = ltextbgcolor & 0xFF;
+		const uint16_t rowBytes = _Font_X_Size / 8;
+		uint16_t cols = _Font_X_Size;
+		if ((x + cols) > _width)
+			cols = _width - x;
+#ifdef dislib16_GLYPH_CACHE_ENABLE
+		_glyphCacheTick++;
+		const uint8_t slot = glyphCacheFind(static_cast<uint8_t>(value), ltextcolor, ltextbgcolor);
+		if (slot != _glyphCacheNone)
+		{
+			const uint8_t *cached = &_glyphCacheData[slot * _glyphCacheSlotBytes];
+			for (uint16_t cy = 0; cy < _Font_Y_Size && (y + cy) < _height; cy++)
+				memcpy(&_screenBuffer[(static_cast<size_t>(y + cy) * _width + x) * 2], 
+					cached + (cy * _Font_X_Size * 2), cols * 2);
+			return DisLib16::Success;
+		}
+#endif
+		for (uint16_t cy = 0; cy < _Font_Y_Size && (y + cy) < _height; cy++)
+		{
+			uint8_t *dst = &_screenBuffer[(static_cast<size_t>(y + cy) * _width + x) * 2];
+			const uint8_t *src = &_FontSelect[fontIndex + (cy * rowBytes)];
+			uint8_t bits = 0;
+			for (uint16_t cx = 0; cx < cols; cx++)
+			{
+				if ((cx & 7) == 0)
+					bits = pgm_read_byte(src++);
+				const bool on = bits & 0x80;
+				bits <<= 1;
+				*dst++ = on ? fgHi : bgHi;
+				*dst++ = on ? fgLo : bgLo;
+			}
+		}
+		return DisLib16::Success;
+	}
+#endif
 	if (_textCharPixelOrBuffer) // Pixel-by-pixel drawing mode 
 	{
+		beginPixelBatch();
 		for (int16_t cy = 0; cy < _Font_Y_Size; cy++)
 		{ // Process row first
 			for (int16_t cx = 0; cx < _Font_X_Size; cx++)
@@ -612,123 +1807,637 @@ DisLib16::Ret_Codes_e display16_graphics_LTSM::writeChar(uint16_t x, uint16_t y,
 				}
 			}
 		}
+		endPixelBatch();
 	}
-	else // Buffered mode
+	else // Buffered mode, built in the scratch arena and sent in chunks
 	{
-		uint8_t buffer[_Font_X_Size * _Font_Y_Size * 2]; // local buffer to hold char.
-		int16_t colByte = pgm_read_byte(&_FontSelect[fontIndex]);
-		int16_t colbit = 7;
+#if defined(ESP8266)
+		// ESP8266 needs a periodic yield() call to avoid watchdog reset.
+		yield();
+#endif
+#ifdef dislib16_GLYPH_CACHE_ENABLE
+		_glyphCacheTick++;
+		const uint8_t slot = glyphCacheFind(static_cast<uint8_t>(value), ltextcolor, ltextbgcolor);
+		if (slot != _glyphCacheNone) // ready to send, one block write
+		{
+			setAddrWindow(x, y, x + _Font_X_Size - 1, y + _Font_Y_Size - 1);
+			spiWriteDataBuffer(&_glyphCacheData[slot * _glyphCacheSlotBytes], _glyphCacheSlotBytes);
+			return DisLib16::Success;
+		}
+#endif
+		const uint8_t fgHi = ltextcolor >> 8, fgLo = ltextcolor & 0xFF;
+		const uint8_t bgHi = ltextbgcolor >> 8, bgLo = ltextbgcolor & 0xFF;
+		const uint32_t glyphPixels = static_cast<uint32_t>(_Font_X_Size) * _Font_Y_Size;
+		uint32_t chunkBytes = 0;
+		uint8_t *buffer = scratchAcquire(glyphPixels * 2, chunkBytes);
 		uint32_t bufferIndex = 0;
-		for (int16_t cx = 0; cx < _Font_X_Size; cx++)
+		uint8_t colByte = 0;
+		setAddrWindow(x, y, x + _Font_X_Size - 1, y + _Font_Y_Size - 1);
+		spiStartTransaction();
+		DISPLAY16_DC_SetHigh;
+		// glyph bits are row major, MSB first, same order as the window
+		for (uint32_t bit = 0; bit < glyphPixels; bit++)
+		{
+			if ((bit & 7) == 0)
+				colByte = pgm_read_byte(&_FontSelect[fontIndex++]);
+			const bool on = colByte & 0x80;
+			colByte <<= 1;
+			buffer[bufferIndex++] = on ? fgHi : bgHi;
+			buffer[bufferIndex++] = on ? fgLo : bgLo;
+			if (bufferIndex == chunkBytes)
+			{
+				spiWriteScratchBytes(buffer, bufferIndex);
+				bufferIndex = 0;
+			}
+		}
+		if (bufferIndex > 0)
+			spiWriteScratchBytes(buffer, bufferIndex);
+		spiEndTransaction();
+	}
+	return DisLib16::Success;
+}
+
+
+/*!
+	@brief Write Text character array on display
+	@param  x character starting position on x-axis.
+	@param  y character starting position on y-axis.
+	@param  pText Pointer to the array of the text to be written.
+	@return Will return
+		-# DisLib16::Success Success
+		-# DisLib16::CharArrayNullptr String pText Array invalid pointer object
+		-# Failure code from  writeChar method upstream
+ */
+DisLib16::Ret_Codes_e display16_graphics_LTSM::writeCharString(uint16_t x, uint16_t y, char *pText)
+{
+	uint8_t MaxLength = 0;
+	int32_t cursor = x;
+	// Check for null pointer
+	if (pText == nullptr)
+	{
+		#ifdef dislib16_DEBUG_MODE_ENABLE
+			Serial.println("Error: writeCharString16 1 :String array is not valid pointer");
+		#endif
+		return DisLib16::CharArrayNullptr;
+	}
+	DisLib16::Ret_Codes_e DrawCharReturnCode;
+	if (charRunEnabled()) // each text line in one address window
+	{
+		const uint8_t *text = reinterpret_cast<const uint8_t *>(pText);
+		uint16_t length = 0;
+		while (text[length] != '\0' && length < 250)
+			length++; // 250 safety check as below
+		uint16_t i = 0;
+		while (i < length)
+		{
+			// check if text has reached end of screen
+			if ((cursor + getCharAdvance(text[i])) > _width)
+			{
+				y = y + _Font_Y_Size;
+				cursor = 0;
+			}
+			uint32_t advance = 0;
+			const uint16_t valid = charRunLength(text + i, length - i, cursor, true, advance);
+			if (valid == 0 || y >= _height)
+				return writeChar(cursor, y, text[i]); // reports the error
+			writeCharRun(cursor, y, text + i, valid, advance);
+			i += valid;
+			cursor += advance;
+		}
+		return DisLib16::Success;
+	}
+	while (*pText != '\0')
+	{
+		const uint16_t advance = textAdvance(*pText);
+		// check if text has reached end of screen
+		if ((cursor + advance) > _width)
+		{
+			y = y + textLineHeight();
+			cursor = 0;
+		}
+		DrawCharReturnCode = writeChar(cursor, y, *pText++);
+		if (DrawCharReturnCode != DisLib16::Success)
+			return DrawCharReturnCode;
+		cursor += advance;
+		MaxLength++;
+		if (MaxLength >= 250)
+			break; // 2nd way out of loop, safety check
+	}
+	return DisLib16::Success;
+}
+
+/*!
+	@brief write method used in the print class when user calls print
+	@param character the character to print, or a byte of a UTF-8 sequence
+	@return Will return
+		-# 1. success
+		-# DisLib16::Ret_Codes_e enum error code,  An error in the writeChar method upstream
+	@details With UTF-8 on, see setTextUTF8, the bytes of a multi byte sequence are held until 
+		the codepoint is complete, then it is looked up in the font with getCodepointChar. 
+		A codepoint the font has no glyph for sets the write error DisLib16::CharFontASCIIRange.
+*/
+size_t display16_graphics_LTSM::write(uint8_t character)
+{
+	if (!_textUTF8)
+		return writeCursorChar(character);
+	uint32_t codepoint = 0;
+	if (!textUTF8Decode(character, codepoint))
+		return 1;
+	uint8_t fontChar = 0;
+	if (!getCodepointChar(codepoint, fontChar))
+	{
+		setWriteError(DisLib16::CharFontASCIIRange);
+		return 1;
+	}
+	return writeCursorChar(fontChar);
+}
+
+/*!
+	@brief Decodes UTF-8 one byte at a time
+	@param value next byte of the text
+	@param codepoint set to the decoded codepoint when one is complete
+	@return true if a codepoint is complete, false while a sequence is pending or was dropped
+	@details A sequence broken by a byte that is not a continuation is dropped and sets the 
+		write error, the byte is then decoded on its own. Overlong forms, surrogates and codepoints 
+		past 0x10FFFF are dropped the same way. A continuation byte with no sequence, or a byte 
+		that cannot start one, is taken as a Latin-1 character, so single byte 8 bit text still prints.
+*/
+bool display16_graphics_LTSM::textUTF8Decode(uint8_t value, uint32_t &codepoint)
+{
+	if (_utf8Remaining > 0)
+	{
+		if ((value & 0xC0) == 0x80)
 		{
-			for (int16_t cy = 0; cy < _Font_Y_Size; cy++)
+			_utf8Codepoint = (_utf8Codepoint << 6) | (value & 0x3F);
+			if (--_utf8Remaining > 0)
+				return false;
+			static const uint32_t minimum[4] = {0x00, 0x80, 0x800, 0x10000};
+			if (_utf8Codepoint < minimum[_utf8Length] || _utf8Codepoint > 0x10FFFF ||
+				(_utf8Codepoint >= 0xD800 && _utf8Codepoint <= 0xDFFF))
 			{
-				if ((colByte & (1 << colbit)) != 0)
+				setWriteError(DisLib16::CharFontASCIIRange);
+				return false;
+			}
+			codepoint = _utf8Codepoint;
+			return true;
+		}
+		_utf8Remaining = 0;
+		setWriteError(DisLib16::CharFontASCIIRange);
+	}
+	if (value >= 0xC2 && value <= 0xF4) // lead byte, 1 to 3 continuation bytes follow
+	{
+		_utf8Remaining = (value >= 0xF0) ? 3 : ((value >= 0xE0) ? 2 : 1);
+		_utf8Length = _utf8Remaining;
+		_utf8Codepoint = value & (0x3F >> _utf8Remaining);
+		return false;
+	}
+	codepoint = value;
+	return true;
+}
+
+/*!
+	@brief Draws one font character at the cursor and moves the cursor, wrapping as set
+	@param character font character, or '\n' and '\r'
+	@return 1, errors are set with setWriteError
+*/
+size_t display16_graphics_LTSM::writeCursorChar(uint8_t character)
+{
+	DisLib16::Ret_Codes_e DrawCharReturnCode = DisLib16::Success;
+	switch (character)
+	{
+	case '\n':
+		_cursorY += textLineHeight();
+		_cursorX = 0;
+		break;
+	case '\r':
+		break;
+	default:
+		// proportional fonts wrap before a character that does not fit, its width is known
+		if (_textwrap && _FontType != FontTypeFixed && _cursorX > 0 &&
+			(_cursorX + textAdvance(character)) > static_cast<int16_t>(_width))
+		{
+			_cursorY += textLineHeight();
+			_cursorX = 0;
+		}
+		DrawCharReturnCode = writeChar(_cursorX, _cursorY, character);
+		if (DrawCharReturnCode != DisLib16::Success)
+		{
+			// Set the write error based on the result of the drawing operation
+			setWriteError(DrawCharReturnCode); // Set error flag to non-zero value}
+			break;
+		}
+		_cursorX += textAdvance(character);
+		if (_textwrap && _FontType == FontTypeFixed && (static_cast<uint16_t>(_cursorX) > (_width - (_Font_X_Size * _textScale))))
+		{
+			_cursorY += textLineHeight();
+			_cursorX = 0;
+		}
+		break;
+	} // end of switch
+	return 1;
+}
+
+/*!
+	@brief write method used in the print class when user prints a string or buffer
+	@param buffer characters to print
+	@param size number of characters
+	@return size, errors are set with setWriteError as for single characters
+	@details Runs of characters on one text line are drawn through one address window,
+		with the same cursor, wrap and error behaviour as printing one character at a time.
+		Pixel text mode and screen buffer mode print one character at a time, as do the 
+		bytes of UTF-8 sequences.
+*/
+size_t display16_graphics_LTSM::write(const uint8_t *buffer, size_t size)
+{
+	if (buffer == nullptr)
+		return 0;
+	size_t i = 0;
+	if (!charRunEnabled())
+	{
+		for (; i < size; i++)
+			write(buffer[i]);
+		return size;
+	}
+	while (i < size)
+	{
+		const uint8_t character = buffer[i];
+		if (character == '\n' || character == '\r' || _cursorX < 0 || _cursorY < 0 ||
+			_cursorX >= static_cast<int16_t>(_width) || _cursorY >= static_cast<int16_t>(_height) ||
+			(_textUTF8 && (character >= 0x80 || _utf8Remaining > 0)))
+		{
+			write(character); // control character, UTF-8 or error, one at a time
+			i++;
+			continue;
+		}
+		if (_textwrap && _FontType != FontTypeFixed && _cursorX > 0 &&
+			(_cursorX + getCharAdvance(character)) > static_cast<int16_t>(_width))
+		{
+			write(character); // wraps then draws
+			i++;
+			continue;
+		}
+		// characters up to the wrap, or up to the right edge without wrap
+		size_t lineChars = size - i;
+		if (lineChars > 0xFFFF)
+			lineChars = 0xFFFF;
+		uint32_t advance = 0;
+		uint16_t valid = charRunLength(buffer + i, static_cast<uint16_t>(lineChars), _cursorX, _textwrap, advance);
+		if (_textUTF8) // the run ends before the next multi byte sequence
+		{
+			for (uint16_t k = 1; k < valid; k++)
+				if (buffer[i + k] >= 0x80)
 				{
-					buffer[bufferIndex++] = (ltextcolor >> 8) & 0xFF; // High byte
-					buffer[bufferIndex++] = ltextcolor & 0xFF;		  // Low byte
-				}else{
-					buffer[bufferIndex++] = (ltextbgcolor >> 8) & 0xFF; // High byte
-					buffer[bufferIndex++] = ltextbgcolor & 0xFF;		// Low byte
+					valid = k;
+					advance = 0;
+					for (uint16_t n = 0; n < valid; n++)
+						advance += getCharAdvance(buffer[i + n]);
+					break;
 				}
-				colbit--;
-				if (colbit < 0)
+		}
+		if (valid == 0)
+		{
+			write(character);
+			i++;
+			continue;
+		}
+		writeCharRun(_cursorX, _cursorY, buffer + i, valid, advance);
+		i += valid;
+		_cursorX += advance;
+		if (_textwrap && _FontType == FontTypeFixed && (static_cast<uint16_t>(_cursorX) > (_width - (_Font_X_Size))))
+		{
+			_cursorY += _Font_Y_Size;
+			_cursorX = 0;
+		}
+	}
+	return size;
+}
+
+
+/*!
+	@brief Measures text in the current font and text scale, without drawing it
+	@param text characters, '\n' starts a new line
+	@param w set to the width of the widest line, in pixels
+	@param h set to the number of lines times the line height, 0 for an empty string
+	@return DisLib16::Success, or DisLib16::CharArrayNullptr for a nullptr text
+	@details Uses the advances writeChar would use, characters out of the font range count 0.
+		No wrapping, no length limit. The size is what drawTextBox needs to show the text in full.
+*/
+DisLib16::Ret_Codes_e display16_graphics_LTSM::getTextBounds(const char *text, uint16_t &w, uint16_t &h) const
+{
+	w = 0;
+	h = 0;
+	if (text == nullptr)
+	{
+		#ifdef dislib16_DEBUG_MODE_ENABLE
+			Serial.println("Error: getTextBounds: String array is not valid pointer");
+		#endif
+		return DisLib16::CharArrayNullptr;
+	}
+	if (*text == '\0')
+		return DisLib16::Success;
+	uint32_t lineWidth = 0;
+	uint32_t widest = 0;
+	uint32_t lines = 1;
+	for (; *text != '\0'; text++)
+	{
+		const uint8_t character = static_cast<uint8_t>(*text);
+		if (character == '\n')
+		{
+			lines++;
+			lineWidth = 0;
+			continue;
+		}
+		if (character < _FontOffset || character >= (_FontOffset + _FontNumChars + 1))
+			continue;
+		lineWidth += textAdvance(character);
+		if (lineWidth > widest)
+			widest = lineWidth;
+	}
+	const uint32_t height = lines * textLineHeight();
+	w = (widest > 0xFFFF) ? 0xFFFF : static_cast<uint16_t>(widest);
+	h = (height > 0xFFFF) ? 0xFFFF : static_cast<uint16_t>(height);
+	return DisLib16::Success;
+}
+
+/*!
+	@brief Draws text inside a box, each line aligned, clipped to the box instead of wrapped.
+	@param x box left column
+	@param y box top row
+	@param w box width
+	@param h box height
+	@param text characters, '\n' starts a new line
+	@param align left, centre or right alignment of each line in the box
+	@param drawnChars optional, set to the number of characters drawn
+	@return 
+		-# DisLib16::Success all the text fitted
+		-# DisLib16::TextTruncated characters past the box right edge, lines past its bottom edge
+			or characters out of the font range were left out
+		-# DisLib16::CharArrayNullptr nullptr text
+		-# DisLib16::CharScreenBounds box starts off screen, or is empty
+	@details Lines are drawn from the box top. A character is drawn whole or not at all, 
+		a line is drawn only if its full height fits. Every pixel of the box not covered by 
+		text is filled with the text background colour, so a label can be redrawn in place, 
+		e.g. a centred value that gets shorter, without clearing the box first and without 
+		drawing outside it. In transparent text mode only the text is drawn, the box is not filled.
+		The box is clipped at the screen edges.
+*/
+DisLib16::Ret_Codes_e display16_graphics_LTSM::drawTextBox(uint16_t x, uint16_t y, uint16_t w, uint16_t h, 
+	const char *text, text_align_e align, uint16_t *drawnChars)
+{
+	if (drawnChars != nullptr)
+		*drawnChars = 0;
+	if (text == nullptr)
+	{
+		#ifdef dislib16_DEBUG_MODE_ENABLE
+			Serial.println("Error: drawTextBox: String array is not valid pointer");
+		#endif
+		return DisLib16::CharArrayNullptr;
+	}
+	if (x >= _width || y >= _height || w == 0 || h == 0)
+	{
+		#ifdef dislib16_DEBUG_MODE_ENABLE
+			Serial.println("Error: drawTextBox: Box out of screen bounds");
+		#endif
+		return DisLib16::CharScreenBounds;
+	}
+	if ((x + w) > _width)
+		w = _width - x;
+	if ((y + h) > _height)
+		h = _height - y;
+	const uint16_t fillColor = getInvertFont() ? _textcolor : _textbgcolor;
+	const uint16_t lineHeight = textLineHeight();
+	bool truncated = false;
+	uint16_t drawn = 0;
+	uint16_t lineTop = y;
+	const uint8_t *line = reinterpret_cast<const uint8_t *>(text);
+	for (;;)
+	{
+		const uint8_t *lineEnd = line;
+		while (*lineEnd != '\0' && *lineEnd != '\n')
+			lineEnd++;
+		if (static_cast<uint32_t>(lineTop - y) + lineHeight > h)
+		{
+			for (const uint8_t *c = line; *c != '\0' && !truncated; c++)
+				truncated = (*c != '\n'); // text left below the box
+			break;
+		}
+		// characters that fit the box width, up to the first one that does not
+		uint16_t count = 0;
+		uint32_t lineWidth = 0;
+		for (const uint8_t *c = line; c < lineEnd; c++)
+		{
+			const bool inFont = (*c >= _FontOffset && *c < (_FontOffset + _FontNumChars + 1));
+			if (!inFont || lineWidth + textAdvance(*c) > w)
+			{
+				truncated = true;
+				break;
+			}
+			lineWidth += textAdvance(*c);
+			count++;
+		}
+		uint16_t offset = 0;
+		if (align == TextAlignCentre)
+			offset = (w - lineWidth) / 2;
+		else if (align == TextAlignRight)
+			offset = w - lineWidth;
+		if (!_textTransparent)
+		{
+			fillRect(x, lineTop, offset, lineHeight, fillColor);
+			fillRect(x + offset + lineWidth, lineTop, w - offset - lineWidth, lineHeight, fillColor);
+		}
+		if (count > 0)
+		{
+			if (charRunEnabled())
+				writeCharRun(x + offset, lineTop, line, count, lineWidth);
+			else
+			{
+				uint16_t cursor = x + offset;
+				for (uint16_t i = 0; i < count; i++)
 				{
-					colbit = 7;
-					fontIndex++;
-					colByte = pgm_read_byte(&_FontSelect[fontIndex]);
+					writeChar(cursor, lineTop, static_cast<char>(line[i]));
+					cursor += textAdvance(line[i]);
 				}
 			}
 		}
-		// Set window and write buffer
-		setAddrWindow(x, y, x + _Font_X_Size - 1, y + _Font_Y_Size - 1);
-		spiWriteDataBuffer(buffer, bufferIndex);
+		drawn += count;
+		lineTop += lineHeight;
+		if (*lineEnd == '\0')
+			break;
+		line = lineEnd + 1;
 	}
-	return DisLib16::Success;
+	if (lineTop < y + h && !_textTransparent)
+		fillRect(x, lineTop, w, (y + h) - lineTop, fillColor);
+	if (drawnChars != nullptr)
+		*drawnChars = drawn;
+	return truncated ? DisLib16::TextTruncated : DisLib16::Success;
 }
 
-
 /*!
-	@brief Write Text character array on display
-	@param  x character starting position on x-axis.
-	@param  y character starting position on y-axis.
-	@param  pText Pointer to the array of the text to be written.
-	@return Will return
-		-# DisLib16::Success Success
-		-# DisLib16::CharArrayNullptr String pText Array invalid pointer object
-		-# Failure code from  writeChar method upstream
- */
-DisLib16::Ret_Codes_e display16_graphics_LTSM::writeCharString(uint16_t x, uint16_t y, char *pText)
+	@brief Binds a numeric field to a position, font and width, see drawNumericField
+	@param field the field, kept by the caller between updates
+	@param x left of the first cell
+	@param y top of the cells
+	@param font font of the field, e.g. FontSevenSeg, it must hold the digits, '-' and '.'
+	@param width number of cells, 1 to numeric_field_t::cellsMax
+	@param decimals digits after the decimal point for drawNumericField, less than width and at most 9
+	@param zeroPad true: "-007.5", pad with zeros after the sign. false: "  -7.5", blank cells before it
+	@return
+		-# DisLib16::Success
+		-# DisLib16::FontPtrNullptr font is nullptr
+		-# DisLib16::GenericError width or decimals out of range
+	@details The next draw paints every cell.
+*/
+DisLib16::Ret_Codes_e display16_graphics_LTSM::setNumericField(numeric_field_t &field, uint16_t x, uint16_t y,
+	const uint8_t *font, uint8_t width, uint8_t decimals, bool zeroPad)
 {
-	uint8_t count = 0;
-	uint8_t MaxLength = 0;
-	// Check for null pointer
-	if (pText == nullptr)
+	if (font == nullptr)
 	{
 		#ifdef dislib16_DEBUG_MODE_ENABLE
-			Serial.println("Error: writeCharString16 1 :String array is not valid pointer");
+			Serial.println("Error: setNumericField: Font data is nullptr");
 		#endif
-		return DisLib16::CharArrayNullptr;
+		return DisLib16::FontPtrNullptr;
 	}
-	DisLib16::Ret_Codes_e DrawCharReturnCode;
-	while (*pText != '\0')
+	if (width == 0 || width > numeric_field_t::cellsMax || decimals >= width || decimals > 9)
 	{
-		// check if text has reached end of screen
-		if ((x + (count * _Font_X_Size)) > _width - _Font_X_Size)
-		{
-			y = y + _Font_Y_Size;
-			x = 0;
-			count = 0;
-		}
-		DrawCharReturnCode = writeChar(x + (count * (_Font_X_Size)), y, *pText++);
-		if (DrawCharReturnCode != DisLib16::Success)
-			return DrawCharReturnCode;
-		count++;
-		MaxLength++;
-		if (MaxLength >= 250)
-			break; // 2nd way out of loop, safety check
+		#ifdef dislib16_DEBUG_MODE_ENABLE
+			Serial.println("Error: setNumericField: width or decimals out of range");
+		#endif
+		return DisLib16::GenericError;
 	}
+	field.font = font;
+	field.x = x;
+	field.y = y;
+	field.width = width;
+	field.decimals = decimals;
+	field.zeroPad = zeroPad;
+	field.drawn = false;
 	return DisLib16::Success;
 }
 
 /*!
-	@brief write method used in the print class when user calls print
-	@param character the character to print
-	@return Will return
-		-# 1. success
-		-# DisLib16::Ret_Codes_e enum error code,  An error in the writeChar method upstream
+	@brief Draws a fixed point value in a numeric field, only the cells that changed are sent
+	@param field a field set by setNumericField
+	@param value the number times 10 to the power of the field decimals, 
+		e.g. 12345 with 1 decimal is drawn "1234.5", so no floating point formatting is needed
+	@return as drawNumericFieldText
 */
-size_t display16_graphics_LTSM::write(uint8_t character)
+DisLib16::Ret_Codes_e display16_graphics_LTSM::drawNumericField(numeric_field_t &field, int32_t value)
 {
-	DisLib16::Ret_Codes_e DrawCharReturnCode = DisLib16::Success;
-	switch (character)
+	char text[numeric_field_t::cellsMax + 2];
+	char reversed[numeric_field_t::cellsMax + 4];
+	uint8_t length = 0;
+	uint32_t magnitude = (value < 0) ? (0u - static_cast<uint32_t>(value)) : static_cast<uint32_t>(value);
+	do
 	{
-	case '\n':
-		_cursorY += _Font_Y_Size;
-		_cursorX = 0;
-		break;
-	case '\r':
-		break;
-	default:
-		DrawCharReturnCode = writeChar(_cursorX, _cursorY, character);
-		if (DrawCharReturnCode != DisLib16::Success)
-		{
-			// Set the write error based on the result of the drawing operation
-			setWriteError(DrawCharReturnCode); // Set error flag to non-zero value}
-			break;
-		}
-		_cursorX += (_Font_X_Size);
-		if (_textwrap && (static_cast<uint16_t>(_cursorX) > (_width - (_Font_X_Size))))
+		if (length == field.decimals && field.decimals > 0)
+			reversed[length++] = '.';
+		reversed[length++] = static_cast<char>('0' + (magnitude % 10));
+		magnitude /= 10;
+	} while (magnitude > 0 || length <= field.decimals + (field.decimals > 0 ? 1 : 0));
+	const uint8_t signCells = (value < 0) ? 1 : 0;
+	while (field.zeroPad && (length + signCells) < field.width)
+		reversed[length++] = '0';
+	if (signCells > 0)
+		reversed[length++] = '-';
+	if (length > field.width) // too long, one more '-' than cells is drawn as truncated
+	{
+		memset(text, '-', field.width + 1);
+		text[field.width + 1] = '\0';
+		return drawNumericFieldText(field, text);
+	}
+	for (uint8_t i = 0; i < length; i++)
+		text[i] = reversed[length - 1 - i];
+	text[length] = '\0';
+	return drawNumericFieldText(field, text);
+}
+
+/*!
+	@brief Draws text in a numeric field, only the cells that changed are sent
+	@param field a field set by setNumericField
+	@param text characters, right aligned in the field cells, e.g. "12:30" or "-4.5"
+	@return
+		-# DisLib16::Success
+		-# DisLib16::TextTruncated text longer than the field, every cell is drawn as '-'
+		-# DisLib16::CharFontASCIIRange a character is not in the font, its cell is blank
+		-# DisLib16::CharArrayNullptr text is nullptr
+		-# DisLib16::FontPtrNullptr the field is not set
+	@details Each cell is the widest advance of the font by the line height, times the text scale.
+		The field remembers the character of each cell, a cell is redrawn only when its character 
+		changes, so a value that counts up usually sends one or two glyphs, not the whole field. 
+		A change of text colours or text scale, or field.drawn set false, repaints every cell. 
+		Blank cells are filled with the text background colour. The field is always drawn opaque, 
+		in the current text colours, scale and font invert, and the active font is restored afterwards.
+		The glyph cache stays with the active font, set the field font with setFont first 
+		to draw the field glyphs through the cache.
+*/
+DisLib16::Ret_Codes_e display16_graphics_LTSM::drawNumericFieldText(numeric_field_t &field, const char *text)
+{
+	if (field.font == nullptr)
+		return DisLib16::FontPtrNullptr;
+	if (text == nullptr)
+	{
+		#ifdef dislib16_DEBUG_MODE_ENABLE
+			Serial.println("Error: drawNumericFieldText: String array is not valid pointer");
+		#endif
+		return DisLib16::CharArrayNullptr;
+	}
+	DisLib16::Ret_Codes_e result = DisLib16::Success;
+	char cells[numeric_field_t::cellsMax];
+	const size_t length = strlen(text);
+	for (uint8_t i = 0; i < field.width; i++)
+	{
+		if (length > field.width)
+			cells[i] = '-';
+		else
+			cells[i] = (i < field.width - length) ? ' ' : text[i - (field.width - length)];
+	}
+	if (length > field.width)
+		result = DisLib16::TextTruncated;
+	const uint8_t *previousFont = _FontSelect;
+	if (previousFont != field.font)
+	{
+		const DisLib16::Ret_Codes_e fontResult = swapFont(field.font);
+		if (fontResult != DisLib16::Success)
+			return fontResult;
+	}
+	const bool transparent = _textTransparent;
+	_textTransparent = false;
+	const uint16_t fg = getInvertFont() ? _textbgcolor : _textcolor;
+	const uint16_t bg = getInvertFont() ? _textcolor : _textbgcolor;
+	const bool repaint = !field.drawn || field.fg != fg || field.bg != bg || field.scale != _textScale;
+	const uint16_t cellWidth = _Font_X_Size * _textScale;
+	const uint16_t cellHeight = textLineHeight();
+	for (uint8_t i = 0; i < field.width; i++)
+	{
+		const uint8_t character = static_cast<uint8_t>(cells[i]);
+		if (!repaint && field.shown[i] == cells[i])
+			continue;
+		const uint16_t cellX = field.x + (i * cellWidth);
+		const bool inFont = (character >= _FontOffset && character < (_FontOffset + _FontNumChars + 1));
+		uint16_t drawnWidth = 0;
+		if (character != ' ' && inFont)
 		{
-			_cursorY += _Font_Y_Size;
-			_cursorX = 0;
+			const DisLib16::Ret_Codes_e charResult = writeChar(cellX, field.y, static_cast<char>(character));
+			if (charResult != DisLib16::Success)
+				result = charResult;
+			drawnWidth = textAdvance(character);
 		}
-		break;
-	} // end of switch
-	return 1;
+		else if (character != ' ')
+			result = DisLib16::CharFontASCIIRange;
+		if (drawnWidth < cellWidth) // blank cell, or the rest of a narrow proportional glyph
+			fillRect(cellX + drawnWidth, field.y, cellWidth - drawnWidth, cellHeight, bg);
+		field.shown[i] = cells[i];
+	}
+	field.fg = fg;
+	field.bg = bg;
+	field.scale = _textScale;
+	field.drawn = true;
+	_textTransparent = transparent;
+	if (previousFont != field.font)
+		swapFont(previousFont);
+	return result;
 }
 
-
 /*!
 	@brief: Draws an bi-color bitmap to screen
 	@param x X coordinate
@@ -745,7 +2454,7 @@ size_t display16_graphics_LTSM::write(uint8_t character)
 		-# Display_BitmapHorizontalSize=bitmap wrong size
 	@note A horizontal Bitmap's w must be divisible by 8. For a bitmap with w=88 & h=48.
 		  Bitmap excepted size = (88/8) * 48 = 528 bytes.
-		  	If dislib16_ADVANCED_SCREEN_BUFFER_ENABLE is defined then the function 
+		  	If dislib16_ADVANCED_SCREEN_BUFFER_ENABLE is defined and a buffer is set then the function 
 			will write to screen Buffer instead of VRAM.
 */
 DisLib16::Ret_Codes_e display16_graphics_LTSM::drawBitmap(int16_t x,int16_t y,int16_t w,int16_t h,uint16_t color,uint16_t bgcolor,
@@ -767,255 +2476,860 @@ DisLib16::Ret_Codes_e display16_graphics_LTSM::drawBitmap(int16_t x,int16_t y,in
 		#endif
 		return DisLib16::BitmapHorizontalSize;
 	}
-	// Check bounds
-	if ((static_cast<uint16_t>(x) >= _width) || (static_cast<uint16_t>(y) >= _height)) {
+	// Check bounds
+	if ((static_cast<uint16_t>(x) >= _width) || (static_cast<uint16_t>(y) >= _height)) {
+		#ifdef dislib16_DEBUG_MODE_ENABLE
+			Serial.println("Error: drawBitmap: Out of screen bounds, check x & y");
+		#endif
+		return DisLib16::BitmapScreenBounds;
+	}
+	// Clip width/height if needed
+	if (static_cast<uint16_t>(x + w - 1) >= _width)
+		w = _width - x;
+	if (static_cast<uint16_t>(y + h - 1) >= _height)
+		h = _height - y;
+
+#ifdef dislib16_ADVANCED_SCREEN_BUFFER_ENABLE
+	if (isBufferActive()) {
+		markBufferDirty(x, y, w, h);
+		for (int16_t j = 0; j < h; j++, y++) {
+			for (int16_t i = 0; i < w; i++) {
+				if (i & 7)
+					byte <<= 1;
+				else
+					byte = pgm_read_byte(bitmap + (j * byteWidth + i / 8));
+				drawPixel(x + i, y, (byte & 0x80) ? color : bgcolor);
+			}
+		}
+		return DisLib16::Success;
+	}
+#endif
+	uint16_t mycolor = 0;
+	// Rows are built in the scratch arena and sent through one window
+	uint32_t chunkBytes = 0;
+	uint8_t *buffer = scratchAcquire(static_cast<uint32_t>(w) * 2, chunkBytes);
+	uint32_t bufferIndex = 0;
+	setAddrWindow(x, y, x + w - 1, y + h - 1);
+	spiStartTransaction();
+	DISPLAY16_DC_SetHigh;
+	for (int16_t j = 0; j < h; j++) {
+		for (int16_t i = 0; i < w; i++) {
+			if (i & 7)
+				byte <<= 1;
+			else
+				byte = pgm_read_byte(bitmap + (j * byteWidth + i / 8));
+			mycolor = (byte & 0x80) ? color : bgcolor;
+			buffer[bufferIndex++] = mycolor >> 8;
+			buffer[bufferIndex++] = mycolor & 0xFF;
+			if (bufferIndex == chunkBytes) {
+				spiWriteScratchBytes(buffer, bufferIndex);
+				bufferIndex = 0;
+			}
+		}
+	}
+	if (bufferIndex > 0)
+		spiWriteScratchBytes(buffer, bufferIndex);
+	spiEndTransaction();
+	return DisLib16::Success;
+}
+
+
+/*!
+	@brief Draws an 8-bit color bitmap (RRRGGGBB format) to the screen.
+		This function reads an 8-bit bitmap stored in RRRGGGBB format, converts each
+		pixel to 16-bit RGB565 with a 256 entry table, and writes it to the display.
+		setBitmap8Palette replaces the table with a user palette of any 256 colours.
+	@param x X coordinate of the top-left corner of the bitmap.
+	@param y Y coordinate of the top-left corner of the bitmap.
+	@param bitmap span to the 8-bit bitmap data array.
+	@param w Width of the bitmap in pixels.
+	@param h Height of the bitmap in pixels.
+	@return Display status code:
+			-# DisLib16::Success on success.
+			-# DisLib16::BitmapDataEmpty if bitmap is empty.
+			-# DisLib16::BitmapScreenBounds if the coordinates are out of screen bounds.
+	@note 	If dislib16_ADVANCED_SCREEN_BUFFER_ENABLE is defined then the function 
+			will write to screen Buffer instead of VRAM.
+*/
+DisLib16::Ret_Codes_e display16_graphics_LTSM::drawBitmap8Data(uint16_t x, uint16_t y, const uint8_t* bitmap, uint16_t w, uint16_t h)
+{
+	if (bitmap == nullptr) // 1. Check for empty bitmap
+	{
+		#ifdef dislib16_DEBUG_MODE_ENABLE
+			Serial.println("Error drawBitmap8 1: Bitmap array is empty");
+		#endif
+		return DisLib16::BitmapDataEmpty;
+	}
+	if ((x >= _width) || (y >= _height)) // 2. Check bounds
+	{
+		#ifdef dislib16_DEBUG_MODE_ENABLE
+			Serial.println("Error drawBitmap8 2: Out of screen bounds");
+		#endif
+		return DisLib16::BitmapScreenBounds;
+	}
+
+	const uint16_t stride = w; // source row length, before clipping
+	if ((x + w - 1) >= _width)
+		w = _width - x;
+	if ((y + h - 1) >= _height)
+		h = _height - y;
+
+#ifdef dislib16_ADVANCED_SCREEN_BUFFER_ENABLE
+	if (isBufferActive())
+	{
+		markBufferDirty(x, y, w, h);
+		uint16_t color = 0;
+
+		for (uint16_t j = 0; j < h; j++)
+		{
+			const uint8_t* bitmapIter = bitmap + (static_cast<uint32_t>(j) * stride);
+			for (uint16_t i = 0; i < w; i++)
+			{
+				uint8_t pixelVal = pgm_read_byte(bitmapIter);
+				color = pgm_read_word(&_bitmap8Palette[pixelVal]);
+				drawPixel(x + i, y + j, color);
+				++bitmapIter;
+			}
+		}
+		return DisLib16::Success;
+	}
+#endif
+	// Rows are converted in the scratch arena and sent through one window
+	uint16_t color = 0;
+	uint32_t chunkBytes = 0;
+	uint8_t *buffer = scratchAcquire(static_cast<uint32_t>(w) * 2, chunkBytes);
+	uint32_t bufferIndex = 0;
+	setAddrWindow(x, y, x + w - 1, y + h - 1);
+	spiStartTransaction();
+	DISPLAY16_DC_SetHigh;
+	for (uint16_t j = 0; j < h; j++)
+	{
+		const uint8_t* bitmapIter = bitmap + (static_cast<uint32_t>(j) * stride);
+		// Convert 8-bit colors to 16-bit RGB565
+		for (uint16_t i = 0; i < w; i++)
+		{
+			uint8_t pixelVal = pgm_read_byte(bitmapIter);
+			color = pgm_read_word(&_bitmap8Palette[pixelVal]);
+			buffer[bufferIndex++] = color >> 8;
+			buffer[bufferIndex++] = color & 0xFF;
+			++bitmapIter;
+			if (bufferIndex == chunkBytes)
+			{
+				spiWriteScratchBytes(buffer, bufferIndex);
+				bufferIndex = 0;
+			}
+		}
+	}
+	if (bufferIndex > 0)
+		spiWriteScratchBytes(buffer, bufferIndex);
+	spiEndTransaction();
+	return DisLib16::Success;
+}
+
+
+/*!
+	@brief: Draws a 16-bit color bitmap to the screen from a data array
+	@param x X coordinate
+	@param y Y coordinate
+	@param bitmap span to data array
+	@param w width of the bitmap in pixels
+	@param h height of the bitmap in pixels
+	@return Display status code:
+			-# DisLib16::Success on success.
+			-# DisLib16::BitmapDataEmpty if bitmap is empty.
+			-# DisLib16::BitmapScreenBounds if the coordinates are out of screen bounds.
+	@note 	If dislib16_ADVANCED_SCREEN_BUFFER_ENABLE is defined then the function 
+			will write to screen Buffer instead of VRAM, one block copy per row.
+*/
+DisLib16::Ret_Codes_e display16_graphics_LTSM::drawBitmap16Data(
+	uint16_t x, uint16_t y,
+	const uint8_t *bitmap,
+	uint16_t w, uint16_t h
+) {
+	if (bitmap == nullptr) {
+		#ifdef dislib16_DEBUG_MODE_ENABLE
+			Serial.println("Error drawBitmap16 1: Bitmap array is null");
+		#endif
+		return DisLib16::BitmapDataEmpty;
+	}
+
+	if ((x >= _width) || (y >= _height)) {
+		#ifdef dislib16_DEBUG_MODE_ENABLE
+			Serial.println("Error drawBitmap16 2: Out of screen bounds");
+		#endif
+		return DisLib16::BitmapScreenBounds;
+	}
+
+	const uint16_t stride = w; // source row length, before clipping
+	if ((x + w - 1) >= _width)
+		w = _width - x;
+	if ((y + h - 1) >= _height)
+		h = _height - y;
+
+#ifdef dislib16_ADVANCED_SCREEN_BUFFER_ENABLE
+	if (isBufferActive()) {
+		markBufferDirty(x, y, w, h);
+		// The bitmap rows and the buffer are both RGB565 high byte first, rows are copied whole
+		for (uint16_t j = 0; j < h; j++) {
+			const uint8_t* bitmapIter = bitmap + (static_cast<uint32_t>(j) * stride * 2);
+			uint8_t *dst = &_screenBuffer[(static_cast<size_t>(y + j) * _width + x) * 2];
+			memcpy_P(dst, bitmapIter, static_cast<size_t>(w) * 2);
+		}
+		return DisLib16::Success;
+	}
+#endif
+	// Rows are copied to the scratch arena and sent through one window
+	uint32_t chunkBytes = 0;
+	uint8_t *buffer = scratchAcquire(static_cast<uint32_t>(w) * 2, chunkBytes);
+	uint32_t bufferIndex = 0;
+	setAddrWindow(x, y, x + w - 1, y + h - 1);
+	spiStartTransaction();
+	DISPLAY16_DC_SetHigh;
+	for (uint16_t j = 0; j < h; j++) {
+		const uint8_t *bitmapIter = bitmap + (static_cast<uint32_t>(j) * stride * 2);
+		for (uint32_t b = 0; b < static_cast<uint32_t>(w) * 2; b++) {
+			buffer[bufferIndex++] = pgm_read_byte(bitmapIter++);
+			if (bufferIndex == chunkBytes) {
+				spiWriteScratchBytes(buffer, bufferIndex);
+				bufferIndex = 0;
+			}
+		}
+	}
+	if (bufferIndex > 0)
+		spiWriteScratchBytes(buffer, bufferIndex);
+	spiEndTransaction();
+	return DisLib16::Success;
+}
+
+
+/*!
+	@brief Draws an indexed colour bitmap, palette indices of 1, 2, 4 or 8 bits per pixel
+	@param x X coordinate of the top-left corner of the bitmap.
+	@param y Y coordinate of the top-left corner of the bitmap.
+	@param bitmap indexed bitmap data, header, palette then pixels, see details
+	@return Display status code:
+			-# DisLib16::Success on success.
+			-# DisLib16::BitmapDataEmpty if bitmap is empty.
+			-# DisLib16::BitmapFormat bits per pixel not 1, 2, 4 or 8, or a zero width or height.
+			-# DisLib16::BitmapScreenBounds if the coordinates are out of screen bounds.
+	@details Bytes: bits per pixel, width high, width low, height high, height low, colours - 1, 
+		then the palette, 2 bytes RGB565 per colour, high byte first, then rows of indices, 
+		MSB first, each row padded to a byte. An icon of up to 16 colours at 4 bits per pixel 
+		takes a quarter of the flash of drawBitmap16Data. Rows are expanded through the palette, 
+		held in RAM up to 16 colours, straight into the scratch arena and sent through one window, 
+		or into the screen buffer when one is set. The bitmap is clipped at the right and bottom edges.
+*/
+DisLib16::Ret_Codes_e display16_graphics_LTSM::drawBitmapIndexed(uint16_t x, uint16_t y, const uint8_t* bitmap)
+{
+	if (bitmap == nullptr)
+	{
+		#ifdef dislib16_DEBUG_MODE_ENABLE
+			Serial.println("Error drawBitmapIndexed 1: Bitmap array is empty");
+		#endif
+		return DisLib16::BitmapDataEmpty;
+	}
+	bitmap_indexed_t image;
+	image.bitsPerPixel = pgm_read_byte(&bitmap[0]);
+	uint16_t w = (pgm_read_byte(&bitmap[1]) << 8) | pgm_read_byte(&bitmap[2]);
+	uint16_t h = (pgm_read_byte(&bitmap[3]) << 8) | pgm_read_byte(&bitmap[4]);
+	image.lastIndex = pgm_read_byte(&bitmap[5]);
+	if ((image.bitsPerPixel != 1 && image.bitsPerPixel != 2 && image.bitsPerPixel != 4 && image.bitsPerPixel != 8) ||
+		w == 0 || h == 0)
+	{
+		#ifdef dislib16_DEBUG_MODE_ENABLE
+			Serial.println("Error drawBitmapIndexed 2: Not an indexed bitmap");
+		#endif
+		return DisLib16::BitmapFormat;
+	}
+	if ((x >= _width) || (y >= _height))
+	{
 		#ifdef dislib16_DEBUG_MODE_ENABLE
-			Serial.println("Error: drawBitmap: Out of screen bounds, check x & y");
+			Serial.println("Error drawBitmapIndexed 3: Out of screen bounds");
 		#endif
 		return DisLib16::BitmapScreenBounds;
 	}
-	// Clip width/height if needed
-	if (static_cast<uint16_t>(x + w - 1) >= _width)
+	image.palette = bitmap + _bitmapIndexedHeader;
+	image.pixels = image.palette + (static_cast<uint16_t>(image.lastIndex) + 1) * 2;
+	if (image.bitsPerPixel <= 4)
+	{
+		for (uint8_t i = 0; i < (1 << image.bitsPerPixel); i++)
+		{
+			const uint8_t entry = (i > image.lastIndex) ? image.lastIndex : i;
+			image.lut[i] = (pgm_read_byte(&image.palette[entry * 2]) << 8) | pgm_read_byte(&image.palette[entry * 2 + 1]);
+		}
+	}
+	const uint32_t stride = (static_cast<uint32_t>(w) * image.bitsPerPixel + 7) / 8; // source row bytes, before clipping
+	if ((x + w - 1) >= _width)
 		w = _width - x;
-	if (static_cast<uint16_t>(y + h - 1) >= _height)
+	if ((y + h - 1) >= _height)
 		h = _height - y;
 
-#ifndef dislib16_ADVANCED_SCREEN_BUFFER_ENABLE
-	uint16_t mycolor = 0;
-	// Buffer for one row of pixels (16-bit per pixel split into bytes)
-	uint8_t rowBuffer[w * 2];
-	// Draw row by row
-	for (int16_t j = 0; j < h; j++) {
-		for (int16_t i = 0; i < w; i++) {
-			if (i & 7)
-				byte <<= 1;
-			else
-				byte = pgm_read_byte(bitmap + (j * byteWidth + i / 8));
-			mycolor = (byte & 0x80) ? color : bgcolor;
-			rowBuffer[2 * i]     = mycolor >> 8;
-			rowBuffer[2 * i + 1] = mycolor & 0xFF;
-		}
-		setAddrWindow(x, y + j, x + w - 1, y + j);
-		spiWriteDataBuffer(rowBuffer, w * 2);
+#ifdef dislib16_ADVANCED_SCREEN_BUFFER_ENABLE
+	if (isBufferActive())
+	{
+		markBufferDirty(x, y, w, h);
+		for (uint16_t j = 0; j < h; j++)
+			bitmapIndexedRow(image, image.pixels + (j * stride), 0, w,
+				&_screenBuffer[(static_cast<size_t>(y + j) * _width + x) * 2]);
+		return DisLib16::Success;
 	}
-#else
-	for (int16_t j = 0; j < h; j++, y++) {
-		for (int16_t i = 0; i < w; i++) {
-			if (i & 7)
-				byte <<= 1;
-			else
-				byte = pgm_read_byte(bitmap + (j * byteWidth + i / 8));
-			drawPixel(x + i, y, (byte & 0x80) ? color : bgcolor);
+#endif
+	// Rows are expanded in the scratch arena, in pieces when a row is larger, and sent through one window
+	uint32_t chunkBytes = 0;
+	uint8_t *buffer = scratchAcquire(static_cast<uint32_t>(w) * 2, chunkBytes);
+	const uint16_t chunkPixels = chunkBytes / 2;
+	uint16_t used = 0;
+	setAddrWindow(x, y, x + w - 1, y + h - 1);
+	spiStartTransaction();
+	DISPLAY16_DC_SetHigh;
+	for (uint16_t j = 0; j < h; j++)
+	{
+		const uint8_t *row = image.pixels + (j * stride);
+		for (uint16_t col = 0; col < w; )
+		{
+			uint16_t cols = w - col;
+			if (cols > chunkPixels - used)
+				cols = chunkPixels - used;
+			bitmapIndexedRow(image, row, col, cols, buffer + (used * 2));
+			col += cols;
+			used += cols;
+			if (used == chunkPixels)
+			{
+				spiWriteScratchBytes(buffer, static_cast<uint32_t>(used) * 2);
+				used = 0;
+			}
 		}
 	}
-#endif
+	if (used > 0)
+		spiWriteScratchBytes(buffer, static_cast<uint32_t>(used) * 2);
+	spiEndTransaction();
 	return DisLib16::Success;
 }
 
+/*!
+	@brief Expands palette indices of one indexed bitmap row to RGB565, high byte first
+	@param image the bitmap, from its header
+	@param row first byte of the row
+	@param firstCol first column to expand
+	@param cols columns to expand
+	@param dst 2 * cols bytes
+*/
+void display16_graphics_LTSM::bitmapIndexedRow(const bitmap_indexed_t &image, const uint8_t *row, uint16_t firstCol,
+	uint16_t cols, uint8_t *dst) const
+{
+	const uint8_t bits = image.bitsPerPixel;
+	if (bits == 8)
+	{
+		row += firstCol;
+		for (uint16_t i = 0; i < cols; i++)
+		{
+			uint8_t index = pgm_read_byte(row++);
+			if (index > image.lastIndex)
+				index = image.lastIndex;
+			*dst++ = pgm_read_byte(&image.palette[index * 2]);
+			*dst++ = pgm_read_byte(&image.palette[index * 2 + 1]);
+		}
+		return;
+	}
+	const uint8_t mask = (1 << bits) - 1;
+	uint32_t bit = static_cast<uint32_t>(firstCol) * bits;
+	const uint8_t *src = row + (bit >> 3);
+	uint8_t value = pgm_read_byte(src++);
+	uint8_t shift = 8 - bits - (bit & 7);
+	for (uint16_t i = 0; i < cols; i++)
+	{
+		const uint16_t color = image.lut[(value >> shift) & mask];
+		*dst++ = color >> 8;
+		*dst++ = color & 0xFF;
+		if (shift == 0)
+		{
+			if (i + 1 < cols)
+				value = pgm_read_byte(src++);
+			shift = 8 - bits;
+		}
+		else
+			shift -= bits;
+	}
+}
 
 /*!
-	@brief Draws an 8-bit color bitmap (RRRGGGBB format) to the screen.
-		This function reads an 8-bit bitmap stored in RRRGGGBB format, converts each
-		pixel to 16-bit RGB565, and writes it to the display.
+	@brief Draws a compressed RGB565 bitmap, decoded as it is sent
 	@param x X coordinate of the top-left corner of the bitmap.
 	@param y Y coordinate of the top-left corner of the bitmap.
-	@param bitmap span to the 8-bit bitmap data array.
-	@param w Width of the bitmap in pixels.
-	@param h Height of the bitmap in pixels.
+	@param bitmap compressed bitmap data, header then stream, see details
 	@return Display status code:
 			-# DisLib16::Success on success.
 			-# DisLib16::BitmapDataEmpty if bitmap is empty.
+			-# DisLib16::BitmapFormat not a compressed bitmap, or a zero width or height.
 			-# DisLib16::BitmapScreenBounds if the coordinates are out of screen bounds.
-	@note 	If dislib16_ADVANCED_SCREEN_BUFFER_ENABLE is defined then the function 
-			will write to screen Buffer instead of VRAM.
+	@details Bytes: 0x51, width high, width low, height high, height low, then one stream of 
+		operations for all pixels, rows left to right, top to bottom, in the manner of QOI:
+		-# 0x00-0x3F index, a colour seen before, by hash (r * 3 + g * 5 + b * 7) % 64 of its 565 channels.
+		-# 0x40-0x7F 01rrggbb, channel differences -2 to 1 from the previous pixel.
+		-# 0x80-0xBF 10gggggg then rrrrbbbb, green difference -32 to 31, red and blue 
+			differences -8 to 7 from half the green difference.
+		-# 0xC0-0xFD run of 1 to 62 copies of the previous pixel.
+		-# 0xFE then the pixel, RGB565 high byte first.
+		-# 0xFF then n, run of 63 + n copies of the previous pixel.
+		The previous pixel starts as black, differences wrap within each channel. 
+		Host tool imageconv_LTSM writes the format. Pixels are decoded into the scratch arena 
+		and sent through one window, or into the screen buffer when one is set, the decoder holds 
+		132 bytes of state. The bitmap is clipped at the right and bottom edges, clipped columns are 
+		still decoded, as the stream has no row boundaries.
 */
-DisLib16::Ret_Codes_e display16_graphics_LTSM::drawBitmap8Data(uint16_t x, uint16_t y, const uint8_t* bitmap, uint16_t w, uint16_t h)
+DisLib16::Ret_Codes_e display16_graphics_LTSM::drawBitmapCompressed(uint16_t x, uint16_t y, const uint8_t* bitmap)
 {
-	if (bitmap == nullptr) // 1. Check for empty bitmap
+	if (bitmap == nullptr)
 	{
 		#ifdef dislib16_DEBUG_MODE_ENABLE
-			Serial.println("Error drawBitmap8 1: Bitmap array is empty");
+			Serial.println("Error drawBitmapCompressed 1: Bitmap array is empty");
 		#endif
 		return DisLib16::BitmapDataEmpty;
 	}
-	if ((x >= _width) || (y >= _height)) // 2. Check bounds
+	uint16_t w = (pgm_read_byte(&bitmap[1]) << 8) | pgm_read_byte(&bitmap[2]);
+	uint16_t h = (pgm_read_byte(&bitmap[3]) << 8) | pgm_read_byte(&bitmap[4]);
+	if (pgm_read_byte(&bitmap[0]) != _bitmapCompressedTag || w == 0 || h == 0)
 	{
 		#ifdef dislib16_DEBUG_MODE_ENABLE
-			Serial.println("Error drawBitmap8 2: Out of screen bounds");
+			Serial.println("Error drawBitmapCompressed 2: Not a compressed bitmap");
+		#endif
+		return DisLib16::BitmapFormat;
+	}
+	if ((x >= _width) || (y >= _height))
+	{
+		#ifdef dislib16_DEBUG_MODE_ENABLE
+			Serial.println("Error drawBitmapCompressed 3: Out of screen bounds");
 		#endif
 		return DisLib16::BitmapScreenBounds;
 	}
-
+	bitmap_stream_t stream;
+	stream.data = bitmap + _bitmapCompressedHeader;
+	stream.previous = 0x0000;
+	stream.run = 0;
+	memset(stream.seen, 0, sizeof(stream.seen));
+	const uint16_t stride = w; // source row length, before clipping
 	if ((x + w - 1) >= _width)
 		w = _width - x;
 	if ((y + h - 1) >= _height)
 		h = _height - y;
 
-#ifndef dislib16_ADVANCED_SCREEN_BUFFER_ENABLE
-	uint8_t rowBuffer[w * 2]; // Allocate space for 16-bit per pixel row buffer
-	uint16_t j = 0;
-	uint16_t color = 0;
-	const uint8_t* bitmapIter = bitmap;
-
-	// Process bitmap data row-by-row
-	for (j = 0; j < h; j++)
+#ifdef dislib16_ADVANCED_SCREEN_BUFFER_ENABLE
+	if (isBufferActive())
 	{
-		// Convert 8-bit colors to 16-bit RGB565
-		for (uint16_t i = 0; i < w; i++)
+		markBufferDirty(x, y, w, h);
+		for (uint16_t j = 0; j < h; j++)
 		{
-			uint8_t pixelVal = pgm_read_byte(bitmapIter);
-			color = convert8bitTo16bit(pixelVal);
-			rowBuffer[2 * i] = color >> 8;
-			rowBuffer[2 * i + 1] = color & 0xFF;
-			++bitmapIter;
+			uint8_t *dst = &_screenBuffer[(static_cast<size_t>(y + j) * _width + x) * 2];
+			for (uint16_t i = 0; i < w; i++)
+			{
+				const uint16_t color = bitmapStreamPixel(stream);
+				*dst++ = color >> 8;
+				*dst++ = color & 0xFF;
+			}
+			for (uint16_t i = w; i < stride; i++)
+				bitmapStreamPixel(stream);
 		}
-		setAddrWindow(x, y + j, x + w - 1, y + j);
-		spiWriteDataBuffer(rowBuffer, w * 2);
+		return DisLib16::Success;
 	}
-#else
-	uint16_t color = 0;
-	const uint8_t* bitmapIter = bitmap;
-
+#endif
+	// Pixels are decoded into the scratch arena and sent through one window
+	uint32_t chunkBytes = 0;
+	uint8_t *buffer = scratchAcquire(static_cast<uint32_t>(w) * 2, chunkBytes);
+	uint32_t bufferIndex = 0;
+	setAddrWindow(x, y, x + w - 1, y + h - 1);
+	spiStartTransaction();
+	DISPLAY16_DC_SetHigh;
 	for (uint16_t j = 0; j < h; j++)
 	{
 		for (uint16_t i = 0; i < w; i++)
 		{
-			uint8_t pixelVal = pgm_read_byte(bitmapIter);
-			color = convert8bitTo16bit(pixelVal);
-			drawPixel(x + i, y + j, color);
-			++bitmapIter;
+			const uint16_t color = bitmapStreamPixel(stream);
+			buffer[bufferIndex++] = color >> 8;
+			buffer[bufferIndex++] = color & 0xFF;
+			if (bufferIndex == chunkBytes)
+			{
+				spiWriteScratchBytes(buffer, bufferIndex);
+				bufferIndex = 0;
+			}
 		}
+		for (uint16_t i = w; i < stride; i++)
+			bitmapStreamPixel(stream);
 	}
-#endif
-
+	if (bufferIndex > 0)
+		spiWriteScratchBytes(buffer, bufferIndex);
+	spiEndTransaction();
 	return DisLib16::Success;
 }
 
+/*!
+	@brief Decodes the next pixel of a compressed bitmap
+	@param stream the decoder state
+	@return the pixel, RGB565
+*/
+uint16_t display16_graphics_LTSM::bitmapStreamPixel(bitmap_stream_t &stream) const
+{
+	if (stream.run > 0)
+	{
+		stream.run--;
+		return stream.previous;
+	}
+	const uint8_t op = pgm_read_byte(stream.data++);
+	uint16_t color;
+	if (op < 0x40)
+		color = stream.seen[op];
+	else if (op < 0xC0)
+	{
+		int16_t dr, dg, db;
+		if (op < 0x80)
+		{
+			dr = ((op >> 4) & 0x03) - 2;
+			dg = ((op >> 2) & 0x03) - 2;
+			db = (op & 0x03) - 2;
+		}
+		else
+		{
+			const uint8_t redBlue = pgm_read_byte(stream.data++);
+			dg = (op & 0x3F) - 32;
+			dr = (redBlue >> 4) - 8 + dg / 2;
+			db = (redBlue & 0x0F) - 8 + dg / 2;
+		}
+		const uint16_t p = stream.previous;
+		color = static_cast<uint16_t>(((((p >> 11) + dr) & 0x1F) << 11) |
+			(((((p >> 5) & 0x3F) + dg) & 0x3F) << 5) | (((p & 0x1F) + db) & 0x1F));
+	}
+	else if (op == 0xFE)
+	{
+		color = (pgm_read_byte(stream.data) << 8) | pgm_read_byte(stream.data + 1);
+		stream.data += 2;
+	}
+	else
+	{
+		// this pixel is the first of the run
+		stream.run = (op == 0xFF) ? 62 + pgm_read_byte(stream.data++) : op - 0xC0;
+		return stream.previous;
+	}
+	stream.seen[((color >> 11) * 3 + ((color >> 5) & 0x3F) * 5 + (color & 0x1F) * 7) & 0x3F] = color;
+	stream.previous = color;
+	return color;
+}
 
 /*!
-	@brief: Draws a 16-bit color bitmap to the screen from a data array
+	@brief: Draws an 16 bit color sprite bitmap to screen from a data array with transparent background
 	@param x X coordinate
 	@param y Y coordinate
-	@param bitmap span to data array
-	@param w width of the bitmap in pixels
-	@param h height of the bitmap in pixels
+	@param bitmap pointer to data array
+	@param w width of the sprite in pixels
+	@param h height of the sprite in pixels
+	@param backgroundColor the background color of sprite (16 bit 565) this will be made transparent
+	@param printBg  if true print the background color, if false sprite mode.
+	@note  Does not use malloc. In VRAM mode the opaque pixels are drawn as batched pixel runs, 
+		in screen buffer mode each row is copied, a select per pixel in sprite mode, see spriteRowSelect.
+		The sprite is clipped at the right and bottom edges.
 	@return Display status code:
 			-# DisLib16::Success on success.
 			-# DisLib16::BitmapDataEmpty if bitmap is empty.
 			-# DisLib16::BitmapScreenBounds if the coordinates are out of screen bounds.
-	@note 	If dislib16_ADVANCED_SCREEN_BUFFER_ENABLE is defined then the function 
-			will write to screen Buffer instead of VRAM.
 */
-DisLib16::Ret_Codes_e display16_graphics_LTSM::drawBitmap16Data(
-	uint16_t x, uint16_t y,
-	const uint8_t *bitmap,
-	uint16_t w, uint16_t h
-) {
+DisLib16::Ret_Codes_e display16_graphics_LTSM::drawSpriteData(uint16_t x,uint16_t y,const uint8_t* bitmap,uint16_t w,
+	uint16_t h,uint16_t backgroundColor,bool printBg) 
+{
+	// 1. Null check
 	if (bitmap == nullptr) {
 		#ifdef dislib16_DEBUG_MODE_ENABLE
-			Serial.println("Error drawBitmap16 1: Bitmap array is null");
+			Serial.println("Error drawSprite 1: Sprite array is nullptr");
 		#endif
 		return DisLib16::BitmapDataEmpty;
 	}
-
+	// 2. Screen bounds check
 	if ((x >= _width) || (y >= _height)) {
 		#ifdef dislib16_DEBUG_MODE_ENABLE
-			Serial.println("Error drawBitmap16 2: Out of screen bounds");
+			Serial.println("Error drawSprite 2: Sprite out of screen bounds");
 		#endif
 		return DisLib16::BitmapScreenBounds;
 	}
-
+	const uint16_t stride = w; // source row length, before clipping
 	if ((x + w - 1) >= _width)
 		w = _width - x;
 	if ((y + h - 1) >= _height)
 		h = _height - y;
-
-#ifndef dislib16_ADVANCED_SCREEN_BUFFER_ENABLE
-	const uint8_t *bitmapIter = bitmap;
-	for (uint16_t j = 0; j < h; j++) {
-		setAddrWindow(x, y + j, x + w - 1, y + j);
-		// Prepare a local buffer for one row
-		uint16_t rowBuffer[w];
-		for (uint16_t i = 0; i < w; i++) {
-			rowBuffer[i] = pgm_read_word(bitmapIter);
-			bitmapIter += 2;
+#ifdef dislib16_ADVANCED_SCREEN_BUFFER_ENABLE
+	if (isBufferActive())
+	{
+		markBufferDirty(x, y, w, h);
+		for (uint16_t j = 0; j < h; j++)
+		{
+			const uint8_t *row = bitmap + (static_cast<uint32_t>(j) * stride * 2);
+			uint8_t *dst = &_screenBuffer[(static_cast<size_t>(y + j) * _width + x) * 2];
+			if (printBg)
+				memcpy_P(dst, row, static_cast<size_t>(w) * 2);
+			else
+				spriteRowSelect(dst, row, w, backgroundColor);
 		}
-		spiWriteDataBuffer(reinterpret_cast<uint8_t *>(rowBuffer), w * sizeof(uint16_t));
+		return DisLib16::Success;
 	}
-#else
-	const uint8_t* bitmapIter = bitmap;
+#endif
 	uint16_t colour;
+	beginPixelBatch(); // opaque runs of each row share a window
 	for (uint16_t j = 0; j < h; j++) {
+		const uint8_t* bitmapIter = bitmap + (static_cast<uint32_t>(j) * stride * 2);
 		for (uint16_t i = 0; i < w; i++) {
 			// Read two bytes (MSB first) from the bitmap (PROGMEM-safe)
 			uint8_t hi = pgm_read_byte(bitmapIter);       // high byte
 			uint8_t lo = pgm_read_byte(bitmapIter + 1);   // low byte
 			colour = (static_cast<uint16_t>(hi) << 8) | static_cast<uint16_t>(lo);
 			bitmapIter += 2;
-			//TFTdrawPixel(x+i, y + h -1 -j, color);
-			//drawPixel(x + i - 1, y + j - 1, color);
-			drawPixel(x + i - 1, y + j - 1, colour);
+			if (printBg || colour != backgroundColor) {
+				drawPixel(x + i, y + j, colour);
+			}
+		}
+	}
+	endPixelBatch();
+	return DisLib16::Success;
+}
+
+#ifdef dislib16_ADVANCED_SCREEN_BUFFER_ENABLE
+/*!
+	@brief Copies the opaque pixels of one sprite row into the screen buffer
+	@param dst first pixel in the screen buffer
+	@param row first pixel of the sprite row, RGB565 high byte first
+	@param w pixels
+	@param backgroundColor transparent colour
+	@details Both sides are RGB565 high byte first, so pixels are compared as 16 bit words 
+		in memory order and each kept or replaced by a select, with no branch, 
+		a loop the compiler can vectorise on cores that read the sprite as normal memory. 
+		AVR and ESP8266 read the sprite from flash a byte at a time.
+*/
+void display16_graphics_LTSM::spriteRowSelect(uint8_t *dst, const uint8_t *row, uint16_t w, uint16_t backgroundColor)
+{
+#if defined(__AVR__) || defined(ESP8266)
+	for (uint16_t i = 0; i < w; i++)
+	{
+		const uint8_t hi = pgm_read_byte(&row[i * 2]);
+		const uint8_t lo = pgm_read_byte(&row[i * 2 + 1]);
+		if (((hi << 8) | lo) != backgroundColor)
+		{
+			dst[i * 2] = hi;
+			dst[i * 2 + 1] = lo;
 		}
 	}
+#else
+	const uint8_t keyBytes[2] = {static_cast<uint8_t>(backgroundColor >> 8), static_cast<uint8_t>(backgroundColor & 0xFF)};
+	uint16_t key;
+	memcpy(&key, keyBytes, 2);
+	for (uint16_t i = 0; i < w; i++)
+	{
+		uint16_t src, old;
+		memcpy(&src, row + i * 2, 2);
+		memcpy(&old, dst + i * 2, 2);
+		const uint16_t out = (src != key) ? src : old;
+		memcpy(dst + i * 2, &out, 2);
+	}
+#endif
+}
 #endif
 
+/*!
+	@brief Builds the run table of a 16 bit colour sprite, its opaque runs per row, for drawSpriteRuns
+	@param bitmap sprite data array, RGB565 high byte first, as drawSpriteData
+	@param w width of the sprite in pixels
+	@param h height of the sprite in pixels
+	@param backgroundColor the background color of sprite (16 bit 565), its pixels are transparent
+	@param runs user buffer for the table, nullptr to only get its size in used
+	@param size bytes in runs
+	@param used bytes of the table
+	@return Display status code:
+			-# DisLib16::Success on success.
+			-# DisLib16::BitmapDataEmpty if bitmap is empty.
+			-# DisLib16::BitmapSize if w or h is zero.
+			-# DisLib16::BufferSize if size is less than used, the table is not complete.
+	@details Bytes: 0x53, width high, width low, height high, height low, then for each row 
+		pairs of bytes: transparent pixels to skip, then opaque pixels, ending with 0, 0. 
+		Skips and runs longer than 255 are split. The table holds no pixels, drawSpriteRuns 
+		reads them from the sprite, so a 32x32 sprite with one run per row takes 165 bytes of RAM. 
+		Build it once and draw the sprite at any place.
+*/
+DisLib16::Ret_Codes_e display16_graphics_LTSM::buildSpriteRuns(const uint8_t* bitmap, uint16_t w, uint16_t h,
+	uint16_t backgroundColor, uint8_t *runs, uint32_t size, uint32_t &used)
+{
+	used = 0;
+	if (bitmap == nullptr)
+	{
+		#ifdef dislib16_DEBUG_MODE_ENABLE
+			Serial.println("Error buildSpriteRuns 1: Sprite array is nullptr");
+		#endif
+		return DisLib16::BitmapDataEmpty;
+	}
+	if (w == 0 || h == 0)
+	{
+		#ifdef dislib16_DEBUG_MODE_ENABLE
+			Serial.println("Error buildSpriteRuns 2: Sprite has no pixels");
+		#endif
+		return DisLib16::BitmapSize;
+	}
+	uint32_t count = 0;
+	spriteRunsPut(runs, size, count, _spriteRunsTag);
+	spriteRunsPut(runs, size, count, w >> 8);
+	spriteRunsPut(runs, size, count, w & 0xFF);
+	spriteRunsPut(runs, size, count, h >> 8);
+	spriteRunsPut(runs, size, count, h & 0xFF);
+	for (uint16_t j = 0; j < h; j++)
+	{
+		const uint8_t *row = bitmap + (static_cast<uint32_t>(j) * w * 2);
+		uint16_t i = 0, last = 0;
+		while (i < w)
+		{
+			while (i < w && ((pgm_read_byte(&row[i * 2]) << 8) | pgm_read_byte(&row[i * 2 + 1])) == backgroundColor)
+				i++;
+			if (i == w)
+				break;
+			const uint16_t start = i;
+			while (i < w && ((pgm_read_byte(&row[i * 2]) << 8) | pgm_read_byte(&row[i * 2 + 1])) != backgroundColor)
+				i++;
+			uint16_t skip = start - last, length = i - start;
+			for (; skip > 0xFF; skip -= 0xFF)
+			{
+				spriteRunsPut(runs, size, count, 0xFF);
+				spriteRunsPut(runs, size, count, 0);
+			}
+			for (; length > 0xFF; length -= 0xFF, skip = 0)
+			{
+				spriteRunsPut(runs, size, count, skip);
+				spriteRunsPut(runs, size, count, 0xFF);
+			}
+			spriteRunsPut(runs, size, count, skip);
+			spriteRunsPut(runs, size, count, length);
+			last = i;
+		}
+		spriteRunsPut(runs, size, count, 0);
+		spriteRunsPut(runs, size, count, 0);
+	}
+	used = count;
+	if (runs != nullptr && count > size)
+	{
+		#ifdef dislib16_DEBUG_MODE_ENABLE
+			Serial.println("Error buildSpriteRuns 3: Run table buffer too small");
+		#endif
+		return DisLib16::BufferSize;
+	}
 	return DisLib16::Success;
 }
 
+/*!
+	@brief Stores a byte of a sprite run table being built, if it fits
+	@param runs table buffer, nullptr when only counting
+	@param size bytes in runs
+	@param count bytes so far, advanced
+	@param value byte to store
+*/
+void display16_graphics_LTSM::spriteRunsPut(uint8_t *runs, uint32_t size, uint32_t &count, uint8_t value)
+{
+	if (runs != nullptr && count < size)
+		runs[count] = value;
+	count++;
+}
 
 /*!
-	@brief: Draws an 16 bit color sprite bitmap to screen from a data array with transparent background
+	@brief Draws a 16 bit colour sprite through its run table, only the opaque runs are sent
 	@param x X coordinate
 	@param y Y coordinate
-	@param bitmap pointer to data array
-	@param w width of the sprite in pixels
-	@param h height of the sprite in pixels
-	@param backgroundColor the background color of sprite (16 bit 565) this will be made transparent
-	@param printBg  if true print the background color, if false sprite mode.
-	@note  Does not use buffer or malloc, just draw pixel
+	@param bitmap sprite data array, RGB565 high byte first, as drawSpriteData
+	@param runs run table of the sprite, in RAM, from buildSpriteRuns
 	@return Display status code:
 			-# DisLib16::Success on success.
-			-# DisLib16::BitmapDataEmpty if bitmap is empty.
+			-# DisLib16::BitmapDataEmpty if bitmap or runs is empty.
+			-# DisLib16::BitmapFormat runs is not a sprite run table.
 			-# DisLib16::BitmapScreenBounds if the coordinates are out of screen bounds.
+	@details No pixel is compared with the background colour. Each opaque run is sent through 
+		its own window from the scratch arena, or copied into the screen buffer with one memcpy 
+		when one is set. The sprite is clipped at the right and bottom edges.
 */
-DisLib16::Ret_Codes_e display16_graphics_LTSM::drawSpriteData(uint16_t x,uint16_t y,const uint8_t* bitmap,uint16_t w,
-	uint16_t h,uint16_t backgroundColor,bool printBg) 
+DisLib16::Ret_Codes_e display16_graphics_LTSM::drawSpriteRuns(uint16_t x, uint16_t y, const uint8_t* bitmap,
+	const uint8_t *runs)
 {
-	// 1. Null check
-	if (bitmap == nullptr) {
+	if (bitmap == nullptr || runs == nullptr)
+	{
 		#ifdef dislib16_DEBUG_MODE_ENABLE
-			Serial.println("Error drawSprite 1: Sprite array is nullptr");
+			Serial.println("Error drawSpriteRuns 1: Sprite or run table is nullptr");
 		#endif
 		return DisLib16::BitmapDataEmpty;
 	}
-	// 2. Screen bounds check
-	if ((x >= _width) || (y >= _height)) {
+	if (runs[0] != _spriteRunsTag)
+	{
 		#ifdef dislib16_DEBUG_MODE_ENABLE
-			Serial.println("Error drawSprite 2: Sprite out of screen bounds");
+			Serial.println("Error drawSpriteRuns 2: Not a sprite run table");
+		#endif
+		return DisLib16::BitmapFormat;
+	}
+	if ((x >= _width) || (y >= _height))
+	{
+		#ifdef dislib16_DEBUG_MODE_ENABLE
+			Serial.println("Error drawSpriteRuns 3: Sprite out of screen bounds");
 		#endif
 		return DisLib16::BitmapScreenBounds;
 	}
+	const uint16_t stride = (runs[1] << 8) | runs[2]; // source row length, before clipping
+	uint16_t w = stride;
+	uint16_t h = (runs[3] << 8) | runs[4];
 	if ((x + w - 1) >= _width)
 		w = _width - x;
 	if ((y + h - 1) >= _height)
 		h = _height - y;
-	const uint8_t* bitmapIter = bitmap;
-	uint16_t colour;
-	for (uint16_t j = 0; j < h; j++) {
-		for (uint16_t i = 0; i < w; i++) {
-			// Read two bytes (MSB first) from the bitmap (PROGMEM-safe)
-			uint8_t hi = pgm_read_byte(bitmapIter);       // high byte
-			uint8_t lo = pgm_read_byte(bitmapIter + 1);   // low byte
-			colour = (static_cast<uint16_t>(hi) << 8) | static_cast<uint16_t>(lo);
-			bitmapIter += 2;
-			if (!printBg) {
-				if (colour != backgroundColor) {
-					drawPixel(x + i - 1, y + j - 1, colour);
+	const uint8_t *entry = runs + _spriteRunsHeader;
+
+#ifdef dislib16_ADVANCED_SCREEN_BUFFER_ENABLE
+	if (isBufferActive())
+	{
+		markBufferDirty(x, y, w, h);
+		for (uint16_t j = 0; j < h; j++)
+		{
+			const uint8_t *row = bitmap + (static_cast<uint32_t>(j) * stride * 2);
+			uint8_t *dst = &_screenBuffer[(static_cast<size_t>(y + j) * _width + x) * 2];
+			uint32_t col = 0;
+			for (; entry[0] != 0 || entry[1] != 0; entry += 2)
+			{
+				col += entry[0];
+				if (col < w && entry[1] > 0)
+				{
+					const uint16_t length = (col + entry[1] > w) ? (w - col) : entry[1];
+					memcpy_P(dst + col * 2, row + col * 2, static_cast<size_t>(length) * 2);
+				}
+				col += entry[1];
+			}
+			entry += 2;
+		}
+		return DisLib16::Success;
+	}
+#endif
+	// Each opaque run is copied to the scratch arena and sent through its own window
+	uint32_t chunkBytes = 0;
+	uint8_t *buffer = scratchAcquire(static_cast<uint32_t>(w) * 2, chunkBytes);
+	for (uint16_t j = 0; j < h; j++)
+	{
+		const uint8_t *row = bitmap + (static_cast<uint32_t>(j) * stride * 2);
+		uint32_t col = 0;
+		for (; entry[0] != 0 || entry[1] != 0; entry += 2)
+		{
+			col += entry[0];
+			if (col < w && entry[1] > 0)
+			{
+				const uint16_t length = (col + entry[1] > w) ? (w - col) : entry[1];
+				setAddrWindow(x + col, y + j, x + col + length - 1, y + j);
+				spiStartTransaction();
+				DISPLAY16_DC_SetHigh;
+				const uint8_t *src = row + col * 2;
+				for (uint32_t left = static_cast<uint32_t>(length) * 2; left > 0; )
+				{
+					const uint32_t piece = (left > chunkBytes) ? chunkBytes : left;
+					for (uint32_t b = 0; b < piece; b++)
+						buffer[b] = pgm_read_byte(src++);
+					spiWriteScratchBytes(buffer, piece);
+					left -= piece;
 				}
-			} else {
-				drawPixel(x + i - 1, y + j - 1, colour);
+				spiEndTransaction();
 			}
+			col += entry[1];
 		}
+		entry += 2;
 	}
 	return DisLib16::Success;
 }
@@ -1027,8 +3341,8 @@ DisLib16::Ret_Codes_e display16_graphics_LTSM::drawSpriteData(uint16_t x,uint16_
 */
 void display16_graphics_LTSM::writeCommand(uint8_t command)
 {
-	DISPLAY16_DC_SetLow;
 	spiStartTransaction();
+	DISPLAY16_DC_SetLow;
 	spiWrite(command);
 	spiEndTransaction();
 }
@@ -1039,8 +3353,8 @@ void display16_graphics_LTSM::writeCommand(uint8_t command)
 */
 void display16_graphics_LTSM ::writeData(uint8_t dataByte)
 {
-	DISPLAY16_DC_SetHigh;
 	spiStartTransaction();
+	DISPLAY16_DC_SetHigh;
 	spiWrite(dataByte);
 	spiEndTransaction();
 }
@@ -1083,31 +3397,147 @@ void display16_graphics_LTSM::spiWriteSoftware(uint8_t spiData)
 }
 
 /*!
-	@brief  Write a buffer to SPI, both Software and hardware SPI supported
-	@param spiData to send
+	@brief  Write a data buffer to SPI, both Software and hardware SPI supported
+	@param spiData to send, left unmodified
 	@param len length of buffer
+	@details Sets DC high and wraps the write in one transaction.
+		Hardware SPI uses the cores block transfer, see spiWriteBytes.
 */
-void display16_graphics_LTSM::spiWriteDataBuffer(uint8_t *spiData, uint32_t len)
+void display16_graphics_LTSM::spiWriteDataBuffer(const uint8_t *spiData, uint32_t len)
 {
 #if defined(ESP8266)
 	// ESP8266 needs a periodic yield() call to avoid watchdog reset.
 	yield();
 #endif
+	spiStartTransaction();
 	DISPLAY16_DC_SetHigh;
+	spiWriteBytes(spiData, len);
+	spiEndTransaction();
+}
+
+/*!
+	@brief  Write a scratch data buffer to SPI, both Software and hardware SPI supported
+	@param spiData to send, contents may be overwritten by received SPI data
+	@param len length of buffer
+	@details As spiWriteDataBuffer but skips the copy needed to preserve the source on
+		cores that only have an in place block transfer. Use for buffers rebuilt before each write.
+*/
+void display16_graphics_LTSM::spiWriteScratchBuffer(uint8_t *spiData, uint32_t len)
+{
+#if defined(ESP8266)
+	// ESP8266 needs a periodic yield() call to avoid watchdog reset.
+	yield();
+#endif
 	spiStartTransaction();
+	DISPLAY16_DC_SetHigh;
+	spiWriteScratchBytes(spiData, len);
+	spiEndTransaction();
+}
+
+/*!
+	@brief  Write bytes to SPI inside an open transaction, the source is left unmodified.
+	@param spiData to send
+	@param len number of bytes
+	@details Caller sets DC and the transaction. Hardware SPI transport by core:
+		-# ESP32, ESP8266 : SPI.writeBytes
+		-# RP2040 (arduino-pico) : SPI.transfer(tx, nullptr, len)
+		-# Others : SPI.transfer(buffer, len) through a small copy buffer,
+			as that call overwrites its buffer with received data.
+		-# dislib16_SPI_BYTE_TRANSFER_ENABLE : SPI.transfer per byte, fallback.
+*/
+void display16_graphics_LTSM::spiWriteBytes(const uint8_t *spiData, uint32_t len)
+{
 	if (_hardwareSPI == false)
 	{
 		for (uint32_t i = 0; i < len; i++)
 		{
 			spiWriteSoftware(spiData[i]);
 		}
-	}else{
-		for (uint32_t i = 0; i < len; i++)
+		return;
+	}
+#if defined(dislib16_SPI_BYTE_TRANSFER_ENABLE)
+	for (uint32_t i = 0; i < len; i++)
+	{
+		SPI.transfer(spiData[i]);
+	}
+#elif defined(ESP32) || defined(ESP8266)
+	SPI.writeBytes(const_cast<uint8_t *>(spiData), len);
+#elif defined(ARDUINO_ARCH_RP2040) && !defined(ARDUINO_ARCH_MBED)
+	SPI.transfer(spiData, nullptr, len);
+#else
+	uint8_t bounce[_SPIBounceSize];
+	while (len > 0)
+	{
+		uint32_t chunk = (len > _SPIBounceSize) ? _SPIBounceSize : len;
+		memcpy(bounce, spiData, chunk);
+		SPI.transfer(bounce, chunk);
+		spiData += chunk;
+		len -= chunk;
+	}
+#endif
+}
+
+/*!
+	@brief  Write one colour count times to SPI inside an open transaction.
+	@param color 565 16-bit
+	@param count number of pixels
+	@details Caller sets the address window, DC and the transaction. 
+		ESP32 and ESP8266 send the colour with the core's writePattern, 
+		the repeat is done by the SPI driver. Other cores send a small pattern 
+		buffer, kept between calls so a run of fills in one colour builds it once, 
+		through the block transfer as often as needed.
+*/
+void display16_graphics_LTSM::spiWriteColorRepeat(uint16_t color, uint32_t count)
+{
+	if (count == 0)
+		return;
+#if (defined(ESP32) || defined(ESP8266)) && !defined(dislib16_SPI_BYTE_TRANSFER_ENABLE)
+	if (_hardwareSPI)
+	{
+		uint8_t pixel[2]{static_cast<uint8_t>(color >> 8), static_cast<uint8_t>(color & 0xFF)};
+		SPI.writePattern(pixel, 2, count);
+		return;
+	}
+#endif
+	if (!_colorPatternValid || _colorPatternValue != color)
+	{
+		for (uint8_t i = 0; i < _colorPatternSize; i += 2)
 		{
-			SPI.transfer(spiData[i]);
+			_colorPattern[i] = color >> 8;
+			_colorPattern[i + 1] = color & 0xFF;
 		}
+		_colorPatternValue = color;
+		_colorPatternValid = true;
 	}
-	spiEndTransaction();
+	const uint32_t patternPixels = _colorPatternSize / 2;
+	while (count > 0)
+	{
+		uint32_t chunk = (count < patternPixels) ? count : patternPixels;
+		spiWriteBytes(_colorPattern, chunk * 2);
+		count -= chunk;
+	}
+}
+
+/*!
+	@brief  Write scratch bytes to SPI inside an open transaction.
+	@param spiData to send, contents may be overwritten by received SPI data
+	@param len number of bytes
+	@details Caller sets DC and the transaction. On cores with a write only block transfer
+		this is the same as spiWriteBytes, otherwise the buffer is transferred in place.
+*/
+void display16_graphics_LTSM::spiWriteScratchBytes(uint8_t *spiData, uint32_t len)
+{
+#if defined(dislib16_SPI_BYTE_TRANSFER_ENABLE) || defined(ESP32) || defined(ESP8266) || \
+	(defined(ARDUINO_ARCH_RP2040) && !defined(ARDUINO_ARCH_MBED))
+	spiWriteBytes(spiData, len);
+#else
+	if (_hardwareSPI == false)
+	{
+		spiWriteBytes(spiData, len);
+		return;
+	}
+	SPI.transfer(spiData, len);
+#endif
 }
 
 /*!
@@ -1122,40 +3552,111 @@ void display16_graphics_LTSM::setCursor(int16_t x, int16_t y)
 }
 
 /*!
-	@brief Set text color
+	@brief Set text color, with a transparent background
 	@param c  text color , Color definitions 16-Bit Color Values R5G6B5
+	@details Turns on transparent text, only the character pixels are drawn, see setTextTransparent.
 */
 void display16_graphics_LTSM::setTextColor(uint16_t c)
 {
 	_textcolor = _textbgcolor = c;
+	_textTransparent = true;
 }
 
 /*!
 	@brief Set text color foreground and background
 	@param c text foreground color , Color definitions 16-Bit Color Values R5G6B5
 	@param b text background color , Color definitions 16-Bit Color Values R5G6B5
+	@details Turns off transparent text, the whole character cell is drawn.
 */
 void display16_graphics_LTSM::setTextColor(uint16_t c, uint16_t b)
 {
 	_textcolor = c;
 	_textbgcolor = b;
+	_textTransparent = false;
+}
+
+/*!
+	@brief Turn transparent text on or off
+	@param transparent true: writeChar, writeCharString, print and drawTextBox draw only the 
+		foreground pixels of each character, what is under the rest of the cell is left as it is. 
+		false: the whole cell is drawn, background pixels in the text background colour.
+	@details Foreground pixels are sent as spans, each run of set pixels in a row, merged with 
+		the same run on the rows below, is one rectangle fill, or written straight into the 
+		screen buffer when one is set. Anti-aliased fonts are blended with the screen buffer 
+		pixels under them, without a screen buffer their pixels of half coverage or more are
+		drawn in the text colour.
+*/
+void display16_graphics_LTSM::setTextTransparent(bool transparent)
+{
+	_textTransparent = transparent;
+}
+
+/*!
+	@brief Get the transparent text mode
+	@return true if only the foreground pixels of text are drawn
+*/
+bool display16_graphics_LTSM::getTextTransparent(void) const
+{
+	return _textTransparent;
+}
+
+/*!
+	@brief Turn UTF-8 decoding of printed text on or off
+	@param utf8 true: print and write decode UTF-8, the default, so string literals saved as 
+		UTF-8 print characters past ASCII through the font codepoint map. 
+		false: each byte is one font character, as for writeChar and writeCharString.
+	@details Turning it off or on drops a sequence that has not completed.
+*/
+void display16_graphics_LTSM::setTextUTF8(bool utf8)
+{
+	_textUTF8 = utf8;
+	_utf8Remaining = 0;
+}
+
+/*!
+	@brief Get the UTF-8 decoding mode of printed text
+	@return true if print decodes UTF-8
+*/
+bool display16_graphics_LTSM::getTextUTF8(void) const
+{
+	return _textUTF8;
+}
+
+/// @cond
+// 256 entries of the RRRGGGBB palette, expanded at compile time by convert8bitTo16bit
+#define DISLIB16_RGB332_4(n) convert8bitTo16bit(n), convert8bitTo16bit((n) + 1), \
+	convert8bitTo16bit((n) + 2), convert8bitTo16bit((n) + 3)
+#define DISLIB16_RGB332_16(n) DISLIB16_RGB332_4(n), DISLIB16_RGB332_4((n) + 4), \
+	DISLIB16_RGB332_4((n) + 8), DISLIB16_RGB332_4((n) + 12)
+#define DISLIB16_RGB332_64(n) DISLIB16_RGB332_16(n), DISLIB16_RGB332_16((n) + 16), \
+	DISLIB16_RGB332_16((n) + 32), DISLIB16_RGB332_16((n) + 48)
+const uint16_t display16_graphics_LTSM::_rgb332Palette[256] FLASH_STORAGE = {
+	DISLIB16_RGB332_64(0), DISLIB16_RGB332_64(64), DISLIB16_RGB332_64(128), DISLIB16_RGB332_64(192)
+};
+#undef DISLIB16_RGB332_64
+#undef DISLIB16_RGB332_16
+#undef DISLIB16_RGB332_4
+/// @endcond
+
+/*!
+	@brief Set the palette of drawBitmap8Data
+	@param palette 256 RGB565 colours, one per bitmap byte value, stored with FLASH_STORAGE like 
+		bitmap data, it must stay valid while in use. nullptr restores the default RRRGGGBB palette.
+	@details Each bitmap byte is looked up in the palette, so an 8 bit bitmap can hold any 256 colours 
+		of artwork, e.g. a palette made by an image converter, not only RRRGGGBB.
+*/
+void display16_graphics_LTSM::setBitmap8Palette(const uint16_t *palette)
+{
+	_bitmap8Palette = (palette != nullptr) ? palette : _rgb332Palette;
 }
 
 /*!
-	@brief convert 8 bit color to 16 bit color 565
-	@param RRRGGGBB a byte of 8bit color
-	@details RRRGGGBB to RRRRRGGGGGGBBBBB
-	@return a uint16_t 565 color value
+	@brief Get the palette of drawBitmap8Data
+	@return the user palette, or the default RRRGGGBB palette
 */
-uint16_t display16_graphics_LTSM::convert8bitTo16bit(uint8_t RRRGGGBB)
+const uint16_t *display16_graphics_LTSM::getBitmap8Palette(void) const
 {
-	uint16_t red = (RRRGGGBB >> 5) & 0x07;
-	uint16_t green = (RRRGGGBB >> 2) & 0x07;
-	uint16_t blue = RRRGGGBB & 0x03;
-	red = (red * 255 / 7) >> 3;		// Scale 3-bit red (0-7) to 5-bit (0-31)
-	green = (green * 255 / 7) >> 2; // Scale 3-bit green (0-7) to 6-bit (0-63)
-	blue = (blue * 255 / 3) >> 3;	// Scale 2-bit blue (0-3) to 5-bit (0-31)
-	return (red << 11) | (green << 5) | blue;
+	return _bitmap8Palette;
 }
 
 /*!
@@ -1177,12 +3678,51 @@ bool display16_graphics_LTSM::getTextCharPixelOrBuffer() const
 	return _textCharPixelOrBuffer;
 }
 
+/*!
+	@brief Set the text scale, each font pixel is drawn as a scale x scale block.
+	@param scale 1 (default, font size) to 8
+	@return DisLib16::Success, or DisLib16::GenericError for a scale out of range, scale unchanged
+	@details Applies to writeChar, writeCharString and print, with any font type. 
+		Advances, line height and wrap use the scaled size. Scaled characters are expanded
+		one font row at a time into the scratch arena, no scaled copy of the font is kept.
+ */
+DisLib16::Ret_Codes_e display16_graphics_LTSM::setTextScale(uint8_t scale)
+{
+	if (scale < 1 || scale > _textScaleMax)
+	{
+		#ifdef dislib16_DEBUG_MODE_ENABLE
+			Serial.println("Error: setTextScale: scale must be 1 to 8");
+		#endif
+		return DisLib16::GenericError;
+	}
+	_textScale = scale;
+	return DisLib16::Success;
+}
+
+/*!
+	@brief Get the text scale
+	@return text scale factor, 1 to 8
+ */
+uint8_t display16_graphics_LTSM::getTextScale(void) const
+{
+	return _textScale;
+}
+
 
 /*!
 	@brief Begin an SPI transaction for the display.
+	@details Waits for an async buffer write in flight, so callers set DC after this call.
  */
 void display16_graphics_LTSM::spiStartTransaction(void)
 {
+	// Pixels held in a run go out ahead of any other traffic
+	if (_pixelRunCount > 0)
+		flushPixelRun();
+#ifdef dislib16_ADVANCED_SCREEN_BUFFER_ENABLE
+	// The bus belongs to an async buffer write until it completes
+	if (_bufferWriteActive)
+		waitBufferWrite();
+#endif
 	//There is a pre-defined macro SPI_HAS_TRANSACTION in SPI library for checking 
 	//whether the firmware of the Arduino board supports SPI.beginTransaction().
 	if (_hardwareSPI)
@@ -1913,6 +4453,8 @@ DisLib16::Ret_Codes_e display16_graphics_LTSM::setBuffer(void)
 		Serial.print("Buffer size set bytes: ");
 		Serial.println(_screenBuffer.size());
 	#endif
+	clearBufferDirty();
+	markBufferDirty(0, 0, _width, _height);
 	return DisLib16::Success;
 }
 
@@ -1933,12 +4475,9 @@ DisLib16::Ret_Codes_e display16_graphics_LTSM::clearBuffer(uint16_t color)
 		#endif
 		return DisLib16::BufferEmpty;
 	}
-	uint8_t high = color >> 8;
-	uint8_t low  = color & 0xFF;
-	for (size_t i = 0; i < _screenBuffer.size(); i += 2) {
-		_screenBuffer[i] = high;
-		_screenBuffer[i + 1] = low;
-	}
+	bufferFillSpan(_screenBuffer.data(), _screenBuffer.size() / 2, color);
+	clearBufferDirty();
+	markBufferDirty(0, 0, _width, _height);
 	return DisLib16::Success;
 }
 
@@ -1963,19 +4502,296 @@ DisLib16::Ret_Codes_e display16_graphics_LTSM::writeBuffer(uint8_t bufferMode )
 	if (bufferMode == 0){
 		//  write the entire buffer at once, default mode
 		setAddrWindow(0, 0, _width-1 , _height);
-		spiWriteDataBuffer(const_cast<uint8_t *>(_screenBuffer.data()),_screenBuffer.size());
+		spiWriteDataBuffer(_screenBuffer.data(), _screenBuffer.size());
 	} else {
 		// Write the buffer row by row
 		for (uint16_t row = 0; row < _height; ++row)
 		{
 			setAddrWindow(0, row, _width - 1, row);
 			const uint8_t* rowPtr = _screenBuffer.data() + row * _width * 2;
-			spiWriteDataBuffer(const_cast<uint8_t*>(rowPtr), _width * 2);
+			spiWriteDataBuffer(rowPtr, _width * 2);
+		}
+	}
+	clearBufferDirty();
+	return DisLib16::Success;
+}
+
+/*!
+	@brief Starts writing the screen buffer to the display and returns at once.
+		Where the core has a non-blocking SPI transfer (RP2040 arduino-pico DMA,
+		host build worker thread) the CPU is free while the frame goes out,
+		use isBufferWriteBusy() or waitBufferWrite() to check for completion.
+		Other cores, and software SPI, fall back to a blocking writeBuffer().
+	@param snapshot If true(default), the buffer is copied first so drawing can continue
+		at once while the copy is sent, this needs a second buffer of the same size.
+		If false the buffer itself is sent and must not be drawn to until the write completes.
+	@return DisLib16::Success on start of transfer.
+			DisLib16::BufferEmpty if the buffer is empty.
+	@note Any other SPI traffic to the display waits for the async write to complete first.
+*/
+DisLib16::Ret_Codes_e display16_graphics_LTSM::writeBufferAsync(bool snapshot)
+{
+	if (_screenBuffer.empty())
+	{
+		#ifdef dislib16_DEBUG_MODE_ENABLE
+			Serial.println("Error: writeBufferAsync: Buffer is empty");
+		#endif
+		return DisLib16::BufferEmpty;
+	}
+	waitBufferWrite();
+	clearBufferDirty();
+#ifdef dislib16_SPI_ASYNC_AVAILABLE
+	if (_hardwareSPI)
+	{
+		const uint8_t* txData = _screenBuffer.data();
+		if (snapshot)
+		{
+			_screenBufferTx.resize(_screenBuffer.size());
+			if (_screenBufferTx.size() != _screenBuffer.size())
+			{
+				#ifdef dislib16_DEBUG_MODE_ENABLE
+					Serial.println("Warning: writeBufferAsync: snapshot allocation failed, blocking write");
+				#endif
+				return writeBuffer(0);
+			}
+			memcpy(_screenBufferTx.data(), _screenBuffer.data(), _screenBuffer.size());
+			txData = _screenBufferTx.data();
+		}
+		setAddrWindow(0, 0, _width - 1, _height - 1);
+		spiStartTransaction();
+		DISPLAY16_DC_SetHigh;
+		if (SPI.transferAsync(txData, nullptr, _screenBuffer.size()))
+		{
+			_bufferWriteActive = true;
+			return DisLib16::Success;
+		}
+		// Core refused the transfer, send it blocking
+		spiWriteBytes(txData, _screenBuffer.size());
+		spiEndTransaction();
+		return DisLib16::Success;
+	}
+#else
+	(void)snapshot;
+#endif
+	return writeBuffer(0);
+}
+
+/*!
+	@brief Checks if an async buffer write started by writeBufferAsync is in flight.
+		Completes the SPI transaction when the transfer has finished.
+	@return true if the write is still in flight, false if complete or none started.
+*/
+bool display16_graphics_LTSM::isBufferWriteBusy(void)
+{
+	if (!_bufferWriteActive)
+		return false;
+#ifdef dislib16_SPI_ASYNC_AVAILABLE
+	if (!SPI.finishedAsync())
+		return true;
+#endif
+	_bufferWriteActive = false;
+	spiEndTransaction();
+	return false;
+}
+
+/*!
+	@brief Waits for an async buffer write started by writeBufferAsync to complete.
+		Returns at once if none is in flight.
+*/
+void display16_graphics_LTSM::waitBufferWrite(void)
+{
+	while (isBufferWriteBusy())
+	{
+		yield();
+	}
+}
+
+/*!
+	@brief Writes only the damaged regions of the screen buffer to the display.
+		Drawing into the buffer records the regions it touches, see markBufferDirty.
+		Each region is sent in one address window, row segments streamed in one transaction.
+		The damaged set is cleared afterwards.
+	@param bufferMode If 0(default), one address window per region; otherwise one per region row,
+			for displays like SSD1331 that require row by row writes.
+	@return DisLib16::Success on completion.
+			DisLib16::BufferEmpty if the buffer is empty.
+*/
+DisLib16::Ret_Codes_e display16_graphics_LTSM::writeBufferDirty(uint8_t bufferMode)
+{
+	if (_screenBuffer.empty())
+	{
+		#ifdef dislib16_DEBUG_MODE_ENABLE
+			Serial.println("Error: writeBufferDirty: Buffer is empty");
+		#endif
+		return DisLib16::BufferEmpty;
+	}
+	for (uint8_t i = 0; i < _dirtyRectCount; i++)
+	{
+		const dirty_rect_t& rect = _dirtyRects[i];
+		const uint32_t rowBytes = static_cast<uint32_t>(rect.x1 - rect.x0 + 1) * 2;
+		const uint8_t* rowPtr = _screenBuffer.data() + (static_cast<size_t>(rect.y0) * _width + rect.x0) * 2;
+		if (bufferMode == 0)
+		{
+			setAddrWindow(rect.x0, rect.y0, rect.x1, rect.y1);
+			spiStartTransaction();
+			DISPLAY16_DC_SetHigh;
+			if (rect.x0 == 0 && rect.x1 == _width - 1)
+			{
+				// full width rows are contiguous in the buffer
+				spiWriteBytes(rowPtr, rowBytes * (rect.y1 - rect.y0 + 1));
+			}else{
+				for (uint16_t row = rect.y0; row <= rect.y1; row++, rowPtr += _width * 2)
+					spiWriteBytes(rowPtr, rowBytes);
+			}
+			spiEndTransaction();
+		} else {
+			for (uint16_t row = rect.y0; row <= rect.y1; row++, rowPtr += _width * 2)
+			{
+				setAddrWindow(rect.x0, row, rect.x1, row);
+				spiWriteDataBuffer(rowPtr, rowBytes);
+			}
 		}
 	}
+	clearBufferDirty();
 	return DisLib16::Success;
 }
 
+/*!
+	@brief Records a damaged region of the screen buffer, to be sent by writeBufferDirty.
+		Called by the buffer drawing functions, call it after writing to the buffer by other means.
+		A region is merged with a tracked one when that adds few clean pixels,
+		and when more than _dirtyRectMax are tracked the cheapest pair is merged.
+	@param x left column
+	@param y top row
+	@param w width, clipped to screen
+	@param h height, clipped to screen
+*/
+void display16_graphics_LTSM::markBufferDirty(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+	if (w == 0 || h == 0 || x >= _width || y >= _height)
+		return;
+	if ((x + w - 1) >= _width)
+		w = _width - x;
+	if ((y + h - 1) >= _height)
+		h = _height - y;
+	dirty_rect_t rect{x, y, static_cast<uint16_t>(x + w - 1), static_cast<uint16_t>(y + h - 1)};
+	// Fast path, already inside the region last grown
+	if (_dirtyRectCount > 0)
+	{
+		const dirty_rect_t& last = _dirtyRects[_dirtyRectLast];
+		if (rect.x0 >= last.x0 && rect.x1 <= last.x1 && rect.y0 >= last.y0 && rect.y1 <= last.y1)
+			return;
+	}
+	addDirtyRect(rect);
+}
+
+/*!
+	@brief Clears the set of damaged regions, without writing them.
+*/
+void display16_graphics_LTSM::clearBufferDirty(void)
+{
+	_dirtyRectCount = 0;
+	_dirtyRectLast = 0;
+}
+
+/*!
+	@brief Gets the number of damaged regions of the screen buffer.
+	@return number of regions, 0 to _dirtyRectMax
+*/
+uint8_t display16_graphics_LTSM::getDirtyRectCount(void) const
+{
+	return _dirtyRectCount;
+}
+
+/*!
+	@brief Gets a damaged region of the screen buffer.
+	@param index region index, 0 to getDirtyRectCount()-1
+	@return the region, inclusive co-ordinates, all zero if index out of range
+*/
+display16_graphics_LTSM::dirty_rect_t display16_graphics_LTSM::getDirtyRect(uint8_t index) const
+{
+	if (index >= _dirtyRectCount)
+		return dirty_rect_t{0, 0, 0, 0};
+	return _dirtyRects[index];
+}
+
+/// @cond
+
+/*!
+	@brief Clean pixels added by merging two regions into their bounding box.
+	@param a first region
+	@param b second region
+	@return pixels in the union not covered by either region
+*/
+int32_t display16_graphics_LTSM::dirtyMergeWaste(const dirty_rect_t& a, const dirty_rect_t& b) const
+{
+	auto area = [](int32_t x0, int32_t y0, int32_t x1, int32_t y1) -> int32_t {
+		return (x1 < x0 || y1 < y0) ? 0 : (x1 - x0 + 1) * (y1 - y0 + 1);
+	};
+	auto lo = [](uint16_t p, uint16_t q) -> int32_t { return p < q ? p : q; };
+	auto hi = [](uint16_t p, uint16_t q) -> int32_t { return p > q ? p : q; };
+	int32_t unionArea = area(lo(a.x0, b.x0), lo(a.y0, b.y0), hi(a.x1, b.x1), hi(a.y1, b.y1));
+	int32_t overlap = area(hi(a.x0, b.x0), hi(a.y0, b.y0), lo(a.x1, b.x1), lo(a.y1, b.y1));
+	return unionArea - area(a.x0, a.y0, a.x1, a.y1) - area(b.x0, b.y0, b.x1, b.y1) + overlap;
+}
+
+/*!
+	@brief Adds a region to the damaged set, merging where cheap or when the set is full.
+	@param rect region to add
+*/
+void display16_graphics_LTSM::addDirtyRect(dirty_rect_t rect)
+{
+	auto merge = [](dirty_rect_t& into, const dirty_rect_t& from) {
+		if (from.x0 < into.x0) into.x0 = from.x0;
+		if (from.y0 < into.y0) into.y0 = from.y0;
+		if (from.x1 > into.x1) into.x1 = from.x1;
+		if (from.y1 > into.y1) into.y1 = from.y1;
+	};
+	// Absorb every region that is cheap to merge, repeat as the region grows
+	bool merged = true;
+	while (merged)
+	{
+		merged = false;
+		for (uint8_t i = 0; i < _dirtyRectCount; i++)
+		{
+			if (dirtyMergeWaste(_dirtyRects[i], rect) <= _dirtyMergeSlack)
+			{
+				merge(rect, _dirtyRects[i]);
+				_dirtyRects[i] = _dirtyRects[--_dirtyRectCount];
+				merged = true;
+				break;
+			}
+		}
+	}
+	// Set full, merge the pair that wastes least, the new region included
+	while (_dirtyRectCount >= _dirtyRectMax)
+	{
+		uint8_t bestA = 0, bestB = _dirtyRectMax; // B == _dirtyRectMax means the new region
+		int32_t bestWaste = INT32_MAX;
+		for (uint8_t i = 0; i < _dirtyRectCount; i++)
+		{
+			int32_t waste = dirtyMergeWaste(_dirtyRects[i], rect);
+			if (waste < bestWaste) { bestWaste = waste; bestA = i; bestB = _dirtyRectMax; }
+			for (uint8_t j = i + 1; j < _dirtyRectCount; j++)
+			{
+				waste = dirtyMergeWaste(_dirtyRects[i], _dirtyRects[j]);
+				if (waste < bestWaste) { bestWaste = waste; bestA = i; bestB = j; }
+			}
+		}
+		if (bestB == _dirtyRectMax)
+		{
+			merge(rect, _dirtyRects[bestA]);
+		}else{
+			merge(_dirtyRects[bestA], _dirtyRects[bestB]);
+		}
+		_dirtyRects[bestB == _dirtyRectMax ? bestA : bestB] = _dirtyRects[--_dirtyRectCount];
+	}
+	_dirtyRectLast = _dirtyRectCount;
+	_dirtyRects[_dirtyRectCount++] = rect;
+}
+
+/// @endcond
+
 /*!
 	@brief Destroys the screen buffer by resizing it to zero.
 		This function checks if the buffer has been 
@@ -1985,7 +4801,11 @@ DisLib16::Ret_Codes_e display16_graphics_LTSM::writeBuffer(uint8_t bufferMode )
 */
 DisLib16::Ret_Codes_e display16_graphics_LTSM::destroyBuffer(void)
 {
+	waitBufferWrite();
+	_screenBufferTx.clear();
+	_screenBufferTx.shrink_to_fit();
 	_screenBuffer.resize(0);
+	clearBufferDirty();
 	if (_screenBuffer.size() == 0)
 	{
 		#ifdef dislib16_DEBUG_MODE_ENABLE
@@ -2000,5 +4820,81 @@ DisLib16::Ret_Codes_e display16_graphics_LTSM::destroyBuffer(void)
 	}
 	return DisLib16::Success;
 }
+
+/*!
+	@brief Is a screen buffer set, if so the drawing functions write to it instead of VRAM.
+	@return true between a successful setBuffer and destroyBuffer
+*/
+bool display16_graphics_LTSM::isBufferActive(void) const
+{
+	return !_screenBuffer.empty();
+}
+
+/// @cond
+
+/*!
+	@brief Fills a rectangle of the screen buffer with a color and marks it dirty.
+		The first row is filled as a span, the other rows are copied from it.
+	@param x left column
+	@param y top row
+	@param w width, already clipped to screen
+	@param h height, already clipped to screen
+	@param color 565 16-bit
+*/
+void display16_graphics_LTSM::bufferFillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color)
+{
+	if (w == 0 || h == 0)
+		return;
+	markBufferDirty(x, y, w, h);
+	uint8_t *first = &_screenBuffer[(static_cast<size_t>(y) * _width + x) * 2];
+	if (w == _width) // rows are contiguous, one span
+	{
+		bufferFillSpan(first, static_cast<uint32_t>(w) * h, color);
+		return;
+	}
+	bufferFillSpan(first, w, color);
+	const size_t stride = static_cast<size_t>(_width) * 2;
+	uint8_t *row = first;
+	for (uint16_t j = 1; j < h; j++)
+	{
+		row += stride;
+		memcpy(row, first, static_cast<size_t>(w) * 2);
+	}
+}
+
+/// @endcond
 #endif
+
+/// @cond
+/*!
+	@brief Fills a span of RGB565 pixels with one color, in the screen buffer or the scratch arena.
+		memset when both bytes of the color match, e.g black and white,
+		otherwise one pixel is written and the span doubled by memcpy.
+	@param dst first byte of the span
+	@param pixels number of pixels
+	@param color 565 16-bit
+*/
+void display16_graphics_LTSM::bufferFillSpan(uint8_t *dst, uint32_t pixels, uint16_t color)
+{
+	if (pixels == 0)
+		return;
+	const uint8_t hi = color >> 8;
+	const uint8_t lo = color & 0xFF;
+	const size_t total = static_cast<size_t>(pixels) * 2;
+	if (hi == lo)
+	{
+		memset(dst, hi, total);
+		return;
+	}
+	dst[0] = hi;
+	dst[1] = lo;
+	size_t filled = 2;
+	while (filled < total)
+	{
+		size_t chunk = (filled <= total - filled) ? filled : (total - filled);
+		memcpy(dst + filled, dst, chunk);
+		filled += chunk;
+	}
+}
+/// @endcond
 //**************** EOF *****************
@@ -11,9 +11,15 @@
 #include <SPI.h>
 #include <math.h> // sin & cos
 
-#ifdef dislib16_ADVANCED_SCREEN_BUFFER_ENABLE
+#if defined(dislib16_ADVANCED_SCREEN_BUFFER_ENABLE) || defined(dislib16_GLYPH_CACHE_ENABLE)
 #include <vector>
 #endif
+#ifdef dislib16_ADVANCED_SCREEN_BUFFER_ENABLE
+// Cores with a non-blocking (DMA) SPI transfer, used by writeBufferAsync
+#if defined(SPI_HAS_TRANSFER_ASYNC) || (defined(ARDUINO_ARCH_RP2040) && !defined(ARDUINO_ARCH_MBED))
+#define dislib16_SPI_ASYNC_AVAILABLE
+#endif
+#endif
 
 /*!
 	@brief Class to handle graphics of ST7735 display
@@ -62,6 +68,39 @@ public:
 		Degrees_180,   /**< Rotation 180 degrees*/
 		Degrees_270    /**< Rotation 270 degrees*/
 	};
+	/*! Horizontal alignment of text lines in a box, see drawTextBox */
+	enum text_align_e : uint8_t
+	{
+		TextAlignLeft = 0, /**< Lines start at the box left */
+		TextAlignCentre,   /**< Lines centred in the box */
+		TextAlignRight     /**< Lines end at the box right */
+	};
+	/*! @brief A number drawn in a row of fixed cells and redrawn in place, see setNumericField */
+	struct numeric_field_t
+	{
+		static constexpr uint8_t cellsMax = 16; /**< Most cells in a field */
+		const uint8_t *font = nullptr; /**< Font of the field, nullptr not set */
+		uint16_t x = 0;          /**< Left of the first cell */
+		uint16_t y = 0;          /**< Top of the cells */
+		uint8_t width = 0;       /**< Cells, the text is right aligned in them */
+		uint8_t decimals = 0;    /**< Digits after the decimal point of a fixed point value */
+		bool zeroPad = false;    /**< Pad with '0' after the sign, else blank cells before it */
+		bool drawn = false;      /**< shown is on the screen, false repaints every cell */
+		uint16_t fg = 0;         /**< Text colour shown */
+		uint16_t bg = 0;         /**< Background colour shown */
+		uint8_t scale = 1;       /**< Text scale shown */
+		char shown[cellsMax] = {}; /**< Character on screen in each cell, ' ' a blank cell */
+	};
+#ifdef dislib16_ADVANCED_SCREEN_BUFFER_ENABLE
+	/*! @brief A damaged region of the screen buffer, inclusive co-ordinates */
+	struct dirty_rect_t
+	{
+		uint16_t x0; /**< Left column */
+		uint16_t y0; /**< Top row */
+		uint16_t x1; /**< Right column */
+		uint16_t y1; /**< Bottom row */
+	};
+#endif
 
 public:
 	// === buffer screen mode functions ===
@@ -69,7 +108,16 @@ public:
 	DisLib16::Ret_Codes_e setBuffer(void);
 	DisLib16::Ret_Codes_e clearBuffer(uint16_t color = C_BLACK);
 	DisLib16::Ret_Codes_e writeBuffer(uint8_t bufferMode = 0);
+	DisLib16::Ret_Codes_e writeBufferAsync(bool snapshot = true);
+	bool isBufferWriteBusy(void);
+	void waitBufferWrite(void);
+	DisLib16::Ret_Codes_e writeBufferDirty(uint8_t bufferMode = 0);
+	void markBufferDirty(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+	void clearBufferDirty(void);
+	uint8_t getDirtyRectCount(void) const;
+	dirty_rect_t getDirtyRect(uint8_t index) const;
 	DisLib16::Ret_Codes_e destroyBuffer(void);
+	bool isBufferActive(void) const;
 #endif 
 	// ====================================
 	// Screen functions
@@ -78,6 +126,22 @@ public:
 	void fillScreen(uint16_t color);
 	void setCursor(int16_t x, int16_t y);
 	void drawPixel(uint16_t, uint16_t, uint16_t);
+	void beginPixelBatch(void);
+	void endPixelBatch(void);
+	uint32_t getPixelWindowsSaved(void) const;
+	void resetPixelWindowsSaved(void);
+	DisLib16::Ret_Codes_e setScratchBuffer(uint8_t *buffer, uint32_t size);
+	uint32_t getScratchSize(void) const;
+	uint32_t getScratchHighWater(void) const;
+	void resetScratchHighWater(void);
+#ifdef dislib16_GLYPH_CACHE_ENABLE
+	DisLib16::Ret_Codes_e setGlyphCache(uint32_t budgetBytes);
+	void clearGlyphCache(void);
+	uint8_t getGlyphCacheSlots(void) const;
+	uint32_t getGlyphCacheHits(void) const;
+	uint32_t getGlyphCacheMisses(void) const;
+	void resetGlyphCacheStats(void);
+#endif
 	// Graphics functions
 	void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
 	void drawFastVLine(uint16_t x, uint16_t y, uint16_t h, uint16_t color);
@@ -107,6 +171,8 @@ public:
 #endif
 	// Text functions
 	virtual size_t write(uint8_t) override;
+	virtual size_t write(const uint8_t *buffer, size_t size) override;
+	using Print::write;
 	void setTextWrap(bool w);
 	void setTextColor(uint16_t c);
 	void setTextColor(uint16_t c, uint16_t bg);
@@ -114,11 +180,31 @@ public:
 	DisLib16::Ret_Codes_e  writeCharString( uint16_t x, uint16_t y, char *text);
 	void setTextCharPixelOrBuffer(bool mode);
 	bool getTextCharPixelOrBuffer() const;
+	void setTextTransparent(bool transparent);
+	bool getTextTransparent(void) const;
+	void setTextUTF8(bool utf8);
+	bool getTextUTF8(void) const;
+	DisLib16::Ret_Codes_e setTextScale(uint8_t scale);
+	uint8_t getTextScale(void) const;
+	DisLib16::Ret_Codes_e getTextBounds(const char *text, uint16_t &w, uint16_t &h) const;
+	DisLib16::Ret_Codes_e drawTextBox(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const char *text, 
+		text_align_e align, uint16_t *drawnChars = nullptr);
+	DisLib16::Ret_Codes_e setNumericField(numeric_field_t &field, uint16_t x, uint16_t y, const uint8_t *font,
+		uint8_t width, uint8_t decimals = 0, bool zeroPad = false);
+	DisLib16::Ret_Codes_e drawNumericField(numeric_field_t &field, int32_t value);
+	DisLib16::Ret_Codes_e drawNumericFieldText(numeric_field_t &field, const char *text);
 	// Bitmap functions
 	DisLib16::Ret_Codes_e drawBitmap(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t col, uint16_t bgcol, const uint8_t* data);
 	DisLib16::Ret_Codes_e drawBitmap8Data(uint16_t x, uint16_t y, const uint8_t* data, uint16_t w, uint16_t h);
+	void setBitmap8Palette(const uint16_t *palette);
+	const uint16_t *getBitmap8Palette(void) const;
+	DisLib16::Ret_Codes_e drawBitmapIndexed(uint16_t x, uint16_t y, const uint8_t* data);
 	DisLib16::Ret_Codes_e drawBitmap16Data(uint16_t x, uint16_t y, const uint8_t* data, uint16_t w, uint16_t h);
+	DisLib16::Ret_Codes_e drawBitmapCompressed(uint16_t x, uint16_t y, const uint8_t* data);
 	DisLib16::Ret_Codes_e drawSpriteData(uint16_t x, uint16_t y, const uint8_t* data, uint16_t w, uint16_t h, uint16_t bgColor, bool printBg);
+	DisLib16::Ret_Codes_e buildSpriteRuns(const uint8_t* data, uint16_t w, uint16_t h, uint16_t bgColor,
+		uint8_t *runs, uint32_t size, uint32_t &used);
+	DisLib16::Ret_Codes_e drawSpriteRuns(uint16_t x, uint16_t y, const uint8_t* data, const uint8_t *runs);
 
 protected:
 	// SPI function
@@ -128,17 +214,37 @@ protected:
 	void writeData(uint8_t);
 	void spiWrite(uint8_t);
 	void spiWriteSoftware(uint8_t spidata);
-	void spiWriteDataBuffer(uint8_t *spidata, uint32_t len);
+	void spiWriteDataBuffer(const uint8_t *spidata, uint32_t len);
+	void spiWriteScratchBuffer(uint8_t *spidata, uint32_t len);
+	void spiWriteBytes(const uint8_t *spidata, uint32_t len);
+	void spiWriteScratchBytes(uint8_t *spidata, uint32_t len);
+	void spiWriteColorRepeat(uint16_t color, uint32_t count);
 
 protected:
 	// SPI variables
 	bool _hardwareSPI;			  /**< True for Hardware SPI on , false for Software SPI on*/
 	uint32_t _speedSPIHz;		  /**< SPI speed value in hertz*/
 	uint16_t _SWSPIGPIODelay = 0; /**< uS GPIO Communications delay, SW SPI ONLY */
+	static constexpr uint8_t _SPIBounceSize = 64; /**< Bytes in the copy buffer used by cores with only in place block transfers */
+	static constexpr uint8_t _colorPatternSize = _SPIBounceSize; /**< Bytes in the colour pattern sent by spiWriteColorRepeat, one bounce copy per block */
+	uint8_t _colorPattern[_colorPatternSize]; /**< Repeated colour of the last solid fill, kept for the next */
+	uint16_t _colorPatternValue = 0; /**< Colour held in _colorPattern */
+	bool _colorPatternValid = false; /**< _colorPattern has been built */
 	// text variables
 	bool _textwrap = true;			/**< wrap text around the screen on overflow*/
 	uint16_t _textcolor = 0xFFFF;	/**< ForeGround color for text*/
 	uint16_t _textbgcolor = 0x0000; /**< BackGround color for text*/
+	uint16_t _textRamp[16]; /**< Colour per coverage level of the text colour pair, see textRampSync */
+	uint16_t _textRampFg = 0; /**< Foreground colour of _textRamp */
+	uint16_t _textRampBg = 0; /**< Background colour of _textRamp */
+	uint8_t _textRampLevels = 0; /**< Entries in _textRamp, 0 not built */
+	bool _textTransparent = false; /**< Text draws only its foreground pixels, see setTextTransparent */
+	uint8_t _textScale = 1; /**< Text scale factor, each font pixel drawn as a block this size */
+	static constexpr uint8_t _textScaleMax = 8; /**< Largest text scale factor */
+	bool _textUTF8 = true; /**< print decodes UTF-8, see setTextUTF8 */
+	uint32_t _utf8Codepoint = 0; /**< Codepoint bits of the UTF-8 sequence being decoded */
+	uint8_t _utf8Remaining = 0; /**< Continuation bytes still to come, 0 none pending */
+	uint8_t _utf8Length = 0; /**< Continuation bytes of the pending sequence */
 	// Screen variables
 	int16_t _cursorX = 0; /**< Current pixel column postion of Cursor*/
 	int16_t _cursorY = 0; /**< Current pixel row position of Cursor*/
@@ -162,7 +268,104 @@ private:
 		a = b;
 		b = t;
 	}
-	uint16_t convert8bitTo16bit(uint8_t RRRGGGBB);
+	/*!
+		@brief convert 8 bit color to 16 bit color 565, each channel scaled to its full range
+		@param RRRGGGBB a byte of 8bit color
+		@return a uint16_t 565 color value
+		@details constexpr, used to build _rgb332Palette at compile time.
+	*/
+	static constexpr uint16_t convert8bitTo16bit(uint8_t RRRGGGBB)
+	{
+		return static_cast<uint16_t>((((((RRRGGGBB >> 5) & 0x07) * 255 / 7) >> 3) << 11) |
+			(((((RRRGGGBB >> 2) & 0x07) * 255 / 7) >> 2) << 5) | (((RRRGGGBB & 0x03) * 255 / 3) >> 3));
+	}
+	/*! @brief An indexed bitmap being drawn, read from its header */
+	struct bitmap_indexed_t
+	{
+		const uint8_t *palette; /**< RGB565 palette, 2 bytes per colour, high byte first */
+		const uint8_t *pixels;  /**< First row of palette indices */
+		uint8_t bitsPerPixel;   /**< 1, 2, 4 or 8 */
+		uint8_t lastIndex;      /**< Colours in the palette - 1, larger indices use the last colour */
+		uint16_t lut[16];       /**< The palette in RAM, for 1 to 4 bits per pixel */
+	};
+	static constexpr uint8_t _bitmapIndexedHeader = 6; /**< Bytes before the palette of an indexed bitmap */
+	void bitmapIndexedRow(const bitmap_indexed_t &image, const uint8_t *row, uint16_t firstCol,
+		uint16_t cols, uint8_t *dst) const;
+	/*! @brief A compressed bitmap being decoded, see drawBitmapCompressed */
+	struct bitmap_stream_t
+	{
+		const uint8_t *data;  /**< Next byte of the stream */
+		uint16_t previous;    /**< Last pixel decoded */
+		uint16_t run;         /**< Repeats of previous still to come */
+		uint16_t seen[64];    /**< Colours seen, by hash */
+	};
+	static constexpr uint8_t _bitmapCompressedTag = 0x51; /**< First byte of a compressed bitmap, 'Q' */
+	static constexpr uint8_t _bitmapCompressedHeader = 5; /**< Bytes before the stream of a compressed bitmap */
+	uint16_t bitmapStreamPixel(bitmap_stream_t &stream) const;
+	static constexpr uint8_t _spriteRunsTag = 0x53; /**< First byte of a sprite run table, 'S' */
+	static constexpr uint8_t _spriteRunsHeader = 5; /**< Bytes before the rows of a sprite run table */
+	static void spriteRunsPut(uint8_t *runs, uint32_t size, uint32_t &count, uint8_t value);
+#ifdef dislib16_ADVANCED_SCREEN_BUFFER_ENABLE
+	static void spriteRowSelect(uint8_t *dst, const uint8_t *row, uint16_t w, uint16_t backgroundColor);
+#endif
+	static const uint16_t _rgb332Palette[256]; /**< RRRGGGBB to RGB565, in flash, default drawBitmap8Data palette */
+	const uint16_t *_bitmap8Palette = _rgb332Palette; /**< Palette of drawBitmap8Data, see setBitmap8Palette */
+	void pixelRunAppend(uint16_t x, uint16_t y, uint16_t color);
+	void flushPixelRun(void);
+	uint8_t *scratchAcquire(uint32_t wanted, uint32_t &granted);
+	bool charRunEnabled(void) const;
+	uint16_t charRunLength(const uint8_t *text, uint16_t count, int32_t cursor, bool wrap, uint32_t &advance) const;
+	void writeCharRun(uint16_t x, uint16_t y, const uint8_t *text, uint16_t count, uint32_t advance);
+	DisLib16::Ret_Codes_e writeCharProportional(uint16_t x, uint16_t y, uint8_t character, uint16_t fg, uint16_t bg);
+	uint8_t glyphLevel(const font_glyph_t &glyph, uint16_t col, uint16_t row) const;
+	void textRampSync(uint16_t fg, uint16_t bg);
+	DisLib16::Ret_Codes_e writeCharCompressed(uint16_t x, uint16_t y, uint8_t character, uint16_t fg, uint16_t bg);
+	DisLib16::Ret_Codes_e writeCharScaled(uint16_t x, uint16_t y, uint8_t character, uint16_t fg, uint16_t bg);
+	const uint8_t *textScaledRow(const font_glyph_t &glyph, const uint8_t *codes, uint16_t row,
+		uint16_t firstCol, uint16_t cols, uint8_t *dst) const;
+	/*! @brief A rectangle of foreground pixels of transparent text, runs of rows with the same columns */
+	struct text_span_t
+	{
+		uint16_t x; /**< Left column */
+		uint16_t y; /**< Top row */
+		uint16_t w; /**< Width */
+		uint16_t h; /**< Height, rows merged so far */
+	};
+	static constexpr uint8_t _textSpanMax = 8; /**< Spans held open for merging with the next row */
+	DisLib16::Ret_Codes_e writeCharTransparent(uint16_t x, uint16_t y, uint8_t character, uint16_t fg);
+	void textSpanAdd(text_span_t *spans, uint8_t &count, uint16_t x, uint16_t y, uint16_t w, uint16_t color);
+	void textSpanFill(const text_span_t &span, uint16_t color);
+	static uint16_t blendColor(uint16_t fg, uint16_t bg, uint8_t level, uint8_t top);
+	uint16_t textAdvance(uint8_t character) const;
+	uint16_t textLineHeight(void) const;
+	size_t writeCursorChar(uint8_t character);
+	bool textUTF8Decode(uint8_t value, uint32_t &codepoint);
+	static constexpr uint8_t _fontRunFillMin = 16; /**< Compressed font runs this long or longer are sent as colour fills */
+#ifdef dislib16_GLYPH_CACHE_ENABLE
+	/*! @brief A glyph held in the glyph cache, its key and LRU stamp */
+	struct glyph_cache_entry_t
+	{
+		const uint8_t *font; /**< Font of the glyph */
+		uint16_t fg;         /**< Foreground colour drawn, after any font invert */
+		uint16_t bg;         /**< Background colour drawn, after any font invert */
+		uint8_t character;   /**< Character */
+		bool valid;          /**< Slot holds a glyph */
+		uint32_t lastUsed;   /**< _glyphCacheTick of last use */
+	};
+	static constexpr uint8_t _glyphCacheNone = 0xFF; /**< No slot */
+	static constexpr uint8_t _glyphCacheRunMemo = 64; /**< Characters of a text run looked up in the cache, the rest are expanded */
+	std::vector<uint8_t> _glyphCacheData; /**< Slots of RGB565 glyph blocks */
+	std::vector<glyph_cache_entry_t> _glyphCacheEntries; /**< Key of each slot */
+	uint32_t _glyphCacheBudget = 0; /**< Byte budget for glyph blocks, 0 cache off */
+	uint32_t _glyphCacheSlotBytes = 0; /**< Bytes per slot, one glyph of the current font */
+	const uint8_t *_glyphCacheFont = nullptr; /**< Font the slots were sized for */
+	uint16_t _glyphCacheFontChange = 0; /**< _FontChangeCount the slots were sized for */
+	uint32_t _glyphCacheTick = 0; /**< Draw call counter for LRU */
+	uint32_t _glyphCacheHits = 0; /**< Glyph lookups found in the cache */
+	uint32_t _glyphCacheMisses = 0; /**< Glyph lookups not found */
+	void glyphCacheSync(void);
+	uint8_t glyphCacheFind(uint8_t character, uint16_t fg, uint16_t bg);
+#endif
 	void drawCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t cornername, uint16_t color);
 	void fillCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t cornername, int16_t delta, uint16_t color);
 #ifdef dislib16_ADVANCED_GRAPHICS_ENABLE
@@ -177,9 +380,37 @@ private:
 #endif
 
 	bool _textCharPixelOrBuffer = false;  /**< Text character is drawn by local function buffer(false) or pixel(true) */
+	// Pixel run, consecutive drawPixel calls sent through one address window
+	static constexpr uint8_t _pixelRunMax = 32; /**< Pixels held in the pending run before it is sent */
+	static constexpr uint16_t _pixelRunOpenRow = 0xFFFF; /**< _pixelRunX1 value while the run is still on its first row */
+	uint8_t _pixelRunBuffer[_pixelRunMax * 2]; /**< Colour bytes of the pending run */
+	uint8_t _pixelRunCount = 0; /**< Pixels in the pending run, 0 none */
+	uint8_t _pixelBatchDepth = 0; /**< Nesting of beginPixelBatch, the run is kept open while non zero */
+	uint16_t _pixelRunX0 = 0; /**< Left column of the pending run window */
+	uint16_t _pixelRunY0 = 0; /**< Top row of the pending run window */
+	uint16_t _pixelRunX1 = _pixelRunOpenRow; /**< Right column of the pending run window, once it wraps a row */
+	uint16_t _pixelRunXLast = 0; /**< Column of the last pixel in the run */
+	uint16_t _pixelRunYLast = 0; /**< Row of the last pixel in the run */
+	uint32_t _pixelWindowsSaved = 0; /**< Address windows not sent thanks to pixel runs */
+	// Scratch arena, glyphs and bitmap rows are built here then sent
+	uint8_t _scratchInternal[dislib16_SCRATCH_BYTES]; /**< Default scratch arena, USER OPTION 5 */
+	uint8_t *_scratch = _scratchInternal; /**< Scratch arena in use, internal or set by user */
+	uint32_t _scratchSize = dislib16_SCRATCH_BYTES; /**< Bytes in the scratch arena in use */
+	uint32_t _scratchHighWater = 0; /**< Largest piece asked of the scratch arena */
 #ifdef dislib16_ADVANCED_SCREEN_BUFFER_ENABLE
 	std::vector <uint8_t> _screenBuffer; /**< Buffer for screen*/
+	std::vector <uint8_t> _screenBufferTx; /**< Copy of screen buffer being sent by writeBufferAsync*/
+	bool _bufferWriteActive = false; /**< An async buffer write is in flight */
+	static constexpr uint8_t _dirtyRectMax = 8; /**< Max damaged regions tracked, more are merged */
+	static constexpr int32_t _dirtyMergeSlack = 64; /**< Clean pixels a merge may add to save an address window */
+	dirty_rect_t _dirtyRects[_dirtyRectMax]; /**< Damaged regions of the screen buffer */
+	uint8_t _dirtyRectCount = 0; /**< Number of damaged regions */
+	uint8_t _dirtyRectLast = 0; /**< Region last grown, checked first by markBufferDirty */
+	void addDirtyRect(dirty_rect_t rect);
+	int32_t dirtyMergeWaste(const dirty_rect_t& a, const dirty_rect_t& b) const;
+	void bufferFillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color);
 #endif
+	static void bufferFillSpan(uint8_t *dst, uint32_t pixels, uint16_t color);
 };
 
 